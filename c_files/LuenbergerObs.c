@@ -0,0 +1,257 @@
+/*  File    : LuenbergerObs.c
+ *  Abstract:
+ *
+ *  Sensorless rotor angle/speed observer for the FOC test-bench
+ *
+ *  parameters: Motor     [Rs Ls]
+ *              Ts        sample time, s
+ *              Bandwidth [wo wpll], back-EMF and angle/speed observer
+ *                        bandwidths, rad/s
+ *  inputs:     Valpha, Vbeta (applied), Ialpha, Ibeta (measured)
+ *  Outputs:    theta (elec rad, feeds MCM_Rev_Park/MCM_Park), omega
+ *              (elec rad/s), Ealpha, Ebeta (estimated back-EMF)
+ *  states: 7, discrete, see luenberger_obs.h
+ *  No direct feed-through: outputs are the one step ahead prediction.
+ *
+ *  The discretized observer gains are computed once in mdlStart, the
+ *  update itself is fixed size and allocation free.
+ */
+
+/* specify S-function name consistent with block name */
+#define S_FUNCTION_NAME  LuenbergerObs
+#define S_FUNCTION_LEVEL 2
+
+#include <stdlib.h>
+#include "simstruc.h"
+#include "matrix.h"
+#include "luenberger_obs.h"
+
+#define Ui0(element) (*uPtrs0[element])    /* Pointer to Input Port0 */
+#define MOTOR_PARAM(S) ssGetSFcnParam(S,0) /* define Motor     */
+#define Ts_PARAM(S)    ssGetSFcnParam(S,1) /* define Ts        */
+#define BW_PARAM(S)    ssGetSFcnParam(S,2) /* define Bandwidth */
+
+#define NUM_CSTATES 0  // continuous states
+#define NUM_DSTATES 7  // discrete states, LuenbergerObs_State_t
+#define NPARAMS 3      // input parameters
+#define TRUE 1
+#define FALSE 0
+
+#define IS_PARAM_DOUBLE(pVal) (mxIsNumeric(pVal) && !mxIsLogical(pVal) &&\
+!mxIsEmpty(pVal) && !mxIsSparse(pVal) && !mxIsComplex(pVal) && mxIsDouble(pVal))
+
+/*====================*
+ * S-function methods *
+ *====================*/
+
+#define MDL_CHECK_PARAMETERS
+#if defined(MDL_CHECK_PARAMETERS) && defined(MATLAB_MEX_FILE)
+
+  /* Function: mdlCheckParameters =============================================
+   * Abstract:
+   *    Validate our parameters to verify they are okay.
+   */
+  static void mdlCheckParameters(SimStruct *S)
+  {
+      /* Check 1st parameter: Motor */
+      {
+          if ( (mxGetNumberOfElements(MOTOR_PARAM(S)) != 2) ||
+               !IS_PARAM_DOUBLE(MOTOR_PARAM(S)) ) {
+              ssSetErrorStatus(S,"1st parameter to S-function, Motor [Rs Ls], "
+                                 "is in error ");
+              return;
+          }
+      }
+      /* Check 2nd parameter: Ts */
+      {
+          if ( (mxGetN(Ts_PARAM(S)) != 1) || !IS_PARAM_DOUBLE(Ts_PARAM(S)) ||
+               mxGetPr(Ts_PARAM(S))[0] <= 0.0 ) {
+              ssSetErrorStatus(S,"2nd parameter to S-function, Ts, is in error ");
+              return;
+          }
+      }
+      /* Check 3rd parameter: Bandwidth */
+      {
+          if ( (mxGetNumberOfElements(BW_PARAM(S)) != 2) ||
+               !IS_PARAM_DOUBLE(BW_PARAM(S)) ) {
+              ssSetErrorStatus(S,"3rd parameter to S-function, Bandwidth "
+                                 "[wo wpll], is in error ");
+              return;
+          }
+      }
+  }
+#endif /* MDL_CHECK_PARAMETERS */
+
+/* Function: mdlInitializeSizes ===========================================
+ * Abstract:  REQUIRED
+ *    The sizes information is used by Simulink to determine the S-function
+ *    block's characteristics (number of inputs, outputs, states, etc.).
+ */
+static void mdlInitializeSizes(SimStruct *S)
+{
+    ssSetNumSFcnParams(S, NPARAMS);  /* Number of expected parameters */
+    if (ssGetNumSFcnParams(S) != ssGetSFcnParamsCount(S)) {
+        /* Return if number of expected != number of actual parameters */
+        return;
+    }
+#if defined(MATLAB_MEX_FILE)
+    mdlCheckParameters(S);
+    if (ssGetErrorStatus(S) != NULL) return;
+#endif
+
+    ssSetNumContStates(S, NUM_CSTATES); // none
+    ssSetNumDiscStates(S, NUM_DSTATES); // observer estimates
+
+    if (!ssSetNumInputPorts(S, 1)) return;
+    ssSetInputPortWidth(S, 0, 4);
+    ssSetInputPortDirectFeedThrough(S, 0, FALSE);
+
+    if (!ssSetNumOutputPorts(S, 1)) return;
+    ssSetOutputPortWidth(S, 0, 4);
+
+    ssSetNumSampleTimes(S, 1);
+    ssSetNumRWork(S, 0);
+    ssSetNumIWork(S, 0);
+    ssSetNumPWork(S, 1);  // LuenbergerObs_Gains_t, built in mdlStart
+    ssSetNumModes(S, 0);
+    ssSetNumNonsampledZCs(S, 0);
+
+    ssSetOperatingPointCompliance(S, USE_DEFAULT_OPERATING_POINT);
+    ssSetOptions(S, SS_OPTION_CALL_TERMINATE_ON_EXIT);
+}
+
+/* Function: mdlInitializeSampleTimes =========================================
+ * Abstract:  REQUIRED
+ *    Observer runs at the control rate Ts.
+ */
+static void mdlInitializeSampleTimes(SimStruct *S)
+{
+    ssSetSampleTime(S, 0, mxGetPr(Ts_PARAM(S))[0]);
+    ssSetOffsetTime(S, 0, 0.0);
+}
+
+#define MDL_INITIALIZE_CONDITIONS   /* Change to #undef to remove function */
+#if defined(MDL_INITIALIZE_CONDITIONS)
+  /* Function: mdlInitializeConditions ========================================
+   * Abstract:
+   *    Zero all estimates.
+   */
+  static void mdlInitializeConditions(SimStruct *S)
+  {
+     real_T *x0 = ssGetRealDiscStates(S);
+     int16_t i;
+     for (i=0; i< NUM_DSTATES; i++)
+     {
+        *x0++=0.0;
+     }
+  }
+#endif /* MDL_INITIALIZE_CONDITIONS */
+
+#define MDL_START  /* Change to #undef to remove function */
+#if defined(MDL_START)
+  /* Function: mdlStart =======================================================
+   * Abstract:
+   *    Discretize and place the observer poles once.
+   */
+  static void mdlStart(SimStruct *S)
+  {
+      const real_T          *motor = mxGetPr(MOTOR_PARAM(S));
+      const real_T          *bw    = mxGetPr(BW_PARAM(S));
+      LuenbergerObs_Gains_t *pGains;
+
+      pGains = (LuenbergerObs_Gains_t *)calloc(1, sizeof(LuenbergerObs_Gains_t));
+      if (pGains == NULL) {
+          ssSetErrorStatus(S,"LuenbergerObs: out of memory");
+          return;
+      }
+      ssGetPWork(S)[0] = pGains;
+
+      if (LUENBERGER_Init_Gains(pGains, motor[0], motor[1],
+                                mxGetPr(Ts_PARAM(S))[0], bw[0], bw[1]) != 0) {
+          ssSetErrorStatus(S,"LuenbergerObs: Ls, wo and wpll must be > 0, "
+                             "Rs >= 0");
+          return;
+      }
+  }
+#endif /*  MDL_START */
+
+/* Function: mdlOutputs =======================================================
+ * Abstract:  REQUIRED
+ *    Outputs are the predicted estimates.
+ */
+static void mdlOutputs(SimStruct *S, int_T tid)
+{
+    real_T       *y = ssGetOutputPortRealSignal(S,0);
+    const real_T *x = ssGetRealDiscStates(S);
+
+    UNUSED_ARG(tid); /* not used in single tasking mode */
+
+    y[0] = x[5];  // theta
+    y[1] = x[6];  // omega
+    y[2] = x[2];  // Ealpha
+    y[3] = x[3];  // Ebeta
+}
+
+#define MDL_UPDATE  /* Change to #undef to remove function */
+#if defined(MDL_UPDATE)
+  /* Function: mdlUpdate ==================================================
+   * Abstract:
+   *    One observer step with the sampled voltage and current.
+   */
+  static void mdlUpdate(SimStruct *S, int_T tid)
+  {
+    real_T                      *x      = ssGetRealDiscStates(S);
+    const LuenbergerObs_Gains_t *pGains = (const LuenbergerObs_Gains_t *)ssGetPWork(S)[0];
+    InputRealPtrsType            uPtrs0 = ssGetInputPortRealSignalPtrs(S,0);
+    LuenbergerObs_State_t        state;
+    alphabeta_t                  Valphabeta;
+    alphabeta_t                  Ialphabeta;
+
+    UNUSED_ARG(tid);
+
+    Valphabeta.alpha = Ui0(0);
+    Valphabeta.beta  = Ui0(1);
+    Ialphabeta.alpha = Ui0(2);
+    Ialphabeta.beta  = Ui0(3);
+
+    state.Ialpha = x[0];
+    state.Ibeta  = x[1];
+    state.Ealpha = x[2];
+    state.Ebeta  = x[3];
+    state.Phase  = x[4];
+    state.Theta  = x[5];
+    state.Omega  = x[6];
+
+    LUENBERGER_Step(pGains, &state, Valphabeta, Ialphabeta);
+
+    x[0] = state.Ialpha;
+    x[1] = state.Ibeta;
+    x[2] = state.Ealpha;
+    x[3] = state.Ebeta;
+    x[4] = state.Phase;
+    x[5] = state.Theta;
+    x[6] = state.Omega;
+  }
+#endif /* MDL_UPDATE */
+
+/* Function: mdlTerminate =================================================
+ * Abstract:  REQUIRED
+ *    Free the gains allocated in mdlStart.
+ */
+static void mdlTerminate(SimStruct *S)
+{
+    if (ssGetPWork(S) != NULL) {
+        free(ssGetPWork(S)[0]);
+        ssGetPWork(S)[0] = NULL;
+    }
+}
+
+/*=============================*
+ * Required S-function trailer *
+ *=============================*/
+
+#ifdef  MATLAB_MEX_FILE    /* Is this file being compiled as a MEX-file? */
+#include "simulink.c"      /* MEX-file interface mechanism */
+#else
+#include "cg_sfun.h"       /* Code generation registration function */
+#endif
@@ -0,0 +1,109 @@
+/*  File    : MCM_Inv_Clarke.c
+ *  Abstract:
+ *
+ *      FOC code inverse Clarke transform
+ *
+ *      Calculate Va, Vb & Vc at a sample rate Ts
+ *      Va =  Valpha
+ *      Vb = (-Valpha + sqrt(3)*Vbeta)/2
+ *      Vc = (-Valpha - sqrt(3)*Vbeta)/2
+ *
+ *      Discrete time, no states, direct feedthrough
+ */
+
+#define S_FUNCTION_NAME MCM_Inv_Clarke
+#define S_FUNCTION_LEVEL 2
+
+#include "simstruc.h"
+#include "mc_math.h"
+
+#define U(element) (*uPtrs[element])  /* Pointer to Input Port0 */
+#define TRUE 1
+
+/*====================*
+ * S-function methods *
+ *====================*/
+
+/* Function: mdlInitializeSizes ===============================================
+ * Abstract:
+ *    The sizes information is used by Simulink to determine the S-function
+ *    block's characteristics (number of inputs, outputs, states, etc.).
+ */
+static void mdlInitializeSizes(SimStruct *S)
+{
+    ssSetNumSFcnParams(S, 0);  /* Number of expected parameters = 0 */
+    if (ssGetNumSFcnParams(S) != ssGetSFcnParamsCount(S)) {
+        return; /* Parameter mismatch will be reported by Simulink */
+    }
+
+    ssSetNumContStates(S, 0);  // no states
+    ssSetNumDiscStates(S, 0);  // no states
+
+    if (!ssSetNumInputPorts(S, 1)) return;
+    ssSetInputPortWidth(S, 0, 2);
+    ssSetInputPortDirectFeedThrough(S, 0, TRUE);
+
+    if (!ssSetNumOutputPorts(S, 1)) return;
+    ssSetOutputPortWidth(S, 0, 3);
+
+    ssSetNumSampleTimes(S, 1);
+    ssSetNumRWork(S, 0);
+    ssSetNumIWork(S, 0);
+    ssSetNumPWork(S, 0);
+    ssSetNumModes(S, 0);
+    ssSetNumNonsampledZCs(S, 0);
+    ssSetOperatingPointCompliance(S, USE_DEFAULT_OPERATING_POINT);
+
+    ssSetOptions(S, SS_OPTION_EXCEPTION_FREE_CODE);
+}
+
+/* Function: mdlInitializeSampleTimes =========================================
+ * Abstract:
+ *    Specify the sample time as Ts (inherited)
+ */
+static void mdlInitializeSampleTimes(SimStruct *S)
+{
+    ssSetSampleTime(S, 0, INHERITED_SAMPLE_TIME);
+    ssSetOffsetTime(S, 0, 0.0);
+    ssSetModelReferenceSampleTimeDefaultInheritance(S);
+}
+
+/* Function: mdlOutputs =======================================================
+ * Abstract:
+ *      y = f(u)
+ */
+static void mdlOutputs(SimStruct *S, int_T tid)
+{
+    real_T            *y    = ssGetOutputPortRealSignal(S,0);
+    InputRealPtrsType uPtrs = ssGetInputPortRealSignalPtrs(S,0);
+
+    UNUSED_ARG(tid); /* not used in single tasking mode */
+
+    alphabeta_t Valphabeta;
+    abc_t       Vabc;
+
+    Valphabeta.alpha = U(0);
+    Valphabeta.beta  = U(1);
+
+    /* inverse Clarke transform */
+    Vabc = MCM_Inv_Clarke_Transform( Valphabeta );
+
+    y[0]= Vabc.a; /* Va */
+    y[1]= Vabc.b; /* Vb */
+    y[2]= Vabc.c; /* Vc */
+}
+
+/* Function: mdlTerminate =====================================================
+ * Abstract:
+ *    No termination needed, but we are required to have this routine.
+ */
+static void mdlTerminate(SimStruct *S)
+{
+    UNUSED_ARG(S); /* unused input argument */
+}
+
+#ifdef  MATLAB_MEX_FILE    /* Is this file being compiled as a MEX-file? */
+#include "simulink.c"      /* MEX-file interface mechanism */
+#else
+#include "cg_sfun.h"       /* Code generation registration function */
+#endif
@@ -0,0 +1,168 @@
+/*  File    : MCM_Park.c
+ *  Abstract:
+ *
+ *      FOC code Park transform
+ *
+ *      Calculate Iqs & Ids at a sample rate Ts
+ *      Iqs = Ialpha*cos(theta) - Ibeta*sin(theta)
+ *      Ids = Ialpha*sin(theta) + Ibeta*cos(theta)
+ *
+ *      input width 3: (Ialpha, Ibeta, theta)      Park only
+ *      input width 4: (Ia, Ib, Ic, theta)         fused Clarke + Park,
+ *                                                 sin/cos evaluated once
+ *
+ *      Discrete time, no states, direct feedthrough
+ */
+
+#define S_FUNCTION_NAME MCM_Park
+#define S_FUNCTION_LEVEL 2
+
+#include "simstruc.h"
+#include "mc_math.h"
+
+#define U(element) (*uPtrs[element])  /* Pointer to Input Port0 */
+#define TRUE 1
+
+#define PARK_WIDTH        3  /* alpha, beta, theta  */
+#define CLARKE_PARK_WIDTH 4  /* a, b, c, theta      */
+
+/*====================*
+ * S-function methods *
+ *====================*/
+
+/* Function: mdlInitializeSizes ===============================================
+ * Abstract:
+ *    The sizes information is used by Simulink to determine the S-function
+ *    block's characteristics (number of inputs, outputs, states, etc.).
+ */
+static void mdlInitializeSizes(SimStruct *S)
+{
+    ssSetNumSFcnParams(S, 0);  /* Number of expected parameters = 0 */
+    if (ssGetNumSFcnParams(S) != ssGetSFcnParamsCount(S)) {
+        return; /* Parameter mismatch will be reported by Simulink */
+    }
+
+    ssSetNumContStates(S, 0);  // no states
+    ssSetNumDiscStates(S, 0);  // no states
+
+    if (!ssSetNumInputPorts(S, 1)) return;
+    ssSetInputPortWidth(S, 0, DYNAMICALLY_SIZED); // 3 or 4
+    ssSetInputPortDirectFeedThrough(S, 0, TRUE);
+
+    if (!ssSetNumOutputPorts(S, 1)) return;
+    ssSetOutputPortWidth(S, 0, 2);
+
+    ssSetNumSampleTimes(S, 1);
+    ssSetNumRWork(S, 0);
+    ssSetNumIWork(S, 0);
+    ssSetNumPWork(S, 0);
+    ssSetNumModes(S, 0);
+    ssSetNumNonsampledZCs(S, 0);
+    ssSetOperatingPointCompliance(S, USE_DEFAULT_OPERATING_POINT);
+
+    ssSetOptions(S, SS_OPTION_EXCEPTION_FREE_CODE);
+}
+
+#if defined(MATLAB_MEX_FILE)
+#define MDL_SET_INPUT_PORT_WIDTH
+/* Function: mdlSetInputPortWidth =============================================
+ * Abstract:
+ *    Accept (alpha, beta, theta) or (a, b, c, theta)
+ */
+static void mdlSetInputPortWidth(SimStruct *S, int_T port, int_T width)
+{
+    if (width != PARK_WIDTH && width != CLARKE_PARK_WIDTH) {
+        ssSetErrorStatus(S,"input to MCM_Park must be (alpha,beta,theta) "
+                           "or (a,b,c,theta)");
+        return;
+    }
+    ssSetInputPortWidth(S, port, width);
+}
+
+#define MDL_SET_OUTPUT_PORT_WIDTH
+/* Function: mdlSetOutputPortWidth ============================================
+ * Abstract:
+ *    Output is always (q, d)
+ */
+static void mdlSetOutputPortWidth(SimStruct *S, int_T port, int_T width)
+{
+    if (width != 2) {
+        ssSetErrorStatus(S,"output of MCM_Park is (q,d)");
+        return;
+    }
+    ssSetOutputPortWidth(S, port, width);
+}
+
+#define MDL_SET_DEFAULT_PORT_DIMENSION_INFO
+/* Function: mdlSetDefaultPortDimensionInfo ===================================
+ * Abstract:
+ *    Unconnected input defaults to the Park only form
+ */
+static void mdlSetDefaultPortDimensionInfo(SimStruct *S)
+{
+    ssSetInputPortWidth(S, 0, PARK_WIDTH);
+}
+#endif /* MATLAB_MEX_FILE */
+
+/* Function: mdlInitializeSampleTimes =========================================
+ * Abstract:
+ *    Specify the sample time as Ts (inherited)
+ */
+static void mdlInitializeSampleTimes(SimStruct *S)
+{
+    ssSetSampleTime(S, 0, INHERITED_SAMPLE_TIME);
+    ssSetOffsetTime(S, 0, 0.0);
+    ssSetModelReferenceSampleTimeDefaultInheritance(S);
+}
+
+/* Function: mdlOutputs =======================================================
+ * Abstract:
+ *      y = f(u)
+ */
+static void mdlOutputs(SimStruct *S, int_T tid)
+{
+    real_T            *y    = ssGetOutputPortRealSignal(S,0);
+    InputRealPtrsType uPtrs = ssGetInputPortRealSignalPtrs(S,0);
+
+    UNUSED_ARG(tid); /* not used in single tasking mode */
+
+    qd_real_t Iqd;
+
+    if (ssGetInputPortWidth(S, 0) == CLARKE_PARK_WIDTH) {
+        abc_t Iabc;
+
+        Iabc.a = U(0);
+        Iabc.b = U(1);
+        Iabc.c = U(2);
+
+        /* fused Clarke + Park transform */
+        Iqd = MCM_Clarke_Park_Transform( Iabc, U(3) );
+    }
+    else {
+        alphabeta_t Ialphabeta;
+
+        Ialphabeta.alpha = U(0);
+        Ialphabeta.beta  = U(1);
+
+        /* Park transform */
+        Iqd = MCM_Park_Transform( Ialphabeta, MCM_Trig_Functions( U(2) ) );
+    }
+
+    y[0]= Iqd.q; /* Iqs */
+    y[1]= Iqd.d; /* Ids */
+}
+
+/* Function: mdlTerminate =====================================================
+ * Abstract:
+ *    No termination needed, but we are required to have this routine.
+ */
+static void mdlTerminate(SimStruct *S)
+{
+    UNUSED_ARG(S); /* unused input argument */
+}
+
+#ifdef  MATLAB_MEX_FILE    /* Is this file being compiled as a MEX-file? */
+#include "simulink.c"      /* MEX-file interface mechanism */
+#else
+#include "cg_sfun.h"       /* Code generation registration function */
+#endif
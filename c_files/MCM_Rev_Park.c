@@ -11,6 +11,12 @@
  *
  *      Discrete time, no states, direct feedthrough 
  *
+ *      Counts the Circle_Limitation calls, the limited ones and the table
+ *      elements used (pwm_stats.h), printed at the end of the simulation.
+ *      Built with -DSFUN_PROFILE (sfun_prof.h) mdlOutputs times the
+ *      limitation, trig and transform stages, printed at the end of the
+ *      simulation.
+ *
  *   Brian Tremaine Nov 16, 2020
  */
 
@@ -19,10 +25,31 @@
 
 #include "simstruc.h"
 #include <math.h>
+#include <stdlib.h>
 #include "circle_limitation.h"
+#include "mc_math.h"
+#include "sfun_prof.h"
+#include "pwm_stats.h"
 
 #define U(element) (*uPtrs[element])  /* Pointer to Input Port0 */
 #define TRUE 1
+
+/* PWork 0 SFun_Prof_t, SFUN_PROFILE builds only; PWork 1 PWM_Stats_t */
+#define PW_PROF  0
+#define PW_STATS 1
+
+/* mdlOutputs profile stages */
+#define PROF_LIMIT     0
+#define PROF_TRIG      1
+#define PROF_TRANSFORM 2
+#define PROF_STAGES    3
+
+#if defined(SFUN_PROFILE)
+static const char * const revParkProfStages[PROF_STAGES] =
+{
+    "limitation", "trig", "transform"
+};
+#endif
  
 /*====================*
  * S-function methods *
@@ -53,12 +80,13 @@ static void mdlInitializeSizes(SimStruct *S)
     ssSetNumSampleTimes(S, 1);
     ssSetNumRWork(S, 0);
     ssSetNumIWork(S, 0);
-    ssSetNumPWork(S, 0);
+    ssSetNumPWork(S, 2);  // SFun_Prof_t, PWM_Stats_t
     ssSetNumModes(S, 0);
     ssSetNumNonsampledZCs(S, 0);
     ssSetOperatingPointCompliance(S, USE_DEFAULT_OPERATING_POINT);
 
-    ssSetOptions(S, SS_OPTION_EXCEPTION_FREE_CODE);
+    ssSetOptions(S, SS_OPTION_EXCEPTION_FREE_CODE |
+                    SS_OPTION_CALL_TERMINATE_ON_EXIT);
 }
 
 /* Function: mdlInitializeSampleTimes =========================================
@@ -81,6 +109,34 @@ static void mdlInitializeSampleTimes(SimStruct *S)
 //{
 //}
 
+#define MDL_START
+/* Function: mdlStart =======================================================
+ * Abstract:
+ *    Allocate the run-time counters, and the stage profile in
+ *    SFUN_PROFILE builds.
+ */
+static void mdlStart(SimStruct *S)
+{
+    PWM_Stats_t *pStats = (PWM_Stats_t *)malloc(sizeof(PWM_Stats_t));
+
+    ssGetPWork(S)[PW_PROF]  = NULL;
+    ssGetPWork(S)[PW_STATS] = pStats;
+    if (pStats == NULL) {
+        ssSetErrorStatus(S,"MCM_Rev_Park: out of memory");
+        return;
+    }
+    PWM_Stats_Reset(pStats);
+#if defined(SFUN_PROFILE)
+    ssGetPWork(S)[PW_PROF] = malloc(sizeof(SFun_Prof_t));
+    if (ssGetPWork(S)[PW_PROF] == NULL) {
+        ssSetErrorStatus(S,"MCM_Rev_Park: out of memory");
+        return;
+    }
+    SFun_Prof_Init((SFun_Prof_t *)ssGetPWork(S)[PW_PROF],
+                   revParkProfStages, PROF_STAGES);
+#endif
+}
+
 
 /* Function: mdlOutputs =======================================================
  * Abstract:
@@ -105,18 +161,32 @@ static void mdlOutputs(SimStruct *S, int_T tid)
     #define S16_MAX 32767
     
     qd_t Vqd;
+    qd_real_t   Vqd_real;
+    alphabeta_t Valphabeta;
+    Trig_Components trig;
+    int32_t     index;
 
+    SFUN_PROF_START(ssGetPWork(S)[PW_PROF]);
     Vqd.q= Vqs;
     Vqd.d= Vds;
 
     /* apply Circle_Limitation on Vqs,Vds
        includes modulation index
     */
-    Vqd = Circle_Limitation( &CircleLimitationM1, Vqd );
+    Vqd = Circle_Limitation_Indexed( &CircleLimitationM1, Vqd, &index );
+    PWM_Stats_Limit((PWM_Stats_t *)ssGetPWork(S)[PW_STATS], index);
+    SFUN_PROF_STAGE(ssGetPWork(S)[PW_PROF], PROF_LIMIT);
     
-    /* Reverse Park transform */
-    y[0]=  Vqd.q*cos(theta) + Vqd.d*sin(theta); /* Valpha */ 
-    y[1]= -Vqd.q*sin(theta) + Vqd.d*cos(theta); /* Vbeta */
+    /* Reverse Park transform, sin/cos from the shared provider */
+    trig = MCM_Trig_Functions(theta);
+    SFUN_PROF_STAGE(ssGetPWork(S)[PW_PROF], PROF_TRIG);
+    Vqd_real.q = Vqd.q;
+    Vqd_real.d = Vqd.d;
+    Valphabeta = MCM_Rev_Park_Transform( Vqd_real, trig );
+    SFUN_PROF_STAGE(ssGetPWork(S)[PW_PROF], PROF_TRANSFORM);
+
+    y[0]= Valphabeta.alpha; /* Valpha */
+    y[1]= Valphabeta.beta;  /* Vbeta */
 }
 
 
@@ -133,11 +203,28 @@ static void mdlOutputs(SimStruct *S, int_T tid)
 
 /* Function: mdlTerminate =====================================================
  * Abstract:
- *    No termination needed, but we are required to have this routine.
+ *    Print and free the run-time counters and, in SFUN_PROFILE builds,
+ *    the stage profile.
  */
 static void mdlTerminate(SimStruct *S)
 {
-    UNUSED_ARG(S); /* unused input argument */
+    if (ssGetPWork(S) == NULL) {
+        return;
+    }
+    if (ssGetPWork(S)[PW_STATS] != NULL) {
+        PWM_Stats_Dump((const PWM_Stats_t *)ssGetPWork(S)[PW_STATS],
+                       ssGetPath(S), ssPrintf);
+        free(ssGetPWork(S)[PW_STATS]);
+        ssGetPWork(S)[PW_STATS] = NULL;
+    }
+#if defined(SFUN_PROFILE)
+    if (ssGetPWork(S)[PW_PROF] != NULL) {
+        SFun_Prof_Dump((const SFun_Prof_t *)ssGetPWork(S)[PW_PROF],
+                       ssGetPath(S), ssPrintf);
+        free(ssGetPWork(S)[PW_PROF]);
+        ssGetPWork(S)[PW_PROF] = NULL;
+    }
+#endif
 }
 
 #ifdef  MATLAB_MEX_FILE    /* Is this file being compiled as a MEX-file? */
@@ -0,0 +1,317 @@
+/*  File    : bldc_mtr.c
+ *  Abstract:
+ *
+ *  PMSM/BLDC motor plant for the FOC test-bench
+ *
+ *  parameters: Motor  [Rs Ld Lq PsiM Pp J B]
+ *              Cog    [Kcog Ncog] or [] (no cogging)
+ *              Ts     plant step, s
+ *              Solver [Nsub Method], Nsub steps per Ts, an integer
+ *                     1..1e9, Method 0 = RK4, 1 = semi-implicit
+ *  inputs:     port 0: U, V, W phase voltages, averaged or switched
+ *                      (0/Vbus from svpwm, common mode is rejected)
+ *              port 1: load torque, Nm
+ *  Outputs:    ia, ib, ic, id, iq, we (elec rad/s), theta_e, Te
+ *  states: 4, discrete (id, iq, wm, thm), integrated in mdlUpdate with
+ *          a fixed step so the plant does not drag the Simulink solver
+ *          down to the motor electrical time constant.
+ *  No direct feed-through, so it closes the loop with svpwm without an
+ *  algebraic loop.
+ *
+ *  dq frame and equations: see pmsm_model.h
+ */
+
+/* specify S-function name consistent with block name */
+#define S_FUNCTION_NAME  bldc_mtr
+#define S_FUNCTION_LEVEL 2
+
+#include <math.h>
+#include <stdlib.h>
+#include "simstruc.h"
+#include "matrix.h"
+#include "pmsm_model.h"
+
+#define Ui0(element) (*uPtrs0[element])      /* Pointer to Input Port0 */
+#define Ui1(element) (*uPtrs1[element])      /* Pointer to Input Port1 */
+#define MOTOR_PARAM(S)  ssGetSFcnParam(S,0)  /* define Motor  */
+#define COG_PARAM(S)    ssGetSFcnParam(S,1)  /* define Cog    */
+#define Ts_PARAM(S)     ssGetSFcnParam(S,2)  /* define Ts     */
+#define SOLVER_PARAM(S) ssGetSFcnParam(S,3)  /* define Solver */
+
+#define NUM_CSTATES 0  // continuous states
+#define NUM_DSTATES 4  // discrete states id, iq, wm, thm
+#define NPARAMS 4      // input parameters
+#define NUM_OUTPUTS 8
+#define TRUE 1
+#define FALSE 0
+
+#define IS_PARAM_DOUBLE(pVal) (mxIsNumeric(pVal) && !mxIsLogical(pVal) &&\
+!mxIsEmpty(pVal) && !mxIsSparse(pVal) && !mxIsComplex(pVal) && mxIsDouble(pVal))
+
+#define OK_EMPTY_DOUBLE_PARAM(pVal) (mxIsNumeric(pVal) && !mxIsLogical(pVal) &&\
+!mxIsSparse(pVal) && !mxIsComplex(pVal) && mxIsDouble(pVal))
+
+/*====================*
+ * S-function methods *
+ *====================*/
+
+#define MDL_CHECK_PARAMETERS
+#if defined(MDL_CHECK_PARAMETERS) && defined(MATLAB_MEX_FILE)
+
+  /* Function: mdlCheckParameters =============================================
+   * Abstract:
+   *    Validate our parameters to verify they are okay.
+   */
+  static void mdlCheckParameters(SimStruct *S)
+  {
+      /* Check 1st parameter: Motor */
+      {
+          if ( (mxGetNumberOfElements(MOTOR_PARAM(S)) != 7) ||
+               !IS_PARAM_DOUBLE(MOTOR_PARAM(S)) ) {
+              ssSetErrorStatus(S,"1st parameter to S-function, Motor "
+                                 "[Rs Ld Lq PsiM Pp J B], is in error ");
+              return;
+          }
+      }
+      /* Check 2nd parameter: Cog */
+      {
+          if ( !OK_EMPTY_DOUBLE_PARAM(COG_PARAM(S)) ||
+               (!mxIsEmpty(COG_PARAM(S)) &&
+                mxGetNumberOfElements(COG_PARAM(S)) != 2) ) {
+              ssSetErrorStatus(S,"2nd parameter to S-function, Cog "
+                                 "[Kcog Ncog] or [], is in error ");
+              return;
+          }
+      }
+      /* Check 3rd parameter: Ts */
+      {
+          if ( (mxGetN(Ts_PARAM(S)) != 1) || !IS_PARAM_DOUBLE(Ts_PARAM(S)) ||
+               mxGetPr(Ts_PARAM(S))[0] <= 0.0 ) {
+              ssSetErrorStatus(S,"3rd parameter to S-function, Ts, is in error ");
+              return;
+          }
+      }
+      /* Check 4th parameter: Solver, Nsub an integer >= 1, Method 0 or 1 */
+      {
+          if ( (mxGetNumberOfElements(SOLVER_PARAM(S)) != 2) ||
+               !IS_PARAM_DOUBLE(SOLVER_PARAM(S)) ||
+               !(mxGetPr(SOLVER_PARAM(S))[0] >= 1.0 &&
+                 mxGetPr(SOLVER_PARAM(S))[0] <= 1e9) ||
+               mxGetPr(SOLVER_PARAM(S))[0] != floor(mxGetPr(SOLVER_PARAM(S))[0]) ||
+               ( mxGetPr(SOLVER_PARAM(S))[1] != 0.0 &&
+                 mxGetPr(SOLVER_PARAM(S))[1] != 1.0 ) ) {
+              ssSetErrorStatus(S,"4th parameter to S-function, Solver "
+                                 "[Nsub Method], is in error ");
+              return;
+          }
+      }
+  }
+#endif /* MDL_CHECK_PARAMETERS */
+
+/* Function: mdlInitializeSizes ===========================================
+ * Abstract:  REQUIRED
+ *    The sizes information is used by Simulink to determine the S-function
+ *    block's characteristics (number of inputs, outputs, states, etc.).
+ */
+static void mdlInitializeSizes(SimStruct *S)
+{
+    ssSetNumSFcnParams(S, NPARAMS);  /* Number of expected parameters */
+    if (ssGetNumSFcnParams(S) != ssGetSFcnParamsCount(S)) {
+        /* Return if number of expected != number of actual parameters */
+        return;
+    }
+#if defined(MATLAB_MEX_FILE)
+    mdlCheckParameters(S);
+    if (ssGetErrorStatus(S) != NULL) return;
+#endif
+
+    ssSetNumContStates(S, NUM_CSTATES); // none
+    ssSetNumDiscStates(S, NUM_DSTATES); // id, iq, wm, thm
+
+    if (!ssSetNumInputPorts(S, 2)) return;
+    ssSetInputPortWidth(S, 0, 3);
+    ssSetInputPortWidth(S, 1, 1);
+    ssSetInputPortDirectFeedThrough(S, 0, FALSE);
+    ssSetInputPortDirectFeedThrough(S, 1, FALSE);
+
+    if (!ssSetNumOutputPorts(S, 1)) return;
+    ssSetOutputPortWidth(S, 0, NUM_OUTPUTS);
+
+    ssSetNumSampleTimes(S, 1);
+    ssSetNumRWork(S, 0);
+    ssSetNumIWork(S, 0);
+    ssSetNumPWork(S, 1);  // PMSM_Handle_t, built in mdlStart
+    ssSetNumModes(S, 0);
+    ssSetNumNonsampledZCs(S, 0);
+
+    ssSetOperatingPointCompliance(S, USE_DEFAULT_OPERATING_POINT);
+    ssSetOptions(S, SS_OPTION_CALL_TERMINATE_ON_EXIT);
+}
+
+/* Function: mdlInitializeSampleTimes =========================================
+ * Abstract:  REQUIRED
+ *    Plant runs at its own fixed step Ts.
+ */
+static void mdlInitializeSampleTimes(SimStruct *S)
+{
+    ssSetSampleTime(S, 0, mxGetPr(Ts_PARAM(S))[0]);
+    ssSetOffsetTime(S, 0, 0.0);
+}
+
+#define MDL_INITIALIZE_CONDITIONS   /* Change to #undef to remove function */
+#if defined(MDL_INITIALIZE_CONDITIONS)
+  /* Function: mdlInitializeConditions ========================================
+   * Abstract:
+   *    Motor at standstill, no current.
+   */
+  static void mdlInitializeConditions(SimStruct *S)
+  {
+     real_T *x0 = ssGetRealDiscStates(S);
+     int16_t i;
+     for (i=0; i< NUM_DSTATES; i++)
+     {
+        *x0++=0.0;
+     }
+  }
+#endif /* MDL_INITIALIZE_CONDITIONS */
+
+#define MDL_START  /* Change to #undef to remove function */
+#if defined(MDL_START)
+  /* Function: mdlStart =======================================================
+   * Abstract:
+   *    Build the model instance once; the integrator constants are
+   *    precomputed so mdlUpdate does no parameter handling.
+   */
+  static void mdlStart(SimStruct *S)
+  {
+      const real_T  *motor  = mxGetPr(MOTOR_PARAM(S));
+      const real_T  *solver = mxGetPr(SOLVER_PARAM(S));
+      PMSM_Handle_t *pHandle;
+      PMSM_Params_t  params;
+
+      params.Rs   = motor[0];
+      params.Ld   = motor[1];
+      params.Lq   = motor[2];
+      params.PsiM = motor[3];
+      params.Pp   = motor[4];
+      params.J    = motor[5];
+      params.B    = motor[6];
+      params.Kcog = 0.0;
+      params.Ncog = 0.0;
+      if (!mxIsEmpty(COG_PARAM(S))) {
+          params.Kcog = mxGetPr(COG_PARAM(S))[0];
+          params.Ncog = mxGetPr(COG_PARAM(S))[1];
+      }
+
+      pHandle = (PMSM_Handle_t *)calloc(1, sizeof(PMSM_Handle_t));
+      if (pHandle == NULL) {
+          ssSetErrorStatus(S,"bldc_mtr: out of memory");
+          return;
+      }
+      ssGetPWork(S)[0] = pHandle;
+
+      if (PMSM_Init(pHandle, &params,
+                    (solver[1] == 1.0) ? PMSM_SEMI_IMPLICIT : PMSM_RK4) != 0) {
+          ssSetErrorStatus(S,"bldc_mtr: Ld, Lq, J and Pp must be > 0, "
+                             "Rs and B >= 0");
+          return;
+      }
+  }
+#endif /*  MDL_START */
+
+/* Function: mdlOutputs =======================================================
+ * Abstract:  REQUIRED
+ *    Outputs are functions of the states only.
+ */
+static void mdlOutputs(SimStruct *S, int_T tid)
+{
+    real_T              *y       = ssGetOutputPortRealSignal(S,0);
+    const real_T        *x       = ssGetRealDiscStates(S);
+    const PMSM_Handle_t *pHandle = (const PMSM_Handle_t *)ssGetPWork(S)[0];
+    PMSM_State_t         state;
+    abc_t                Iabc;
+
+    UNUSED_ARG(tid); /* not used in single tasking mode */
+
+    state.id  = x[0];
+    state.iq  = x[1];
+    state.wm  = x[2];
+    state.thm = x[3];
+
+    Iabc = PMSM_Phase_Currents(pHandle, &state);
+
+    y[0] = Iabc.a;
+    y[1] = Iabc.b;
+    y[2] = Iabc.c;
+    y[3] = state.id;
+    y[4] = state.iq;
+    y[5] = pHandle->Params.Pp * state.wm;       // we
+    y[6] = PMSM_Elec_Angle(pHandle, &state);    // theta_e
+    y[7] = PMSM_Torque(pHandle, &state);        // Te
+}
+
+#define MDL_UPDATE  /* Change to #undef to remove function */
+#if defined(MDL_UPDATE)
+  /* Function: mdlUpdate ==================================================
+   * Abstract:
+   *    Integrate the plant over one Ts with Nsub fixed steps, phase
+   *    voltages held over the sample.
+   */
+  static void mdlUpdate(SimStruct *S, int_T tid)
+  {
+    real_T              *x       = ssGetRealDiscStates(S);
+    const PMSM_Handle_t *pHandle = (const PMSM_Handle_t *)ssGetPWork(S)[0];
+    InputRealPtrsType    uPtrs0  = ssGetInputPortRealSignalPtrs(S,0);
+    InputRealPtrsType    uPtrs1  = ssGetInputPortRealSignalPtrs(S,1);
+    const real_T         Ts      = mxGetPr(Ts_PARAM(S))[0];
+    const int_T          Nsub    = (int_T)mxGetPr(SOLVER_PARAM(S))[0];
+    const real_T         h       = Ts / Nsub;
+    PMSM_State_t         state;
+    abc_t                Vabc;
+    alphabeta_t          Valphabeta;
+    int_T                i;
+
+    UNUSED_ARG(tid);
+
+    Vabc.a = Ui0(0);
+    Vabc.b = Ui0(1);
+    Vabc.c = Ui0(2);
+    Valphabeta = MCM_Clarke_Transform(Vabc);
+
+    state.id  = x[0];
+    state.iq  = x[1];
+    state.wm  = x[2];
+    state.thm = x[3];
+
+    for (i = 0; i < Nsub; i++) {
+        PMSM_Step(pHandle, &state, Valphabeta, Ui1(0), h);
+    }
+
+    x[0] = state.id;
+    x[1] = state.iq;
+    x[2] = state.wm;
+    x[3] = state.thm;
+  }
+#endif /* MDL_UPDATE */
+
+/* Function: mdlTerminate =================================================
+ * Abstract:  REQUIRED
+ *    Free the model instance allocated in mdlStart.
+ */
+static void mdlTerminate(SimStruct *S)
+{
+    if (ssGetPWork(S) != NULL) {
+        free(ssGetPWork(S)[0]);
+        ssGetPWork(S)[0] = NULL;
+    }
+}
+
+/*=============================*
+ * Required S-function trailer *
+ *=============================*/
+
+#ifdef  MATLAB_MEX_FILE    /* Is this file being compiled as a MEX-file? */
+#include "simulink.c"      /* MEX-file interface mechanism */
+#else
+#include "cg_sfun.h"       /* Code generation registration function */
+#endif
@@ -83,6 +83,20 @@ __weak qd_t Circle_Limitation(CircleLimitation_Handle_t * pHandle, qd_t Vqd)
   }
   return(Local_Vqd);
 }
+
+/**
+  * @brief  Circle_Limitation() reporting whether it limited, for run-time
+  *         counters; this form has no table
+  * @param  pIndex 0 when Vqd was limited, -1 when not
+  */
+qd_t Circle_Limitation_Indexed( CircleLimitation_Handle_t * pHandle, qd_t Vqd,
+                                int32_t * pIndex )
+{
+  qd_t local_vqd = Circle_Limitation( pHandle, Vqd );
+
+  *pIndex = ( local_vqd.q != Vqd.q || local_vqd.d != Vqd.d ) ? 0 : -1;
+  return ( local_vqd );
+}
 #else
 /**
   * @brief Check whether Vqd.q^2 + Vqd.d^2 <= 32767^2
@@ -93,6 +107,23 @@ __weak qd_t Circle_Limitation(CircleLimitation_Handle_t * pHandle, qd_t Vqd)
   * @retval qd_t Limited Vqd vector
   */
 qd_t Circle_Limitation( CircleLimitation_Handle_t * pHandle, qd_t Vqd )
+{
+  int32_t index;
+
+  return ( Circle_Limitation_Indexed( pHandle, Vqd, &index ) );
+}
+
+/**
+  * @brief  Circle_Limitation() also reporting the table element it scaled
+  *         Vqd with, for run-time counters at no extra cost
+  * @param  pHandle pointer on the related component instance
+  * @param  Vqd Voltage in qd reference frame
+  * @param  pIndex table index, -1 when Vqd is inside the circle (not
+  *         limited)
+  * @retval qd_t Limited Vqd vector
+  */
+qd_t Circle_Limitation_Indexed( CircleLimitation_Handle_t * pHandle, qd_t Vqd,
+                                int32_t * pIndex )
 {
   uint16_t table_element;
   uint32_t uw_temp;
@@ -103,6 +134,7 @@ qd_t Circle_Limitation( CircleLimitation_Handle_t * pHandle, qd_t Vqd )
             ( int32_t )( Vqd.d ) * Vqd.d;
 
   uw_temp = ( uint32_t ) sw_temp;
+  *pIndex = -1;
 
   /* uw_temp min value 0, max value 32767*32767 */
   if ( uw_temp > ( uint32_t )( pHandle->MaxModule ) * pHandle->MaxModule )
@@ -114,6 +146,7 @@ qd_t Circle_Limitation( CircleLimitation_Handle_t * pHandle, qd_t Vqd )
     uw_temp -= pHandle->Start_index;
 
     /* uw_temp min value 0, max value 127 - pHandle->Start_index */
+    *pIndex = ( uint8_t )uw_temp;
     table_element = pHandle->Circle_limit_table[( uint8_t )uw_temp];
 
     sw_temp = Vqd.q * ( int32_t )table_element;
@@ -16,6 +16,10 @@
 #ifndef __CIRCLELIMITATION_H
 #define __CIRCLELIMITATION_H
 
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
 /* Includes ------------------------------------------------------------------*/
 #include <stdint.h>
 
@@ -48,11 +52,13 @@ typedef struct
                                          start */
 } CircleLimitation_Handle_t;
 
-CircleLimitation_Handle_t CircleLimitationM1;
+extern CircleLimitation_Handle_t CircleLimitationM1;
 
 /* Exported functions ------------------------------------------------------- */
 
 qd_t Circle_Limitation( CircleLimitation_Handle_t * pHandle, qd_t Vqd );
+qd_t Circle_Limitation_Indexed( CircleLimitation_Handle_t * pHandle, qd_t Vqd,
+                                int32_t * pIndex );
 
 #ifdef __cplusplus
 }
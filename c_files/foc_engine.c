@@ -0,0 +1,365 @@
+/**
+  ******************************************************************************
+  * @file    foc_engine.c
+  * @brief   This file provides the standalone closed-loop FOC current loop:
+  *          the same Circle_Limitation, reverse Park and SVPWM code as the
+  *          S-functions, closed around the pmsm_model plant
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * license info:
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <string.h>
+#include "foc_engine.h"
+
+#define S16_MAX 32767
+
+static int16_t FOC_Sat_S16( double x )
+{
+  if ( x > S16_MAX )
+  {
+    return ( S16_MAX );
+  }
+  if ( x < -S16_MAX )
+  {
+    return ( -S16_MAX );
+  }
+  return ( ( int16_t )x );
+}
+
+/* stator voltage at carrier position tau of the period */
+static alphabeta_t FOC_Levels_Voltage( const SVPWM_Timing_t * pTiming,
+                                       double Vbus, double tau )
+{
+  const double Ts = pTiming->Ts;
+  double UVW[3];
+  abc_t  Vabc;
+
+  SVPWM_Phase_Levels( pTiming, Ts - fabs( Ts - 2.0 * tau ), Vbus, UVW );
+  Vabc.a = UVW[0];
+  Vabc.b = UVW[1];
+  Vabc.c = UVW[2];
+
+  return ( MCM_Clarke_Transform( Vabc ) );
+}
+
+/* integrate over len seconds with steps no longer than hmax */
+static void FOC_Plant_Segment( FOC_Engine_t * pEngine, alphabeta_t Valphabeta,
+                               double Tload, double len, double hmax )
+{
+  uint32_t n;
+  uint32_t i;
+  double   h;
+
+  if ( len <= 0.0 )
+  {
+    return;
+  }
+  n = ( uint32_t )( len / hmax );
+  if ( n * hmax < len )
+  {
+    n++;
+  }
+  h = len / n;
+  for ( i = 0; i < n; i++ )
+  {
+    PMSM_Step( &pEngine->Motor, &pEngine->MotorState, Valphabeta, Tload, h );
+  }
+}
+
+/*
+ * Exact switching edges: the phase voltages are constant between the (at
+ * most six) edges of the period, SVPWM_Edges(), so each interval is one
+ * segment with the levels at its middle.
+ */
+static void FOC_Plant_Edges( FOC_Engine_t * pEngine,
+                             const SVPWM_Timing_t * pTiming, double Tload )
+{
+  const double Ts   = pEngine->Tk;
+  const double hmax = Ts / pEngine->Cfg.Nsub;
+  double edges[7];
+  double t0 = 0.0;
+  int    n;
+  int    k;
+
+  n = SVPWM_Edges( pTiming, edges );
+  edges[n++] = Ts;
+  for ( k = 0; k < n; k++ )
+  {
+    if ( edges[k] > t0 )
+    {
+      FOC_Plant_Segment( pEngine,
+                         FOC_Levels_Voltage( pTiming, pEngine->Cfg.Vbus,
+                                             0.5 * ( t0 + edges[k] ) ),
+                         Tload, edges[k] - t0, hmax );
+      t0 = edges[k];
+    }
+  }
+}
+
+/* Nsub equal steps, voltage averaged or sampled at the step middle */
+static void FOC_Plant_Fixed( FOC_Engine_t * pEngine,
+                             const SVPWM_Timing_t * pTiming, double Tload )
+{
+  const double Ts = pEngine->Tk;
+  const double h  = Ts / pEngine->Cfg.Nsub;
+  uint32_t i;
+
+  if ( pEngine->Cfg.PwmModel == FOC_PWM_SWITCHED )
+  {
+    for ( i = 0; i < pEngine->Cfg.Nsub; i++ )
+    {
+      PMSM_Step( &pEngine->Motor, &pEngine->MotorState,
+                 FOC_Levels_Voltage( pTiming, pEngine->Cfg.Vbus,
+                                     ( i + 0.5 ) * h ),
+                 Tload, h );
+    }
+  }
+  else
+  {
+    abc_t       Vabc;
+    alphabeta_t Valphabeta;
+
+    Vabc.a = pEngine->Cfg.Vbus * SVPWM_Duty( pTiming->Cmp[0], Ts );
+    Vabc.b = pEngine->Cfg.Vbus * SVPWM_Duty( pTiming->Cmp[1], Ts );
+    Vabc.c = pEngine->Cfg.Vbus * SVPWM_Duty( pTiming->Cmp[2], Ts );
+    Valphabeta = MCM_Clarke_Transform( Vabc );
+
+    for ( i = 0; i < pEngine->Cfg.Nsub; i++ )
+    {
+      PMSM_Step( &pEngine->Motor, &pEngine->MotorState, Valphabeta, Tload, h );
+    }
+  }
+}
+
+/**
+  * @brief  Validate the configuration and build an engine at rest
+  * @param  pEngine engine instance
+  * @param  pCfg configuration, copied
+  * @retval 0 on success, -1 if the configuration is out of range
+  */
+int FOC_Engine_Init( FOC_Engine_t * pEngine, const FOC_Config_t * pCfg )
+{
+  const double Vmax = pCfg->Vbus * ONE_BY_SQRT3;
+
+  memset( pEngine, 0, sizeof( *pEngine ) );
+
+  if ( pCfg->Ts <= 0.0 || pCfg->Vbus <= 0.0 || pCfg->Nsub < 1 ||
+       pCfg->TsSpread < 0.0 || pCfg->TsSpread >= 1.0 )
+  {
+    return ( -1 );
+  }
+  if ( PMSM_Init( &pEngine->Motor, &pCfg->Motor, pCfg->Integrator ) != 0 )
+  {
+    return ( -1 );
+  }
+  if ( pCfg->AngleSource == FOC_ANGLE_OBSERVER &&
+       LUENBERGER_Init_Gains( &pEngine->ObsGains, pCfg->Motor.Rs,
+                              0.5 * ( pCfg->Motor.Ld + pCfg->Motor.Lq ),
+                              pCfg->Ts, pCfg->ObsWo, pCfg->ObsWpll ) != 0 )
+  {
+    return ( -1 );
+  }
+
+  pEngine->Cfg        = *pCfg;
+  pEngine->CircLimit  = CircleLimitationM1;
+  pEngine->VoltsToS16 = 32768.0 / Vmax;
+  pEngine->S16ToVolts = Vmax / 32768.0;
+  pEngine->InvVnorm   = 1.5 / pCfg->Vbus;
+  pEngine->RngKey     = RNG_Key( pCfg->Seed, pCfg->Stream );
+  PI_Init( &pEngine->PIq, pCfg->Kp, pCfg->Ki, pCfg->Ts, Vmax );
+  PI_Init( &pEngine->PId, pCfg->Kp, pCfg->Ki, pCfg->Ts, Vmax );
+  FOC_Engine_Reset( pEngine );
+
+  return ( 0 );
+}
+
+/**
+  * @brief  Motor at standstill, regulators and observer cleared, t = 0
+  */
+void FOC_Engine_Reset( FOC_Engine_t * pEngine )
+{
+  PMSM_Reset( &pEngine->MotorState );
+  PI_Reset( &pEngine->PIq );
+  PI_Reset( &pEngine->PId );
+  LUENBERGER_Reset( &pEngine->ObsState );
+  pEngine->Period = 0;
+  pEngine->t      = 0.0;
+  pEngine->Tk     = pEngine->Cfg.Ts;
+  pEngine->Sector = 0;
+  PWM_Timer_Reset( &pEngine->Timer );
+  PWM_Stats_Reset( &pEngine->Stats );
+}
+
+/**
+  * @brief  Control task: current loop of one pwm period
+  * @param  pEngine engine instance
+  * @param  pIn references for this period
+  * @param  pOut signals of this period, may be NULL
+  * @param  pTiming svpwm compare values for the plant task
+  */
+void FOC_Engine_Control( FOC_Engine_t * pEngine, const FOC_Input_t * pIn,
+                         FOC_Output_t * pOut, SVPWM_Timing_t * pTiming )
+{
+  abc_t           Iabc;
+  alphabeta_t     Ialphabeta;
+  alphabeta_t     Valphabeta;
+  qd_real_t       Iqd;
+  qd_real_t       Vqd;
+  qd_t            Vqd_s16;
+  int32_t         index;             /* circle limitation table index */
+  Trig_Components Trig;
+  double          theta_plant;
+  double          theta;
+
+  /* period length, drawn per period for random pwm */
+  pEngine->Tk = ( pEngine->Cfg.TsSpread > 0.0 )
+                ? RNG_Dither_Period( pEngine->RngKey, pEngine->Period,
+                                     pEngine->Cfg.Ts, pEngine->Cfg.TsSpread )
+                : pEngine->Cfg.Ts;
+
+  /* current feedback at the period start */
+  Iabc        = PMSM_Phase_Currents( &pEngine->Motor, &pEngine->MotorState );
+  theta_plant = PMSM_Elec_Angle( &pEngine->Motor, &pEngine->MotorState );
+  theta       = ( pEngine->Cfg.AngleSource == FOC_ANGLE_OBSERVER )
+                ? pEngine->ObsState.Theta : theta_plant;
+  Trig       = MCM_Trig_Functions( theta );
+  Ialphabeta = MCM_Clarke_Transform( Iabc );
+  Iqd        = MCM_Park_Transform( Ialphabeta, Trig );
+
+  /* current regulators and circle limitation on the firmware scale */
+  Vqd.q = PI_Controller( &pEngine->PIq, pIn->IqRef - Iqd.q );
+  Vqd.d = PI_Controller( &pEngine->PId, pIn->IdRef - Iqd.d );
+  Vqd_s16.q = FOC_Sat_S16( Vqd.q * pEngine->VoltsToS16 );
+  Vqd_s16.d = FOC_Sat_S16( Vqd.d * pEngine->VoltsToS16 );
+  Vqd_s16   = Circle_Limitation_Indexed( &pEngine->CircLimit, Vqd_s16, &index );
+  PWM_Stats_Limit( &pEngine->Stats, index );
+  Vqd.q = Vqd_s16.q * pEngine->S16ToVolts;
+  Vqd.d = Vqd_s16.d * pEngine->S16ToVolts;
+
+  /* reverse Park and space vector modulation */
+  Valphabeta = MCM_Rev_Park_Transform( Vqd, Trig );
+  SVPWM_Calc_Timing_Engine( pEngine->Cfg.Engine,
+                            Valphabeta.alpha * pEngine->InvVnorm,
+                            Valphabeta.beta * pEngine->InvVnorm,
+                            pEngine->Tk, &pEngine->Sector, pTiming );
+  SVPWM_Apply_Modulation( pTiming, pEngine->Cfg.Modulation );
+  PWM_Stats_Period( &pEngine->Stats, pTiming );
+
+  /* compare values through the timer registers, written by this ISR */
+  if ( pEngine->Cfg.TimerFclk > 0.0 )
+  {
+    PWM_Timer_Config_t Tim;
+    PWM_Timer_Regs_t   Regs;
+    uint32_t           Arr;
+
+    Tim.Fclk   = pEngine->Cfg.TimerFclk;
+    Tim.Arr    = 0u;
+    Tim.Update = pEngine->Cfg.TimerUpdate;
+    Arr = PWM_Timer_Arr( &Tim, pEngine->Tk );
+    PWM_Timer_Update_Event( &pEngine->Timer );
+    PWM_Timer_Quantize( pTiming, Arr, &Regs );
+    PWM_Timer_Write( &Tim, &pEngine->Timer, &Regs );
+    PWM_Timer_Timing( &pEngine->Timer.Shadow, Arr, pTiming );
+  }
+
+  if ( pEngine->Cfg.AngleSource == FOC_ANGLE_OBSERVER )
+  {
+    LUENBERGER_Step( &pEngine->ObsGains, &pEngine->ObsState,
+                     Valphabeta, Ialphabeta );
+  }
+
+  if ( pOut != NULL )
+  {
+    pOut->Ia        = Iabc.a;
+    pOut->Ib        = Iabc.b;
+    pOut->Ic        = Iabc.c;
+    pOut->Iq        = Iqd.q;
+    pOut->Id        = Iqd.d;
+    pOut->Vq        = Vqd.q;
+    pOut->Vd        = Vqd.d;
+    pOut->Valpha    = Valphabeta.alpha;
+    pOut->Vbeta     = Valphabeta.beta;
+    pOut->Cmp[0]    = pTiming->Cmp[0];
+    pOut->Cmp[1]    = pTiming->Cmp[1];
+    pOut->Cmp[2]    = pTiming->Cmp[2];
+    pOut->Inv[0]    = pTiming->Inv[0];
+    pOut->Inv[1]    = pTiming->Inv[1];
+    pOut->Inv[2]    = pTiming->Inv[2];
+    pOut->Cmv       = SVPWM_Cmv_Average( pTiming, pEngine->Cfg.Vbus );
+    pOut->Switchings = ( uint8_t )SVPWM_Switchings( pTiming, NULL );
+    pOut->Sector    = pTiming->Sector;
+    pOut->Theta     = theta_plant;
+    pOut->ThetaCtrl = theta;
+  }
+}
+
+/**
+  * @brief  Plant task: integrate the motor over one pwm period
+  * @param  pEngine engine instance
+  * @param  pTiming compare values from FOC_Engine_Control()
+  * @param  Tload load torque (Nm)
+  * @param  pOut end of period signals, may be NULL
+  */
+void FOC_Engine_Plant( FOC_Engine_t * pEngine, const SVPWM_Timing_t * pTiming,
+                       double Tload, FOC_Output_t * pOut )
+{
+  if ( pEngine->Cfg.PlantStep == FOC_PLANT_EDGES )
+  {
+    FOC_Plant_Edges( pEngine, pTiming, Tload );
+  }
+  else
+  {
+    FOC_Plant_Fixed( pEngine, pTiming, Tload );
+  }
+  pEngine->Period++;
+  if ( pEngine->Cfg.TsSpread > 0.0 )
+  {
+    pEngine->t += pEngine->Tk;
+  }
+  else
+  {
+    pEngine->t = ( double )pEngine->Period * pEngine->Cfg.Ts;
+  }
+
+  if ( pOut != NULL )
+  {
+    pOut->t  = pEngine->t;
+    pOut->Tk = pEngine->Tk;
+    pOut->We = pEngine->Motor.Params.Pp * pEngine->MotorState.wm;
+    pOut->Te = PMSM_Torque( &pEngine->Motor, &pEngine->MotorState );
+  }
+}
+
+/**
+  * @brief  Run one pwm period of the current loop and the plant
+  * @param  pEngine engine instance
+  * @param  pIn references and load for this period
+  * @param  pOut signals of this period, may be NULL
+  */
+void FOC_Engine_Step( FOC_Engine_t * pEngine, const FOC_Input_t * pIn,
+                      FOC_Output_t * pOut )
+{
+  SVPWM_Timing_t tm;
+
+  FOC_Engine_Control( pEngine, pIn, pOut, &tm );
+  FOC_Engine_Plant( pEngine, &tm, pIn->Tload, pOut );
+}
+
+/**
+  * @brief  Run-time counters since the last FOC_Engine_Reset()
+  * @param  pEngine engine instance
+  * @retval counters, valid while the engine is
+  */
+const PWM_Stats_t * FOC_Engine_Stats( const FOC_Engine_t * pEngine )
+{
+  return ( &pEngine->Stats );
+}
+
+/***************  END OF FILE****/
@@ -0,0 +1,173 @@
+/**
+  ******************************************************************************
+  * @file    foc_engine.h
+  * @brief   This file contains all definitions and functions prototypes for the
+  *          standalone closed-loop FOC current loop simulation (no Simulink)
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  * One FOC_Engine_Step() is one PWM period Ts, the control task
+  * FOC_Engine_Control() followed by the plant task FOC_Engine_Plant():
+  *
+  *   phase currents -> Clarke/Park (sensor or Luenberger angle)
+  *   -> PI d/q -> Circle_Limitation -> reverse Park -> SVPWM
+  *   -> PMSM plant over Ts (averaged or switched phase voltages, Nsub
+  *      fixed steps or one step per interval between switching edges)
+  *
+  * foc_sched.h runs these tasks, plus decimated ones, in a single loop.
+  * With Cfg.TsSpread > 0 every period gets its own length Ts_k drawn from
+  * the counter-based generator of pwm_rng.h (random pwm); the svpwm timing
+  * and the plant follow Ts_k, the PI and observer gains stay designed for
+  * Ts as in firmware.
+  * The regulator output is applied within the same period (ideal ISR).
+  * With Cfg.TimerFclk > 0 the compare values go through the center-aligned
+  * timer of pwm_timer.h, quantized to counts and, with TimerUpdate =
+  * PWM_TIMER_PRELOAD, one period late; the half period update is not
+  * modelled here (symmetric pulses only).
+  * Every period also updates the run-time counters of pwm_stats.h
+  * (circle limitation hits, overmodulation, sector residence), read with
+  * FOC_Engine_Stats() and cleared by FOC_Engine_Reset().
+  * Circle_Limitation works on the firmware 16-bit scale where 32767 is the
+  * linear modulation limit Vbus/sqrt(3). All state lives in FOC_Engine_t,
+  * nothing is allocated, so independent engines can run on any thread.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FOC_ENGINE_H
+#define __FOC_ENGINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "mc_math.h"
+#include "circle_limitation.h"
+#include "pi_regulator.h"
+#include "pmsm_model.h"
+#include "luenberger_obs.h"
+#include "svpwm_core.h"
+#include "pwm_rng.h"
+#include "pwm_timer.h"
+#include "pwm_stats.h"
+
+typedef enum
+{
+  FOC_PWM_AVERAGED = 0,   /**< phase voltage = Vbus * duty over the period */
+  FOC_PWM_SWITCHED = 1    /**< 0/Vbus pulses sampled at the plant steps    */
+} FOC_PwmModel_t;
+
+typedef enum
+{
+  FOC_PLANT_FIXED = 0,    /**< Nsub equal steps per period                 */
+  FOC_PLANT_EDGES = 1     /**< step between switching edges, none longer
+                               than Ts/Nsub; exact for switched pwm        */
+} FOC_PlantStep_t;
+
+typedef enum
+{
+  FOC_ANGLE_SENSOR   = 0, /**< rotor angle from the plant                  */
+  FOC_ANGLE_OBSERVER = 1  /**< rotor angle from the Luenberger observer    */
+} FOC_AngleSource_t;
+
+typedef struct
+{
+  double             Ts;           /**< pwm period = control step (s)        */
+  double             TsSpread;     /**< random pwm: period k uniform on
+                                       Ts*(1 -/+ TsSpread), 0 = fixed Ts    */
+  uint64_t           Seed;         /**< random pwm seed, see pwm_rng.h       */
+  uint64_t           Stream;       /**< random pwm stream, e.g. run number   */
+  double             Vbus;         /**< DC link voltage (V)                  */
+  FOC_PwmModel_t     PwmModel;
+  SVPWM_Modulation_t Modulation;   /**< zero vectors, see svpwm_core.h       */
+  SVPWM_Engine_t     Engine;       /**< svpwm timing, see svpwm_core.h       */
+  uint32_t           Nsub;         /**< plant steps per pwm period           */
+  FOC_PlantStep_t    PlantStep;
+  PMSM_Params_t      Motor;
+  PMSM_Integrator_t  Integrator;
+  double             Kp;           /**< current PI, V/A, both axes           */
+  double             Ki;           /**< current PI, V/(A s)                  */
+  FOC_AngleSource_t  AngleSource;
+  double             ObsWo;        /**< observer bandwidths (rad/s)          */
+  double             ObsWpll;
+  double             TimerFclk;    /**< timer clock (Hz), 0 = compare values
+                                       not quantized                        */
+  PWM_Timer_Update_t TimerUpdate;  /**< direct or preload                    */
+} FOC_Config_t;
+
+typedef struct
+{
+  double IqRef;   /**< A  */
+  double IdRef;   /**< A  */
+  double Tload;   /**< Nm */
+} FOC_Input_t;
+
+typedef struct
+{
+  double  t;          /**< time at the end of the period (s)             */
+  double  Tk;         /**< length of this pwm period (s)                 */
+  double  Ia;         /**< phase currents sampled at the period start    */
+  double  Ib;
+  double  Ic;
+  double  Iq;         /**< feedback in the control frame                 */
+  double  Id;
+  double  Vq;         /**< limited voltage command (V)                   */
+  double  Vd;
+  double  Valpha;     /**< reverse Park output (V)                       */
+  double  Vbeta;
+  double  Cmp[3];     /**< svpwm compare times U, V, W (s)               */
+  uint8_t Inv[3];     /**< phase on the inverted carrier                 */
+  double  Cmv;        /**< period average of (U+V+W)/3 (V)               */
+  uint8_t Switchings; /**< half-bridge transitions in the period         */
+  int16_t Sector;
+  double  We;         /**< plant electrical speed at the period end      */
+  double  Theta;      /**< plant electrical angle at the period start    */
+  double  ThetaCtrl;  /**< angle used by the transforms (rad)            */
+  double  Te;         /**< torque at the period end (Nm)                 */
+} FOC_Output_t;
+
+typedef struct
+{
+  FOC_Config_t              Cfg;
+  PMSM_Handle_t             Motor;
+  PMSM_State_t              MotorState;
+  PI_Handle_t               PIq;
+  PI_Handle_t               PId;
+  CircleLimitation_Handle_t CircLimit;
+  LuenbergerObs_Gains_t     ObsGains;
+  LuenbergerObs_State_t     ObsState;
+  double                    VoltsToS16;  /**< 32768/(Vbus/sqrt(3))       */
+  double                    S16ToVolts;
+  double                    InvVnorm;    /**< 1/(2/3*Vbus), svpwm input  */
+  uint64_t                  RngKey;      /**< random pwm stream key      */
+  uint64_t                  Period;      /**< pwm periods run            */
+  double                    Tk;          /**< current pwm period         */
+  int16_t                   Sector;      /**< svpwm sector, 0 = none     */
+  PWM_Timer_t               Timer;       /**< compare registers          */
+  PWM_Stats_t               Stats;       /**< run-time counters          */
+  double                    t;           /**< sum of the periods run     */
+} FOC_Engine_t;
+
+/* Exported functions ------------------------------------------------------- */
+
+int  FOC_Engine_Init( FOC_Engine_t * pEngine, const FOC_Config_t * pCfg );
+void FOC_Engine_Reset( FOC_Engine_t * pEngine );
+void FOC_Engine_Control( FOC_Engine_t * pEngine, const FOC_Input_t * pIn,
+                         FOC_Output_t * pOut, SVPWM_Timing_t * pTiming );
+void FOC_Engine_Plant( FOC_Engine_t * pEngine, const SVPWM_Timing_t * pTiming,
+                       double Tload, FOC_Output_t * pOut );
+void FOC_Engine_Step( FOC_Engine_t * pEngine, const FOC_Input_t * pIn,
+                      FOC_Output_t * pOut );
+const PWM_Stats_t * FOC_Engine_Stats( const FOC_Engine_t * pEngine );
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __FOC_ENGINE_H */
+
+/* *****END OF FILE****/
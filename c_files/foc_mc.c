@@ -0,0 +1,284 @@
+/**
+  ******************************************************************************
+  * @file    foc_mc.c
+  * @brief   This file provides the multithreaded Monte Carlo tolerance
+  *          analysis of the FOC voltage chain
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * license info:
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "foc_mc.h"
+
+#define TWO_PI 6.28318530717958647693
+
+typedef struct
+{
+  const FOC_Config_t *    pCfg;
+  const FOC_MC_Config_t * pMc;
+  uint32_t                Worker;
+  int                     Status;
+  FOC_MC_Stats_t          Stats;
+} FOC_MC_Worker_t;
+
+static int16_t FOC_MC_Sat_S16( double x )
+{
+  x = floor( x + 0.5 );
+  return ( ( int16_t )( ( x > 32767.0 ) ? 32767.0 :
+                        ( ( x < -32768.0 ) ? -32768.0 : x ) ) );
+}
+
+/* common mode free, period averaged phase voltages of one command */
+static void FOC_MC_Chain( FOC_Engine_t * pEngine, qd_t Vqd_s16, double Scale,
+                          double theta, double Vbus, double Tk, double * pV )
+{
+  const double Ts = pEngine->Cfg.Ts;
+  qd_t           lim;
+  qd_real_t      Vqd;
+  alphabeta_t    Vab;
+  SVPWM_Timing_t tm;
+  double         mean;
+  int            i;
+
+  /* limit circle of radius Scale * MaxModule, same table */
+  lim.q = FOC_MC_Sat_S16( Vqd_s16.q / Scale );
+  lim.d = FOC_MC_Sat_S16( Vqd_s16.d / Scale );
+  lim   = Circle_Limitation( &pEngine->CircLimit, lim );
+  Vqd.q = lim.q * Scale * pEngine->S16ToVolts;
+  Vqd.d = lim.d * Scale * pEngine->S16ToVolts;
+
+  Vab = MCM_Rev_Park_Transform( Vqd, MCM_Trig_Functions( theta ) );
+  SVPWM_Calc_Timing_Engine( pEngine->Cfg.Engine, Vab.alpha * pEngine->InvVnorm,
+                            Vab.beta * pEngine->InvVnorm, Ts,
+                            &pEngine->Sector, &tm );
+  SVPWM_Apply_Modulation( &tm, pEngine->Cfg.Modulation );
+
+  for ( i = 0; i < 3; i++ )
+  {
+    pV[i] = Vbus * SVPWM_Duty( tm.Cmp[i], Tk );
+  }
+  mean = ( pV[0] + pV[1] + pV[2] ) / 3.0;
+  for ( i = 0; i < 3; i++ )
+  {
+    pV[i] -= mean;
+  }
+}
+
+static void FOC_MC_Add( FOC_MC_Stats_t * pStats, double e, uint64_t Trial )
+{
+  int32_t bin;
+
+  pStats->Count++;
+  pStats->Sum   += e;
+  pStats->SumSq += e * e;
+  if ( e > pStats->Max || pStats->Count == 1 )
+  {
+    pStats->Max      = e;
+    pStats->MaxTrial = Trial;
+  }
+
+  if ( e < 1.0e-9 )
+  {
+    bin = 0;
+  }
+  else
+  {
+    bin = 1 + ( int32_t )floor( ( log10( e ) + 9.0 ) * FOC_MC_PER_DECADE );
+    bin = ( bin > FOC_MC_BINS - 1 ) ? FOC_MC_BINS - 1 : bin;
+  }
+  pStats->Hist[bin]++;
+}
+
+static void * FOC_MC_Thread( void * pArg )
+{
+  FOC_MC_Worker_t * pW = ( FOC_MC_Worker_t * )pArg;
+  FOC_Engine_t      engine;
+  uint64_t          chunks = ( pW->pMc->Trials + FOC_MC_CHUNK - 1 ) / FOC_MC_CHUNK;
+  uint64_t          c;
+  uint64_t          k;
+
+  pW->Status = FOC_Engine_Init( &engine, pW->pCfg );
+  if ( pW->Status != 0 )
+  {
+    return ( NULL );
+  }
+
+  for ( c = pW->Worker; c < chunks; c += pW->pMc->Threads )
+  {
+    uint64_t end = ( c + 1 ) * FOC_MC_CHUNK;
+
+    end = ( end > pW->pMc->Trials ) ? pW->pMc->Trials : end;
+    for ( k = c * FOC_MC_CHUNK; k < end; k++ )
+    {
+      FOC_MC_Add( &pW->Stats, FOC_MC_Trial( &engine, pW->pMc, k ), k );
+    }
+  }
+  return ( NULL );
+}
+
+/**
+  * @brief  One trial, see foc_mc.h
+  * @param  pEngine initialized engine, only its scaling, limiter and svpwm
+  *         settings are used
+  * @param  pMc tolerances
+  * @param  Trial trial number, selects the random draws
+  * @retval largest phase voltage error (V)
+  */
+double FOC_MC_Trial( FOC_Engine_t * pEngine, const FOC_MC_Config_t * pMc,
+                     uint64_t Trial )
+{
+  const uint64_t key = RNG_Key( pEngine->Cfg.Seed,
+                                FOC_MC_STREAM + Trial / FOC_MC_CHUNK );
+  const uint64_t k0  = ( Trial % FOC_MC_CHUNK ) * 8u;
+  const double   Vbus = pEngine->Cfg.Vbus;
+  const double   Ts   = pEngine->Cfg.Ts;
+  double r     = pMc->VqdMax * 32767.0 * sqrt( RNG_Uniform( key, k0 ) );
+  double phi   = TWO_PI * RNG_Uniform( key, k0 + 1 );
+  double theta = TWO_PI * RNG_Uniform( key, k0 + 2 );
+  double vbus  = Vbus * ( 1.0 + pMc->VbusRipple * ( 2.0 * RNG_Uniform( key, k0 + 3 ) - 1.0 ) );
+  double tk    = Ts * ( 1.0 + pMc->TsJitter * ( 2.0 * RNG_Uniform( key, k0 + 4 ) - 1.0 ) );
+  double scale = 1.0 + pMc->MaxModuleTol * ( 2.0 * RNG_Uniform( key, k0 + 5 ) - 1.0 );
+  double err   = pMc->AngleErr * ( 2.0 * RNG_Uniform( key, k0 + 6 ) - 1.0 );
+  double v0[3];
+  double v1[3];
+  double e = 0.0;
+  qd_t   Vqd;
+  int    i;
+
+  Vqd.q = FOC_MC_Sat_S16( r * cos( phi ) );
+  Vqd.d = FOC_MC_Sat_S16( r * sin( phi ) );
+
+  FOC_MC_Chain( pEngine, Vqd, 1.0, theta, Vbus, Ts, v0 );
+  FOC_MC_Chain( pEngine, Vqd, scale, theta + err, vbus, tk, v1 );
+
+  for ( i = 0; i < 3; i++ )
+  {
+    double d = fabs( v1[i] - v0[i] );
+
+    e = ( d > e ) ? d : e;
+  }
+  return ( e );
+}
+
+/**
+  * @brief  Run pMc->Trials trials on pMc->Threads threads
+  * @param  pCfg engine configuration: Vbus, Ts, Seed, svpwm engine and
+  *         modulation; the motor is not simulated but must be valid
+  * @param  pMc tolerances, trials and threads
+  * @param  pStats result, sum over all threads
+  * @retval 0 on success, -1 on a bad configuration or thread failure
+  */
+int FOC_MC_Run( const FOC_Config_t * pCfg, const FOC_MC_Config_t * pMc,
+                FOC_MC_Stats_t * pStats )
+{
+  FOC_MC_Worker_t * workers;
+  pthread_t threads[FOC_MC_MAX_THREADS];
+  uint32_t  started = 0;
+  uint32_t  i;
+  uint32_t  b;
+  int       rc = 0;
+
+  memset( pStats, 0, sizeof( *pStats ) );
+  if ( pMc->Threads < 1 || pMc->Threads > FOC_MC_MAX_THREADS ||
+       pMc->Trials < 1 || pMc->VqdMax < 0.0 || pMc->VbusRipple < 0.0 ||
+       pMc->VbusRipple >= 1.0 || pMc->TsJitter < 0.0 || pMc->TsJitter >= 1.0 ||
+       pMc->MaxModuleTol < 0.0 || pMc->MaxModuleTol >= 1.0 ||
+       pMc->AngleErr < 0.0 )
+  {
+    return ( -1 );
+  }
+  workers = ( FOC_MC_Worker_t * )calloc( pMc->Threads, sizeof( FOC_MC_Worker_t ) );
+  if ( workers == NULL )
+  {
+    return ( -1 );
+  }
+
+  for ( i = 0; i < pMc->Threads; i++ )
+  {
+    workers[i].pCfg   = pCfg;
+    workers[i].pMc    = pMc;
+    workers[i].Worker = i;
+    if ( pthread_create( &threads[i], NULL, FOC_MC_Thread, &workers[i] ) != 0 )
+    {
+      rc = -1;
+      break;
+    }
+    started++;
+  }
+
+  /* reduce after the join, the workers share nothing */
+  for ( i = 0; i < started; i++ )
+  {
+    const FOC_MC_Stats_t * pW = &workers[i].Stats;
+
+    pthread_join( threads[i], NULL );
+    if ( workers[i].Status != 0 )
+    {
+      rc = -1;
+    }
+    if ( pW->Count > 0 &&
+         ( pStats->Count == 0 || pW->Max > pStats->Max ||
+           ( pW->Max == pStats->Max && pW->MaxTrial < pStats->MaxTrial ) ) )
+    {
+      pStats->Max      = pW->Max;
+      pStats->MaxTrial = pW->MaxTrial;
+    }
+    pStats->Count += pW->Count;
+    pStats->Sum   += pW->Sum;
+    pStats->SumSq += pW->SumSq;
+    for ( b = 0; b < FOC_MC_BINS; b++ )
+    {
+      pStats->Hist[b] += pW->Hist[b];
+    }
+  }
+  free( workers );
+  return ( rc );
+}
+
+/**
+  * @brief  Upper edge of a histogram bin (V), +inf for the last one
+  */
+double FOC_MC_Bin_Edge( uint32_t Bin )
+{
+  if ( Bin >= FOC_MC_BINS - 1 )
+  {
+    return ( HUGE_VAL );
+  }
+  return ( pow( 10.0, -9.0 + ( double )Bin / FOC_MC_PER_DECADE ) );
+}
+
+/**
+  * @brief  Error not exceeded by a fraction P of the trials, to the
+  *         histogram resolution (bin upper edge, Max if that is lower)
+  * @param  pStats result of FOC_MC_Run()
+  * @param  P 0..1, e.g. 0.999
+  */
+double FOC_MC_Percentile( const FOC_MC_Stats_t * pStats, double P )
+{
+  double   need = P * ( double )pStats->Count;
+  uint64_t cum  = 0;
+  uint32_t b;
+
+  for ( b = 0; b < FOC_MC_BINS; b++ )
+  {
+    cum += pStats->Hist[b];
+    if ( cum > 0 && ( double )cum >= need )
+    {
+      double edge = FOC_MC_Bin_Edge( b );
+
+      return ( ( edge < pStats->Max ) ? edge : pStats->Max );
+    }
+  }
+  return ( pStats->Max );
+}
+
+/***************  END OF FILE****/
@@ -0,0 +1,92 @@
+/**
+  ******************************************************************************
+  * @file    foc_mc.h
+  * @brief   This file contains all definitions and functions prototypes for the
+  *          Monte Carlo tolerance analysis of the FOC voltage chain
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  * One trial draws a voltage command (Vq, Vd) on the firmware 16-bit scale,
+  * uniform over the disc of radius VqdMax * 32767, and a rotor angle, then
+  * runs the chain
+  *
+  *   Circle_Limitation -> reverse Park -> svpwm -> period average of the
+  *   phase voltages, Vbus * duty, common mode removed
+  *
+  * twice: nominal, and with each tolerance drawn uniform on [-tol, +tol]:
+  *
+  *   VbusRipple   actual bus Vbus * (1 + u), svpwm still scaled for Vbus
+  *   TsJitter     actual period Ts * (1 + u), compare values for Ts
+  *   MaxModuleTol limit circle radius * (1 + u): the firmware limiter runs
+  *                on the command scaled by 1/(1 + u), the result is scaled
+  *                back, so the table shape is kept
+  *   AngleErr     reverse Park angle theta + u (rad)
+  *
+  * The trial error is the largest phase voltage difference (V). Trials are
+  * cut into chunks of FOC_MC_CHUNK; chunk c draws from the pwm_rng.h stream
+  * FOC_MC_STREAM + c of Cfg.Seed, so the results do not depend on the
+  * number of threads. Each worker thread owns an engine (FOC_Engine_Init)
+  * and its statistics; they are added after the threads are joined, no
+  * locks. The error histogram has FOC_MC_PER_DECADE log bins per decade
+  * from 1e-9 V to 1e3 V, percentiles are read at the bin upper edges.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FOC_MC_H
+#define __FOC_MC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "foc_engine.h"
+
+#define FOC_MC_MAX_THREADS  64
+#define FOC_MC_CHUNK        4096u
+#define FOC_MC_STREAM       0x4d43000000000000ull
+#define FOC_MC_PER_DECADE   20
+#define FOC_MC_DECADES      12                 /* 1e-9 .. 1e3 V          */
+#define FOC_MC_BINS         ( FOC_MC_PER_DECADE * FOC_MC_DECADES + 2 )
+
+typedef struct
+{
+  uint64_t Trials;
+  uint32_t Threads;       /**< 1..FOC_MC_MAX_THREADS                      */
+  double   VqdMax;        /**< command radius / 32767, e.g. 1.1           */
+  double   VbusRipple;    /**< relative, e.g. 0.05                        */
+  double   TsJitter;      /**< relative                                   */
+  double   MaxModuleTol;  /**< relative                                   */
+  double   AngleErr;      /**< rad                                        */
+} FOC_MC_Config_t;
+
+typedef struct
+{
+  uint64_t Count;
+  double   Sum;
+  double   SumSq;
+  double   Max;
+  uint64_t MaxTrial;           /**< trial number of Max, for a rerun       */
+  uint64_t Hist[FOC_MC_BINS];  /**< [0] below 1e-9 V, [last] 1e3 V and up  */
+} FOC_MC_Stats_t;
+
+/* Exported functions ------------------------------------------------------- */
+
+int    FOC_MC_Run( const FOC_Config_t * pCfg, const FOC_MC_Config_t * pMc,
+                   FOC_MC_Stats_t * pStats );
+double FOC_MC_Trial( FOC_Engine_t * pEngine, const FOC_MC_Config_t * pMc,
+                     uint64_t Trial );
+double FOC_MC_Percentile( const FOC_MC_Stats_t * pStats, double P );
+double FOC_MC_Bin_Edge( uint32_t Bin );
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __FOC_MC_H */
+
+/* *****END OF FILE****/
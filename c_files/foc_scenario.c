@@ -0,0 +1,552 @@
+/**
+  ******************************************************************************
+  * @file    foc_scenario.c
+  * @brief   This file provides the scenario file reader and the scenario
+  *          run of the standalone FOC simulation
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * license info:
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "foc_scenario.h"
+#include "foc_sched.h"
+
+#define TWO_PI  6.28318530717958647693
+#define LINE_LEN 512
+
+typedef struct
+{
+  const char * Name;
+  size_t       Offset;   /**< offset of the double in FOC_Scenario_t */
+} FOC_Key_t;
+
+/* numeric keys, name = value */
+static const FOC_Key_t FOC_Keys[] =
+{
+  { "Ts",               offsetof( FOC_Scenario_t, Cfg.Ts )          },
+  { "Vbus",             offsetof( FOC_Scenario_t, Cfg.Vbus )        },
+  { "Rs",               offsetof( FOC_Scenario_t, Cfg.Motor.Rs )    },
+  { "Ld",               offsetof( FOC_Scenario_t, Cfg.Motor.Ld )    },
+  { "Lq",               offsetof( FOC_Scenario_t, Cfg.Motor.Lq )    },
+  { "PsiM",             offsetof( FOC_Scenario_t, Cfg.Motor.PsiM )  },
+  { "Pp",               offsetof( FOC_Scenario_t, Cfg.Motor.Pp )    },
+  { "J",                offsetof( FOC_Scenario_t, Cfg.Motor.J )     },
+  { "B",                offsetof( FOC_Scenario_t, Cfg.Motor.B )     },
+  { "Kcog",             offsetof( FOC_Scenario_t, Cfg.Motor.Kcog )  },
+  { "Ncog",             offsetof( FOC_Scenario_t, Cfg.Motor.Ncog )  },
+  { "Kp",               offsetof( FOC_Scenario_t, Cfg.Kp )          },
+  { "Ki",               offsetof( FOC_Scenario_t, Cfg.Ki )          },
+  { "obs_wo",           offsetof( FOC_Scenario_t, Cfg.ObsWo )       },
+  { "obs_wpll",         offsetof( FOC_Scenario_t, Cfg.ObsWpll )     },
+  { "ts_spread",        offsetof( FOC_Scenario_t, Cfg.TsSpread )    },
+  { "timer_fclk",       offsetof( FOC_Scenario_t, Cfg.TimerFclk )   },
+  { "spectrum_f1",      offsetof( FOC_Scenario_t, SpecF1 )          },
+  { "t_end",            offsetof( FOC_Scenario_t, Tend )            },
+  { "mc_vqd_max",       offsetof( FOC_Scenario_t, Mc.VqdMax )       },
+  { "mc_vbus_ripple",   offsetof( FOC_Scenario_t, Mc.VbusRipple )   },
+  { "mc_ts_jitter",     offsetof( FOC_Scenario_t, Mc.TsJitter )     },
+  { "mc_maxmodule_tol", offsetof( FOC_Scenario_t, Mc.MaxModuleTol ) },
+  { "mc_angle_err",     offsetof( FOC_Scenario_t, Mc.AngleErr )     },
+};
+
+typedef struct
+{
+  const char * Name;
+  size_t       Offset;   /**< offset of the integer in FOC_Scenario_t */
+  size_t       Size;     /**< sizeof the integer, 4 or 8               */
+  double       Max;      /**< largest value, the smallest is 1         */
+} FOC_Int_Key_t;
+
+/* integer keys, name = value >= 1 */
+static const FOC_Int_Key_t FOC_Int_Keys[] =
+{
+  { "nsub",            offsetof( FOC_Scenario_t, Cfg.Nsub ),      4, 1.0e9  },
+  { "log_decimation",  offsetof( FOC_Scenario_t, LogDecimation ), 4, 1.0e9  },
+  { "spectrum_harm",   offsetof( FOC_Scenario_t, SpecHarm ),      4, 1.0e9  },
+  { "spectrum_cycles", offsetof( FOC_Scenario_t, SpecCycles ),    4, 1.0e9  },
+  { "mc_trials",       offsetof( FOC_Scenario_t, Mc.Trials ),     8, 1.0e15 },
+  { "mc_threads",      offsetof( FOC_Scenario_t, Mc.Threads ),    4, 1.0e9  },
+};
+
+static char * FOC_Trim( char * s )
+{
+  char * end;
+
+  while ( isspace( ( unsigned char )*s ) )
+  {
+    s++;
+  }
+  end = s + strlen( s );
+  while ( end > s && isspace( ( unsigned char )end[-1] ) )
+  {
+    *--end = '\0';
+  }
+  return ( s );
+}
+
+static int FOC_Parse_Double( const char * s, double * pValue )
+{
+  char * end;
+
+  *pValue = strtod( s, &end );
+  return ( ( end == s || *end != '\0' ) ? -1 : 0 );
+}
+
+/* key = value, 0 on success */
+static int FOC_Scenario_Set( FOC_Scenario_t * pSc, const char * key,
+                             const char * value )
+{
+  size_t i;
+  double x;
+
+  for ( i = 0; i < sizeof( FOC_Keys ) / sizeof( FOC_Keys[0] ); i++ )
+  {
+    if ( strcmp( key, FOC_Keys[i].Name ) == 0 )
+    {
+      return ( FOC_Parse_Double( value,
+                 ( double * )( ( char * )pSc + FOC_Keys[i].Offset ) ) );
+    }
+  }
+  for ( i = 0; i < sizeof( FOC_Int_Keys ) / sizeof( FOC_Int_Keys[0] ); i++ )
+  {
+    if ( strcmp( key, FOC_Int_Keys[i].Name ) == 0 )
+    {
+      char * p = ( char * )pSc + FOC_Int_Keys[i].Offset;
+
+      if ( FOC_Parse_Double( value, &x ) != 0 || x < 1.0 ||
+           x > FOC_Int_Keys[i].Max )
+      {
+        return ( -1 );
+      }
+      if ( FOC_Int_Keys[i].Size == sizeof( uint64_t ) )
+      {
+        *( uint64_t * )p = ( uint64_t )x;
+      }
+      else
+      {
+        *( uint32_t * )p = ( uint32_t )x;
+      }
+      return ( 0 );
+    }
+  }
+
+  if ( strcmp( key, "pwm" ) == 0 )
+  {
+    if ( strcmp( value, "averaged" ) == 0 )
+    {
+      pSc->Cfg.PwmModel = FOC_PWM_AVERAGED;
+    }
+    else if ( strcmp( value, "switched" ) == 0 )
+    {
+      pSc->Cfg.PwmModel = FOC_PWM_SWITCHED;
+    }
+    else
+    {
+      return ( -1 );
+    }
+    return ( 0 );
+  }
+  if ( strcmp( key, "integrator" ) == 0 )
+  {
+    if ( strcmp( value, "rk4" ) == 0 )
+    {
+      pSc->Cfg.Integrator = PMSM_RK4;
+    }
+    else if ( strcmp( value, "semi" ) == 0 )
+    {
+      pSc->Cfg.Integrator = PMSM_SEMI_IMPLICIT;
+    }
+    else
+    {
+      return ( -1 );
+    }
+    return ( 0 );
+  }
+  if ( strcmp( key, "modulation" ) == 0 )
+  {
+    if ( strcmp( value, "svpwm" ) == 0 )
+    {
+      pSc->Cfg.Modulation = SVPWM_MOD_SVPWM;
+    }
+    else if ( strcmp( value, "azspwm" ) == 0 )
+    {
+      pSc->Cfg.Modulation = SVPWM_MOD_AZSPWM;
+    }
+    else if ( strcmp( value, "nspwm" ) == 0 )
+    {
+      pSc->Cfg.Modulation = SVPWM_MOD_NSPWM;
+    }
+    else
+    {
+      return ( -1 );
+    }
+    return ( 0 );
+  }
+  if ( strcmp( key, "sector" ) == 0 )
+  {
+    if ( strcmp( value, "full" ) == 0 )
+    {
+      pSc->Cfg.Engine = SVPWM_ENGINE_FULL;
+    }
+    else if ( strcmp( value, "track" ) == 0 )
+    {
+      pSc->Cfg.Engine = SVPWM_ENGINE_TRACKED;
+    }
+    else if ( strcmp( value, "minmax" ) == 0 )
+    {
+      pSc->Cfg.Engine = SVPWM_ENGINE_MINMAX;
+    }
+    else
+    {
+      return ( -1 );
+    }
+    return ( 0 );
+  }
+  if ( strcmp( key, "timer_update" ) == 0 )
+  {
+    if ( strcmp( value, "direct" ) == 0 )
+    {
+      pSc->Cfg.TimerUpdate = PWM_TIMER_DIRECT;
+    }
+    else if ( strcmp( value, "preload" ) == 0 )
+    {
+      pSc->Cfg.TimerUpdate = PWM_TIMER_PRELOAD;
+    }
+    else
+    {
+      return ( -1 );
+    }
+    return ( 0 );
+  }
+  if ( strcmp( key, "plant_step" ) == 0 )
+  {
+    if ( strcmp( value, "fixed" ) == 0 )
+    {
+      pSc->Cfg.PlantStep = FOC_PLANT_FIXED;
+    }
+    else if ( strcmp( value, "edges" ) == 0 )
+    {
+      pSc->Cfg.PlantStep = FOC_PLANT_EDGES;
+    }
+    else
+    {
+      return ( -1 );
+    }
+    return ( 0 );
+  }
+  if ( strcmp( key, "angle" ) == 0 )
+  {
+    if ( strcmp( value, "sensor" ) == 0 )
+    {
+      pSc->Cfg.AngleSource = FOC_ANGLE_SENSOR;
+    }
+    else if ( strcmp( value, "observer" ) == 0 )
+    {
+      pSc->Cfg.AngleSource = FOC_ANGLE_OBSERVER;
+    }
+    else
+    {
+      return ( -1 );
+    }
+    return ( 0 );
+  }
+  if ( strcmp( key, "seed" ) == 0 )
+  {
+    char * end;
+
+    pSc->Cfg.Seed = strtoull( value, &end, 0 );
+    return ( ( end == value || *end != '\0' ) ? -1 : 0 );
+  }
+  return ( -1 );
+}
+
+/* references at time t, *pCursor is the segment of the previous call */
+static void FOC_Scenario_Interp( const FOC_Scenario_t * pSc, uint32_t * pCursor,
+                                 double t, FOC_Input_t * pIn )
+{
+  const FOC_Profile_Point_t * p0;
+  const FOC_Profile_Point_t * p1;
+  uint32_t k = *pCursor;
+  double   r;
+
+  if ( pSc->NPoints == 0 )
+  {
+    pIn->IqRef = 0.0;
+    pIn->IdRef = 0.0;
+    pIn->Tload = 0.0;
+    return;
+  }
+  if ( k >= pSc->NPoints || pSc->Points[k].t > t )
+  {
+    k = 0;
+  }
+  while ( k + 1 < pSc->NPoints && pSc->Points[k + 1].t <= t )
+  {
+    k++;
+  }
+  *pCursor = k;
+
+  p0 = &pSc->Points[k];
+  if ( k + 1 >= pSc->NPoints || t <= p0->t )
+  {
+    pIn->IqRef = p0->IqRef;
+    pIn->IdRef = p0->IdRef;
+    pIn->Tload = p0->Tload;
+    return;
+  }
+  p1 = p0 + 1;
+  r  = ( t - p0->t ) / ( p1->t - p0->t );
+  pIn->IqRef = p0->IqRef + r * ( p1->IqRef - p0->IqRef );
+  pIn->IdRef = p0->IdRef + r * ( p1->IdRef - p0->IdRef );
+  pIn->Tload = p0->Tload + r * ( p1->Tload - p0->Tload );
+}
+
+/**
+  * @brief  Default scenario: small 4 pole pair motor, 20 kHz, 24 V,
+  *         1 kHz current loop bandwidth, zero references for 0.1 s
+  */
+void FOC_Scenario_Defaults( FOC_Scenario_t * pSc )
+{
+  memset( pSc, 0, sizeof( *pSc ) );
+
+  pSc->Cfg.Ts          = 50.0e-6;
+  pSc->Cfg.Vbus        = 24.0;
+  pSc->Cfg.PwmModel    = FOC_PWM_AVERAGED;
+  pSc->Cfg.Nsub        = 1;
+  pSc->Cfg.PlantStep   = FOC_PLANT_FIXED;
+  pSc->Cfg.Modulation  = SVPWM_MOD_SVPWM;
+  pSc->Cfg.Motor.Rs    = 0.5;
+  pSc->Cfg.Motor.Ld    = 1.0e-3;
+  pSc->Cfg.Motor.Lq    = 1.0e-3;
+  pSc->Cfg.Motor.PsiM  = 0.01;
+  pSc->Cfg.Motor.Pp    = 4.0;
+  pSc->Cfg.Motor.J     = 1.0e-4;
+  pSc->Cfg.Motor.B     = 1.0e-5;
+  pSc->Cfg.Integrator  = PMSM_RK4;
+  pSc->Cfg.Kp          = TWO_PI * 1000.0 * 1.0e-3;
+  pSc->Cfg.Ki          = TWO_PI * 1000.0 * 0.5;
+  pSc->Cfg.AngleSource = FOC_ANGLE_SENSOR;
+  pSc->Cfg.ObsWo       = 3000.0;
+  pSc->Cfg.ObsWpll     = 300.0;
+  pSc->Tend            = 0.1;
+  pSc->LogDecimation   = 1;
+  pSc->SpecHarm        = 50;
+  pSc->SpecCycles      = 1;
+  pSc->Mc.Trials       = 100000;
+  pSc->Mc.Threads      = 1;
+  pSc->Mc.VqdMax       = 1.1;
+}
+
+/**
+  * @brief  Read a scenario file on top of the defaults
+  * @param  pPath file name
+  * @param  pSc scenario, written
+  * @param  pErr message on failure, may be NULL
+  * @param  ErrLen size of pErr
+  * @retval 0 on success, -1 on error
+  */
+int FOC_Scenario_Load( const char * pPath, FOC_Scenario_t * pSc,
+                       char * pErr, size_t ErrLen )
+{
+  char   line[LINE_LEN];
+  FILE * fp;
+  int    lineno = 0;
+  int    rc = 0;
+
+  FOC_Scenario_Defaults( pSc );
+
+  fp = fopen( pPath, "r" );
+  if ( fp == NULL )
+  {
+    if ( pErr != NULL ) snprintf( pErr, ErrLen, "%s: cannot open", pPath );
+    return ( -1 );
+  }
+
+  while ( rc == 0 && fgets( line, sizeof( line ), fp ) != NULL )
+  {
+    char * s = line;
+    char * eq;
+
+    lineno++;
+    if ( ( eq = strchr( s, '#' ) ) != NULL )
+    {
+      *eq = '\0';
+    }
+    s = FOC_Trim( s );
+    if ( *s == '\0' )
+    {
+      continue;
+    }
+
+    if ( strncmp( s, "point", 5 ) == 0 && isspace( ( unsigned char )s[5] ) )
+    {
+      FOC_Profile_Point_t * p = &pSc->Points[pSc->NPoints];
+
+      if ( pSc->NPoints >= FOC_SCENARIO_MAX_POINTS ||
+           sscanf( s + 5, "%lf %lf %lf %lf", &p->t, &p->IqRef, &p->IdRef,
+                   &p->Tload ) != 4 ||
+           ( pSc->NPoints > 0 && p->t <= p[-1].t ) )
+      {
+        rc = -1;
+      }
+      else
+      {
+        pSc->NPoints++;
+      }
+    }
+    else if ( ( eq = strchr( s, '=' ) ) != NULL )
+    {
+      *eq = '\0';
+      rc = FOC_Scenario_Set( pSc, FOC_Trim( s ), FOC_Trim( eq + 1 ) );
+    }
+    else
+    {
+      rc = -1;
+    }
+  }
+  fclose( fp );
+
+  if ( rc != 0 && pErr != NULL )
+  {
+    snprintf( pErr, ErrLen, "%s:%d: syntax error", pPath, lineno );
+  }
+  return ( rc );
+}
+
+/**
+  * @brief  Profile references at time t
+  */
+void FOC_Scenario_Input( const FOC_Scenario_t * pSc, double t,
+                         FOC_Input_t * pIn )
+{
+  uint32_t cursor = 0;
+
+  FOC_Scenario_Interp( pSc, &cursor, t, pIn );
+}
+
+/* FOC_Scenario_Run() context: interpolation cursor and error sums */
+typedef struct
+{
+  const FOC_Scenario_t * pSc;
+  uint32_t               Cursor;
+  uint64_t               Periods;
+  double                 SumEq;
+  double                 SumEd;
+  double                 IPeak2;
+  double                 ThetaErr;
+} FOC_Run_t;
+
+/* every period, when the analyzer is on */
+static void FOC_Run_Spectrum( void * pCtx, const FOC_Input_t * pIn,
+                              const FOC_Output_t * pOut )
+{
+  ( void )pIn;
+  PWM_Spectrum_Add_Period( ( PWM_Spectrum_t * )pCtx, pOut->t - pOut->Tk,
+                           pOut->Tk, pOut->Cmp, pOut->Inv );
+}
+
+static void FOC_Run_Input( void * pCtx, double t, FOC_Input_t * pIn )
+{
+  FOC_Run_t * pRun = ( FOC_Run_t * )pCtx;
+
+  FOC_Scenario_Interp( pRun->pSc, &pRun->Cursor, t, pIn );
+}
+
+/* every period */
+static void FOC_Run_Summary( void * pCtx, const FOC_Input_t * pIn,
+                             const FOC_Output_t * pOut )
+{
+  FOC_Run_t * pRun = ( FOC_Run_t * )pCtx;
+  double      e;
+
+  pRun->Periods++;
+  pRun->SumEq += ( pIn->IqRef - pOut->Iq ) * ( pIn->IqRef - pOut->Iq );
+  pRun->SumEd += ( pIn->IdRef - pOut->Id ) * ( pIn->IdRef - pOut->Id );
+  e = ( pOut->Ia * pOut->Ia + pOut->Ib * pOut->Ib + pOut->Ic * pOut->Ic )
+      * ( 2.0 / 3.0 );
+  if ( e > pRun->IPeak2 )
+  {
+    pRun->IPeak2 = e;
+  }
+  e = fabs( remainder( pOut->ThetaCtrl - pOut->Theta, TWO_PI ) );
+  if ( e > pRun->ThetaErr )
+  {
+    pRun->ThetaErr = e;
+  }
+}
+
+/**
+  * @brief  Run a scenario from rest to Tend on the foc_sched.h loop
+  * @param  pSc scenario
+  * @param  pEngine engine, initialized here from the scenario
+  * @param  LogFn called every LogDecimation periods, may be NULL
+  * @param  pCtx passed to LogFn
+  * @param  pSpectrum analyzer, set up here when SpecF1 > 0, may be NULL
+  * @param  pSummary result, may be NULL
+  * @retval 0 on success, -1 if the scenario configuration is invalid
+  */
+int FOC_Scenario_Run( const FOC_Scenario_t * pSc, FOC_Engine_t * pEngine,
+                      FOC_Log_Fn LogFn, void * pCtx,
+                      PWM_Spectrum_t * pSpectrum,
+                      FOC_Summary_t * pSummary )
+{
+  FOC_Sched_t sched;
+  FOC_Run_t   run;
+  uint64_t    periods;
+
+  if ( FOC_Engine_Init( pEngine, &pSc->Cfg ) != 0 )
+  {
+    return ( -1 );
+  }
+
+  memset( &run, 0, sizeof( run ) );
+  run.pSc = pSc;
+
+  FOC_Sched_Init( &sched, pEngine, FOC_Run_Input, &run );
+  FOC_Sched_Add_Task( &sched, FOC_Run_Summary, &run, 1 );
+  if ( pSpectrum != NULL && pSc->SpecF1 > 0.0 )
+  {
+    if ( PWM_Spectrum_Init( pSpectrum, pSc->SpecF1, pSc->SpecHarm,
+                            pSc->SpecCycles, pSc->Cfg.Vbus ) != 0 )
+    {
+      return ( -1 );
+    }
+    FOC_Sched_Add_Task( &sched, FOC_Run_Spectrum, pSpectrum, 1 );
+  }
+  if ( LogFn != NULL &&
+       FOC_Sched_Add_Task( &sched, LogFn, pCtx, pSc->LogDecimation ) != 0 )
+  {
+    return ( -1 );
+  }
+
+  periods = ( uint64_t )ceil( pSc->Tend / pSc->Cfg.Ts - 1.0e-9 );
+  FOC_Sched_Run( &sched, periods );
+
+  if ( pSummary != NULL )
+  {
+    pSummary->Periods     = run.Periods;
+    pSummary->IqErrRms    = ( run.Periods > 0 ) ?
+                            sqrt( run.SumEq / run.Periods ) : 0.0;
+    pSummary->IdErrRms    = ( run.Periods > 0 ) ?
+                            sqrt( run.SumEd / run.Periods ) : 0.0;
+    pSummary->IPeak       = sqrt( run.IPeak2 );
+    pSummary->WeFinal     = pEngine->Motor.Params.Pp * pEngine->MotorState.wm;
+    pSummary->ThetaErrMax = run.ThetaErr;
+    pSummary->Wthd        = ( pSpectrum != NULL && pSc->SpecF1 > 0.0 ) ?
+                            PWM_Spectrum_Wthd( pSpectrum, PWM_SPECTRUM_UV ) :
+                            0.0;
+  }
+  return ( 0 );
+}
+
+/***************  END OF FILE****/
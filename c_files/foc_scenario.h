@@ -0,0 +1,101 @@
+/**
+  ******************************************************************************
+  * @file    foc_scenario.h
+  * @brief   This file contains all definitions and functions prototypes for the
+  *          drive profile scenarios run by the standalone FOC simulation
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  * Scenario file, one item per line, '#' starts a comment:
+  *
+  *   key = value            configuration, see FOC_Scenario_Load()
+  *   point t iq id tload    profile point, references are interpolated
+  *                          linearly between points, held after the last
+  *
+  * spectrum_f1 = F1 (Hz) feeds every pwm period to the pwm_spectrum.h
+  * analyzer passed to FOC_Scenario_Run(), spectrum_harm and
+  * spectrum_cycles set the bins and the window length.
+  *
+  * timer_fclk = Fclk (Hz) quantizes the compare values to the counts of a
+  * center-aligned timer, timer_update = direct | preload (pwm_timer.h).
+  *
+  * mc_* keys set the Monte Carlo tolerance analysis of foc_mc.h (foc_sim
+  * -m): mc_trials, mc_threads, mc_vqd_max, mc_vbus_ripple, mc_ts_jitter,
+  * mc_maxmodule_tol, mc_angle_err; it uses Vbus, Ts, seed, sector and
+  * modulation of the same file.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FOC_SCENARIO_H
+#define __FOC_SCENARIO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include <stdint.h>
+#include "foc_engine.h"
+#include "pwm_spectrum.h"
+#include "foc_mc.h"
+
+#define FOC_SCENARIO_MAX_POINTS 256
+
+typedef struct
+{
+  double t;
+  double IqRef;
+  double IdRef;
+  double Tload;
+} FOC_Profile_Point_t;
+
+typedef struct
+{
+  FOC_Config_t        Cfg;
+  double              Tend;           /**< simulated time (s)              */
+  uint32_t            LogDecimation;  /**< log every n-th pwm period       */
+  double              SpecF1;         /**< analyzer fundamental (Hz)       */
+  uint32_t            SpecHarm;       /**< analyzer harmonics              */
+  uint32_t            SpecCycles;     /**< fundamental periods per window  */
+  FOC_MC_Config_t     Mc;             /**< Monte Carlo settings            */
+  uint32_t            NPoints;
+  FOC_Profile_Point_t Points[FOC_SCENARIO_MAX_POINTS];
+} FOC_Scenario_t;
+
+typedef struct
+{
+  uint64_t Periods;
+  double   IqErrRms;     /**< rms of IqRef - Iq (A)               */
+  double   IdErrRms;     /**< rms of IdRef - Id (A)               */
+  double   IPeak;        /**< largest phase current magnitude (A) */
+  double   WeFinal;      /**< final electrical speed (rad/s)      */
+  double   ThetaErrMax;  /**< largest |ThetaCtrl - Theta| (rad)   */
+  double   Wthd;         /**< line-line U-V WTHD, 0 without analyzer */
+} FOC_Summary_t;
+
+typedef void ( *FOC_Log_Fn )( void * pCtx, const FOC_Input_t * pIn,
+                              const FOC_Output_t * pOut );
+
+/* Exported functions ------------------------------------------------------- */
+
+void FOC_Scenario_Defaults( FOC_Scenario_t * pSc );
+int  FOC_Scenario_Load( const char * pPath, FOC_Scenario_t * pSc,
+                        char * pErr, size_t ErrLen );
+void FOC_Scenario_Input( const FOC_Scenario_t * pSc, double t,
+                         FOC_Input_t * pIn );
+int  FOC_Scenario_Run( const FOC_Scenario_t * pSc, FOC_Engine_t * pEngine,
+                       FOC_Log_Fn LogFn, void * pCtx,
+                       PWM_Spectrum_t * pSpectrum,
+                       FOC_Summary_t * pSummary );
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __FOC_SCENARIO_H */
+
+/* *****END OF FILE****/
@@ -0,0 +1,97 @@
+/**
+  ******************************************************************************
+  * @file    foc_sched.c
+  * @brief   This file provides the multi-rate loop of the standalone FOC
+  *          simulation: control at Ts, plant within the period, decimated
+  *          tasks
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * license info:
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "foc_sched.h"
+
+/**
+  * @brief  Empty schedule around an initialized engine
+  * @param  pSched schedule
+  * @param  pEngine engine, see FOC_Engine_Init()
+  * @param  InputFn references at the period start, NULL for all zero
+  * @param  pInputCtx passed to InputFn
+  */
+void FOC_Sched_Init( FOC_Sched_t * pSched, FOC_Engine_t * pEngine,
+                     FOC_Input_Fn InputFn, void * pInputCtx )
+{
+  memset( pSched, 0, sizeof( *pSched ) );
+  pSched->pEngine   = pEngine;
+  pSched->InputFn   = InputFn;
+  pSched->pInputCtx = pInputCtx;
+}
+
+/**
+  * @brief  Register a task run every Decimation pwm periods
+  * @retval 0 on success, -1 if the table is full or Decimation is 0
+  */
+int FOC_Sched_Add_Task( FOC_Sched_t * pSched, FOC_Task_Fn Fn, void * pCtx,
+                        uint32_t Decimation )
+{
+  FOC_Task_t * pTask;
+
+  if ( Fn == NULL || Decimation == 0 || pSched->NTasks >= FOC_SCHED_MAX_TASKS )
+  {
+    return ( -1 );
+  }
+  pTask = &pSched->Tasks[pSched->NTasks++];
+  pTask->Fn         = Fn;
+  pTask->pCtx       = pCtx;
+  pTask->Decimation = Decimation;
+  pTask->Count      = 0;
+  return ( 0 );
+}
+
+/**
+  * @brief  Run Periods pwm periods from the current engine time
+  * @param  pSched schedule
+  * @param  Periods number of pwm periods
+  */
+void FOC_Sched_Run( FOC_Sched_t * pSched, uint64_t Periods )
+{
+  FOC_Engine_t * pEngine = pSched->pEngine;
+  FOC_Input_t    in;
+  FOC_Output_t   out;
+  SVPWM_Timing_t tm;
+  uint64_t       k;
+  uint32_t       i;
+
+  memset( &in, 0, sizeof( in ) );
+
+  for ( k = 0; k < Periods; k++ )
+  {
+    if ( pSched->InputFn != NULL )
+    {
+      pSched->InputFn( pSched->pInputCtx, pEngine->t, &in );
+    }
+
+    FOC_Engine_Control( pEngine, &in, &out, &tm );
+    FOC_Engine_Plant( pEngine, &tm, in.Tload, &out );
+
+    for ( i = 0; i < pSched->NTasks; i++ )
+    {
+      FOC_Task_t * pTask = &pSched->Tasks[i];
+
+      if ( pTask->Count == 0 )
+      {
+        pTask->Fn( pTask->pCtx, &in, &out );
+        pTask->Count = pTask->Decimation;
+      }
+      pTask->Count--;
+    }
+  }
+}
+
+/***************  END OF FILE****/
@@ -0,0 +1,73 @@
+/**
+  ******************************************************************************
+  * @file    foc_sched.h
+  * @brief   This file contains all definitions and functions prototypes for the
+  *          multi-rate loop of the standalone FOC simulation
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  * Each pwm period Ts, in this order:
+  *
+  *   InputFn            references and load at the period start
+  *   FOC_Engine_Control current loop at Ts
+  *   FOC_Engine_Plant   plant over the period, Nsub fixed steps or the
+  *                      intervals between the switching edges (Cfg.PlantStep)
+  *   tasks              every Decimation-th period, first in period 0
+  *
+  * Tasks are registered up front into a fixed table, the loop itself does
+  * not allocate and does no I/O of its own.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FOC_SCHED_H
+#define __FOC_SCHED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "foc_engine.h"
+
+#define FOC_SCHED_MAX_TASKS 4
+
+typedef void ( *FOC_Input_Fn )( void * pCtx, double t, FOC_Input_t * pIn );
+typedef void ( *FOC_Task_Fn )( void * pCtx, const FOC_Input_t * pIn,
+                               const FOC_Output_t * pOut );
+
+typedef struct
+{
+  FOC_Task_Fn Fn;
+  void *      pCtx;
+  uint32_t    Decimation;  /**< run every n-th pwm period         */
+  uint32_t    Count;       /**< periods until the next run        */
+} FOC_Task_t;
+
+typedef struct
+{
+  FOC_Engine_t * pEngine;
+  FOC_Input_Fn   InputFn;
+  void *         pInputCtx;
+  FOC_Task_t     Tasks[FOC_SCHED_MAX_TASKS];
+  uint32_t       NTasks;
+} FOC_Sched_t;
+
+/* Exported functions ------------------------------------------------------- */
+
+void FOC_Sched_Init( FOC_Sched_t * pSched, FOC_Engine_t * pEngine,
+                     FOC_Input_Fn InputFn, void * pInputCtx );
+int  FOC_Sched_Add_Task( FOC_Sched_t * pSched, FOC_Task_Fn Fn, void * pCtx,
+                         uint32_t Decimation );
+void FOC_Sched_Run( FOC_Sched_t * pSched, uint64_t Periods );
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __FOC_SCHED_H */
+
+/* *****END OF FILE****/
@@ -0,0 +1,707 @@
+/*  File    : foc_sim.c
+ *  Abstract:
+ *
+ *  Command line front end of the standalone FOC simulation
+ *
+ *      foc_sim [-o log.csv] [-s spectrum.csv] [-c] [-q] scenario [scenario ...]
+ *      foc_sim -m [-o histogram.csv] [-q] scenario [scenario ...]
+ *      foc_sim -b samples
+ *      foc_sim -a samples
+ *      foc_sim -g check [vectors.bin]
+ *      foc_sim -g write vectors.bin
+ *
+ *  Runs every scenario file (see foc_scenario.h) from rest and prints one
+ *  summary line per scenario; -o writes the decimated signals of a single
+ *  scenario as CSV, -s the harmonic amplitudes of a single scenario with
+ *  spectrum_f1 set, -c prints the run-time counters of pwm_stats.h after
+ *  each summary line, -q drops the header line. Exit status is non-zero if
+ *  any scenario failed to load or run.
+ *
+ *  -m runs the Monte Carlo tolerance analysis of foc_mc.h with the mc_*
+ *  settings of each scenario instead and prints the phase voltage error
+ *  statistics; -o then writes the error histogram of a single scenario.
+ *
+ *  -b times the svpwm_batch.h kernels on random samples, in the variant
+ *  the CPU or SVPWM_ISA selects, next to the per-sample svpwm timing.
+ *  -a compares the float32 reverse Park + svpwm chain (svpwm_real.h)
+ *  with the double one on random samples: largest and rms errors, sector
+ *  disagreements and the batch throughput of both precisions, then the
+ *  sector search at -180 degrees, the three-level and six-phase batch
+ *  kernels against their svpwm_3l.h and svpwm_6ph.h timing in every
+ *  instruction set the CPU runs, and single-shunt phase shifting
+ *  (duties kept, no edge in a sample window); exit status non-zero if
+ *  any of those is wrong.
+ *  -g check runs every timing engine variant against the golden vectors
+ *  of svpwm_golden.h, from the frozen baseline timing or from a set
+ *  stored by -g write, and prints one line per variant; the exit status
+ *  is non-zero if any is out of tolerance.
+ *
+ *  build (no MATLAB needed):
+ *      gcc -O2 -o foc_sim foc_sim.c foc_scenario.c foc_sched.c foc_engine.c
+ *          foc_mc.c svpwm_core.c svpwm_batch.c svpwm_real.c svpwm_golden.c
+ *          svpwm_3l.c svpwm_6ph.c shunt_sampling.c pwm_spectrum.c pwm_timer.c pwm_stats.c pmsm_model.c
+ *          luenberger_obs.c pi_regulator.c circle_limitation.c mc_math.c
+ *          -lm -lpthread
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "foc_scenario.h"
+#include "shunt_sampling.h"
+#include "svpwm_3l.h"
+#include "svpwm_6ph.h"
+#include "svpwm_batch.h"
+#include "svpwm_golden.h"
+#include "svpwm_real.h"
+
+#define PI 3.14159265358979323846
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: foc_sim [-o log.csv] [-s spectrum.csv] [-c] [-q] "
+                    "scenario [scenario ...]\n"
+                    "       foc_sim -m [-o histogram.csv] [-q] "
+                    "scenario [scenario ...]\n"
+                    "       foc_sim -b samples\n"
+                    "       foc_sim -a samples\n"
+                    "       foc_sim -g check [vectors.bin]\n"
+                    "       foc_sim -g write vectors.bin\n");
+}
+
+static void log_csv(void *pCtx, const FOC_Input_t *pIn, const FOC_Output_t *pOut)
+{
+    fprintf((FILE *)pCtx,
+            "%.9g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,"
+            "%.6g,%.6g,%.6g,%.6g,%d,%.9g,%.6g,%d\n",
+            pOut->t, pIn->IqRef, pIn->IdRef, pIn->Tload,
+            pOut->Iq, pOut->Id, pOut->Vq, pOut->Vd,
+            pOut->Ia, pOut->Ib, pOut->Ic,
+            pOut->We, pOut->Theta, pOut->ThetaCtrl, pOut->Te, pOut->Sector, pOut->Tk,
+            pOut->Cmv, pOut->Switchings);
+}
+
+/* h, frequency and peak amplitudes of U, V, W and U-V per harmonic */
+static int write_spectrum(const char *path, const PWM_Spectrum_t *pSpec)
+{
+    FILE    *fp = fopen(path, "w");
+    uint32_t h;
+
+    if (fp == NULL) {
+        return -1;
+    }
+    fprintf(fp, "h,f,u,v,w,uv\n");
+    for (h = 1; h <= pSpec->NHarm; h++) {
+        fprintf(fp, "%u,%.9g,%.6g,%.6g,%.6g,%.6g\n", (unsigned)h,
+                h * pSpec->F1,
+                PWM_Spectrum_Magnitude(pSpec, PWM_SPECTRUM_U, h),
+                PWM_Spectrum_Magnitude(pSpec, PWM_SPECTRUM_V, h),
+                PWM_Spectrum_Magnitude(pSpec, PWM_SPECTRUM_W, h),
+                PWM_Spectrum_Magnitude(pSpec, PWM_SPECTRUM_UV, h));
+    }
+    fclose(fp);
+    return 0;
+}
+
+/* Monte Carlo run of one scenario, summary line and histogram */
+static int run_mc(const char *name, const FOC_Scenario_t *pSc, FILE *fp)
+{
+    FOC_MC_Stats_t *pSt = (FOC_MC_Stats_t *)malloc(sizeof(FOC_MC_Stats_t));
+    struct timespec t0, t1;
+    double          mean, wall;
+    uint32_t        b;
+
+    if (pSt == NULL) {
+        fprintf(stderr, "foc_sim: out of memory\n");
+        return 1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    if (FOC_MC_Run(&pSc->Cfg, &pSc->Mc, pSt) != 0) {
+        fprintf(stderr, "foc_sim: %s: invalid Monte Carlo configuration\n",
+                name);
+        free(pSt);
+        return 1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    wall = (t1.tv_sec - t0.tv_sec) + 1e-9 * (t1.tv_nsec - t0.tv_nsec);
+
+    mean = pSt->Sum / pSt->Count;
+    printf("%s %llu %u %.6g %.6g %.6g %.6g %.6g %.6g %.6g %.6g %llu %.3f\n",
+           name, (unsigned long long)pSt->Count, (unsigned)pSc->Mc.Threads,
+           mean, sqrt(pSt->SumSq / pSt->Count),
+           FOC_MC_Percentile(pSt, 0.5), FOC_MC_Percentile(pSt, 0.9),
+           FOC_MC_Percentile(pSt, 0.99), FOC_MC_Percentile(pSt, 0.999),
+           FOC_MC_Percentile(pSt, 0.9999), pSt->Max,
+           (unsigned long long)pSt->MaxTrial, wall);
+    if (fp != NULL) {
+        fprintf(fp, "upper_v,count\n");
+        for (b = 0; b < FOC_MC_BINS; b++) {
+            fprintf(fp, "%.6g,%llu\n", FOC_MC_Bin_Edge(b),
+                    (unsigned long long)pSt->Hist[b]);
+        }
+    }
+    free(pSt);
+    return 0;
+}
+
+/* ns per sample of the batch kernels and of SVPWM_Calc_Timing() */
+static int bench_batch(uint32_t n)
+{
+    double   *pVa = (double *)malloc(5 * n * sizeof(double));
+    int16_t  *pQ  = (int16_t *)malloc(2 * n * sizeof(int16_t));
+    uint64_t  key = RNG_Key(1, 0);
+    double    t_mm, t_cl, t_ref;
+    volatile double sink = 0.0;
+    clock_t   c0;
+    uint32_t  i;
+    int       r;
+
+    if (pVa == NULL || pQ == NULL) {
+        free(pVa);
+        free(pQ);
+        fprintf(stderr, "foc_sim: out of memory\n");
+        return 1;
+    }
+    for (i = 0; i < n; i++) {
+        pVa[i]         = 2.4 * RNG_Uniform(key, 4 * (uint64_t)i) - 1.2;
+        pVa[n + i]     = 2.4 * RNG_Uniform(key, 4 * (uint64_t)i + 1) - 1.2;
+        pQ[i]          = (int16_t)(RNG_U64(key, 4 * (uint64_t)i + 2) >> 48);
+        pQ[n + i]      = (int16_t)(RNG_U64(key, 4 * (uint64_t)i + 3) >> 48);
+    }
+
+    /* best of a few runs, the first one also touches the pages */
+    t_mm = t_cl = t_ref = 1e30;
+    for (r = 0; r < 5; r++) {
+        double t;
+
+        c0 = clock();
+        SVPWM_MinMax_Batch(pVa, pVa + n, n, pVa + 2 * n, pVa + 3 * n,
+                           pVa + 4 * n);
+        t = (double)(clock() - c0) / CLOCKS_PER_SEC;
+        t_mm = (t < t_mm) ? t : t_mm;
+
+        c0 = clock();
+        Circle_Limitation_Batch(&CircleLimitationM1, pQ, pQ + n, n);
+        t = (double)(clock() - c0) / CLOCKS_PER_SEC;
+        t_cl = (t < t_cl) ? t : t_cl;
+
+        c0 = clock();
+        for (i = 0; i < n; i++) {
+            SVPWM_Timing_t tm;
+
+            SVPWM_Calc_Timing(pVa[i], pVa[n + i], 1.0, &tm);
+            sink += tm.Cmp[0];
+        }
+        t = (double)(clock() - c0) / CLOCKS_PER_SEC;
+        t_ref = (t < t_ref) ? t : t_ref;
+    }
+
+    printf("# isa minmax_ns circle_limitation_ns calc_timing_ns\n");
+    printf("%s %.3f %.3f %.3f\n", SVPWM_Batch_Isa_Name(SVPWM_Batch_Isa()),
+           1e9 * t_mm / n, 1e9 * t_cl / n, 1e9 * t_ref / n);
+    free(pVa);
+    free(pQ);
+    return 0;
+}
+
+/* Largest difference of the three-level and six-phase batch kernels from
+   SVPWM_3L_Calc_Timing() Base + Cmp/Ts and SVPWM_6Ph_Calc_Timing() min/max
+   Cmp/Ts, on n random samples, over every instruction set the CPU runs;
+   pE6 gets the six-phase one, the three-level one is returned. */
+static double batch_kernel_error(uint32_t n, double *pE6)
+{
+    double     *pV  = (double *)malloc(10 * (size_t)n * sizeof(double));
+    double     *pO  = pV + 4 * (size_t)n;   // 3L: 3n, 6ph: 6n
+    uint64_t    key = RNG_Key(1, 2);
+    SVPWM_Isa_t isa0 = SVPWM_Batch_Isa();
+    double      e3 = 0.0;
+    uint32_t    i;
+    int         isa, k;
+
+    *pE6 = 0.0;
+    if (pV == NULL) {
+        return INFINITY;
+    }
+    /* (alpha, beta) up to 1.1 * sqrt(3)/2, (x, y) up to 0.1 */
+    for (i = 0; i < n; i++) {
+        double r  = 0.95262794416288251 * sqrt(RNG_Uniform(key, 4 * (uint64_t)i));
+        double ph = 2.0 * PI * RNG_Uniform(key, 4 * (uint64_t)i + 1);
+        double rx = 0.1 * RNG_Uniform(key, 4 * (uint64_t)i + 2);
+        double px = 2.0 * PI * RNG_Uniform(key, 4 * (uint64_t)i + 3);
+
+        pV[i]         = r * cos(ph);
+        pV[n + i]     = r * sin(ph);
+        pV[2 * n + i] = rx * cos(px);
+        pV[3 * n + i] = rx * sin(px);
+    }
+    for (isa = 0; isa < SVPWM_ISA_NUM; isa++) {
+        if ((int)SVPWM_Batch_Select(SVPWM_Batch_Isa_Name((SVPWM_Isa_t)isa)) != isa) {
+            break;   /* not supported by this CPU */
+        }
+        SVPWM_3L_Batch(pV, pV + n, n, pO, pO + n, pO + 2 * n);
+        for (i = 0; i < n; i++) {
+            SVPWM_3L_Timing_t tm;
+
+            SVPWM_3L_Calc_Timing(pV[i], pV[n + i], 1.0, &tm);
+            for (k = 0; k < 3; k++) {
+                double d = fabs(pO[k * n + i] - (tm.Base[k] + tm.Cmp[k]));
+
+                e3 = (d > e3) ? d : e3;
+            }
+        }
+        SVPWM_6Ph_Batch(pV, pV + n, pV + 2 * n, pV + 3 * n, n, pO);
+        for (i = 0; i < n; i++) {
+            SVPWM_6Ph_Timing_t tm;
+            int16_t            sector = 0;
+
+            SVPWM_6Ph_Calc_Timing(SVPWM_ENGINE_MINMAX, pV[i], pV[n + i],
+                                  pV[2 * n + i], pV[3 * n + i], 1.0,
+                                  &sector, &tm);
+            for (k = 0; k < 6; k++) {
+                double d = fabs(pO[k * n + i] - tm.Set[k / 3].Cmp[k % 3]);
+
+                *pE6 = (d > *pE6) ? d : *pE6;
+            }
+        }
+    }
+    SVPWM_Batch_Select(SVPWM_Batch_Isa_Name(isa0));
+    free(pV);
+    return e3;
+}
+
+/* Single-shunt phase shifting on n random vectors, Ts = 100 us: the
+   largest duty change of any phase (/Ts, must stay 0 to rounding) and,
+   pBad, periods not flagged short with a phase edge within Trise before
+   or Tsample after a sample time; pShort gets the short periods without
+   and with the shift. */
+static double shunt_shift_error(uint32_t n, uint32_t *pBad, uint32_t *pShort)
+{
+    const double   Ts  = 100e-6;
+    uint64_t       key = RNG_Key(1, 3);
+    Shunt_Config_t cfg;
+    double         e = 0.0;
+    uint32_t       i;
+    int            j, k, x;
+
+    cfg.Topology = SHUNT_SINGLE;
+    cfg.Trise    = 1.5e-6;
+    cfg.Tsample  = 0.5e-6;
+    *pBad     = 0;
+    pShort[0] = 0;
+    pShort[1] = 0;
+    for (i = 0; i < n; i++) {
+        double           r  = 0.86602540378443865 * RNG_Uniform(key, 2 * (uint64_t)i);
+        double           ph = 2.0 * PI * RNG_Uniform(key, 2 * (uint64_t)i + 1);
+        SVPWM_Timing_t   tm;
+        Shunt_Sampling_t smp;
+        int              bad = 0;
+
+        SVPWM_Calc_Timing(r * cos(ph), r * sin(ph), Ts, &tm);
+        cfg.Shift = 0;
+        Shunt_Sampling(&cfg, &tm, &smp);
+        pShort[0] += ((smp.Flags & SHUNT_FLAG_SHORT) != 0);
+        cfg.Shift = 1;
+        Shunt_Sampling(&cfg, &tm, &smp);
+        pShort[1] += ((smp.Flags & SHUNT_FLAG_SHORT) != 0);
+        for (x = 0; x < 3; x++) {
+            double w = smp.Edge[1][x] - smp.Edge[0][x];
+            double d = fabs((smp.Inv[x] ? w : Ts - w) / Ts
+                            - SVPWM_Duty(tm.Cmp[x], Ts));
+
+            e = (d > e) ? d : e;
+        }
+        if (smp.Flags & SHUNT_FLAG_SHORT) {
+            continue;
+        }
+        for (j = 0; j < 2; j++) {
+            for (k = 0; k < 2; k++) {
+                for (x = 0; x < 3; x++) {
+                    double t = smp.Edge[k][x];
+
+                    bad |= (t > 0.0 && t < Ts &&
+                            t > smp.t[j] - cfg.Trise + 1e-12 &&
+                            t < smp.t[j] + cfg.Tsample - 1e-12);
+                }
+            }
+        }
+        *pBad += (uint32_t)bad;
+    }
+    return e;
+}
+
+/* Compare values at -180 degrees, where atan2 gives -pi: Va < 0 with
+   Vb = -0 or a negative Vb far below |Va|. The sector search of the
+   full engine and of both svpwm_real.h instances against the min/max
+   engine, which has no angle; pE32 gets the float32 error. */
+static double pi_boundary_error(double *pE32)
+{
+    static const double vb[4] = { -0.0, -1e-300, -1e-20, 0.0 };
+    double e = 0.0;
+    int    m, j, k;
+
+    *pE32 = 0.0;
+    for (m = 1; m <= 20; m++) {
+        for (j = 0; j < 4; j++) {
+            double             va = -m / 16.0;
+            double             b  = vb[j] * m;
+            SVPWM_Timing_t     tm, ref;
+            SVPWM_Timing_F32_t tm32;
+            SVPWM_Timing_F64_t tm64;
+
+            SVPWM_Calc_Timing_MinMax(va, b, 1.0, &ref);
+            SVPWM_Calc_Timing(va, b, 1.0, &tm);
+            SVPWM_Calc_Timing_F64(va, b, 1.0, &tm64);
+            SVPWM_Calc_Timing_F32((float)va, (float)b, 1.0f, &tm32);
+            for (k = 0; k < 3; k++) {
+                double d = fabs(tm.Cmp[k] - ref.Cmp[k]);
+
+                e = (d > e) ? d : e;
+                d = fabs(tm64.Cmp[k] - ref.Cmp[k]);
+                e = (d > e) ? d : e;
+                d = fabs(tm32.Cmp[k] - ref.Cmp[k]);
+                *pE32 = (d > *pE32) ? d : *pE32;
+            }
+        }
+    }
+    return e;
+}
+
+/* float32 against double: reverse Park, svpwm compare values, batch */
+static int accuracy_report(uint32_t n)
+{
+    float    *pF  = (float *)malloc(6 * n * sizeof(float));
+    double   *pD  = (double *)malloc(6 * n * sizeof(double));
+    uint64_t  key = RNG_Key(1, 1);
+    double    e_ab = 0.0, s_ab = 0.0;   // alpha, beta, normalized
+    double    e_cmp = 0.0, s_cmp = 0.0; // compare values / Ts
+    double    e_f64 = 0.0;              // F64 instance vs svpwm_core.c
+    double    e_bat = 0.0;              // batch duties
+    double    t32, t64;
+    double    e_pi, e_pi32;             // -180 degrees, see pi_boundary_error
+    double    e_3l, e_6ph;              // batch kernels, batch_kernel_error
+    double    e_sh;                     // shunt shift duties
+    uint32_t  sh_bad, sh_short[2];
+    uint32_t  sect = 0;
+    uint32_t  i;
+    int       k;
+    clock_t   c0;
+
+    if (pF == NULL || pD == NULL) {
+        free(pF);
+        free(pD);
+        fprintf(stderr, "foc_sim: out of memory\n");
+        return 1;
+    }
+
+    /* |(q, d)| up to 1.1 * sqrt(3)/2: linear range and some overmodulation */
+    for (i = 0; i < n; i++) {
+        double r  = 0.95262794416288251 * sqrt(RNG_Uniform(key, 3 * (uint64_t)i));
+        double ph = 2.0 * PI * RNG_Uniform(key, 3 * (uint64_t)i + 1);
+
+        pD[i]         = r * cos(ph);
+        pD[n + i]     = r * sin(ph);
+        pD[2 * n + i] = PI * (2.0 * RNG_Uniform(key, 3 * (uint64_t)i + 2) - 1.0);
+        pF[i]         = (float)pD[i];
+        pF[n + i]     = (float)pD[n + i];
+        pF[2 * n + i] = (float)pD[2 * n + i];
+    }
+
+    for (i = 0; i < n; i++) {
+        qd_real_t          qd;
+        alphabeta_t        ab;
+        float              a32, b32;
+        SVPWM_Timing_t     tm;
+        SVPWM_Timing_F32_t tm32;
+        SVPWM_Timing_F64_t tm64;
+        double             e;
+
+        /* same (float representable) inputs for both precisions */
+        qd.q = pF[i];
+        qd.d = pF[n + i];
+        ab   = MCM_Rev_Park_Transform(qd, MCM_Trig_Functions(pF[2 * n + i]));
+        MCM_Rev_Park_F32(pF[i], pF[n + i], pF[2 * n + i], &a32, &b32);
+        e = fabs(a32 - ab.alpha) + fabs(b32 - ab.beta);
+        e_ab  = (e > e_ab) ? e : e_ab;
+        s_ab += e * e;
+
+        SVPWM_Calc_Timing(ab.alpha, ab.beta, 1.0, &tm);
+        SVPWM_Calc_Timing_F64(ab.alpha, ab.beta, 1.0, &tm64);
+        SVPWM_Calc_Timing_F32(a32, b32, 1.0f, &tm32);
+        sect += (tm32.Sector != tm.Sector);
+        for (k = 0; k < 3; k++) {
+            e = fabs(tm32.Cmp[k] - tm.Cmp[k]);
+            e_cmp  = (e > e_cmp) ? e : e_cmp;
+            s_cmp += e * e;
+            e = fabs(tm64.Cmp[k] - tm.Cmp[k]);
+            e_f64  = (e > e_f64) ? e : e_f64;
+        }
+    }
+
+    c0 = clock();
+    SVPWM_Rev_Park_Batch_F32(pF, pF + n, pF + 2 * n, 1.0f, n,
+                             pF + 3 * n, pF + 4 * n, pF + 5 * n);
+    t32 = (double)(clock() - c0) / CLOCKS_PER_SEC;
+    for (i = 0; i < n; i++) {
+        pD[i]         = pF[i];
+        pD[n + i]     = pF[n + i];
+        pD[2 * n + i] = pF[2 * n + i];
+    }
+    c0 = clock();
+    SVPWM_Rev_Park_Batch_F64(pD, pD + n, pD + 2 * n, 1.0, n,
+                             pD + 3 * n, pD + 4 * n, pD + 5 * n);
+    t64 = (double)(clock() - c0) / CLOCKS_PER_SEC;
+    for (i = 3 * n; i < 6 * n; i++) {
+        double e = fabs(pF[i] - pD[i]);
+
+        e_bat = (e > e_bat) ? e : e_bat;
+    }
+
+    printf("# samples %u, float32 vs double, errors normalized "
+           "(1.0 = 2/3 Vbus, duty 0..1)\n", (unsigned)n);
+    printf("rev_park_max %.3g\nrev_park_rms %.3g\n", e_ab, sqrt(s_ab / n));
+    printf("duty_max %.3g\nduty_rms %.3g\n", e_cmp, sqrt(s_cmp / (3.0 * n)));
+    printf("sector_mismatch %u\n", (unsigned)sect);
+    printf("batch_duty_max %.3g\n", e_bat);
+    printf("f64_vs_core_max %.3g\n", e_f64);
+    printf("batch_ns_f32 %.3f\nbatch_ns_f64 %.3f\n",
+           1e9 * t32 / n, 1e9 * t64 / n);
+    e_pi = pi_boundary_error(&e_pi32);
+    printf("pi_boundary_max %.3g\npi_boundary_max_f32 %.3g\n", e_pi, e_pi32);
+    e_3l = batch_kernel_error(n, &e_6ph);
+    printf("batch_3l_vs_core_max %.3g\nbatch_6ph_vs_core_max %.3g\n",
+           e_3l, e_6ph);
+    e_sh = shunt_shift_error(n, &sh_bad, sh_short);
+    printf("shunt_shift_duty_max %.3g\nshunt_window_violations %u\n"
+           "shunt_short %u\nshunt_short_shifted %u\n", e_sh,
+           (unsigned)sh_bad, (unsigned)sh_short[0], (unsigned)sh_short[1]);
+    free(pF);
+    free(pD);
+    return (e_pi > 1e-12 || e_pi32 > 1e-6 || !(e_3l <= 1e-14) ||
+            !(e_6ph <= 1e-14) || !(e_sh <= 1e-12) || sh_bad != 0);
+}
+
+/* -g: svpwm golden vectors, written or checked; check without a path
+   uses the frozen reference of svpwm_golden.c directly */
+static int golden_vectors(const char *mode, const char *path)
+{
+    SVPWM_Golden_t        *pVec = NULL;
+    SVPWM_Golden_Result_t  res[16];
+    uint32_t               n;
+    uint32_t               nRes;
+    uint32_t               r;
+    uint32_t               nPi;
+    double                 Ts = 1.0;
+    int                    failed = 0;
+    clock_t                c0 = clock();
+
+    if (strcmp(mode, "write") == 0 || path == NULL) {
+        n    = SVPWM_Golden_Inputs(NULL, 0);
+        pVec = (SVPWM_Golden_t *)malloc(n * sizeof(SVPWM_Golden_t));
+        if (pVec == NULL) {
+            fprintf(stderr, "foc_sim: out of memory\n");
+            return 1;
+        }
+        SVPWM_Golden_Inputs(pVec, n);
+        SVPWM_Golden_Reference(pVec, n, Ts);
+    }
+    if (strcmp(mode, "write") == 0 && path != NULL) {
+        if (SVPWM_Golden_Write(path, pVec, n, Ts) != 0) {
+            fprintf(stderr, "foc_sim: cannot write %s\n", path);
+            free(pVec);
+            return 1;
+        }
+        printf("# %u vectors written to %s\n", (unsigned)n, path);
+        free(pVec);
+        return 0;
+    }
+    if (strcmp(mode, "check") != 0) {
+        free(pVec);
+        usage();
+        return 2;
+    }
+    if (path != NULL && SVPWM_Golden_Read(path, &pVec, &n, &Ts) != 0) {
+        fprintf(stderr, "foc_sim: %s: missing or not a golden vector file\n",
+                path);
+        return 1;
+    }
+
+    nRes = SVPWM_Golden_Check(pVec, n, Ts, res, sizeof(res) / sizeof(res[0]));
+    for (r = 0, nPi = 0; r < n; r++) {
+        nPi += ((pVec[r].Flags & SVPWM_GOLDEN_PI) != 0);
+    }
+    printf("# %s, %u vectors, %u at -180 deg (sector 4, was 1)\n",
+           (path != NULL) ? path : "frozen reference", (unsigned)n,
+           (unsigned)nPi);
+    printf("# variant vectors failed max_abs max_ulp first_failure\n");
+    for (r = 0; r < nRes; r++) {
+        printf("%-14s %7u %6u %9.3g %7llu", res[r].Name,
+               (unsigned)res[r].Vectors, (unsigned)res[r].Failed,
+               res[r].MaxAbs, (unsigned long long)res[r].MaxUlp);
+        if (res[r].Failed != 0) {
+            const SVPWM_Golden_t *v = &pVec[res[r].First];
+
+            printf(" #%u Va %.17g Vb %.17g %s %.17g expected %.17g",
+                   (unsigned)res[r].First, v->Va, v->Vb, res[r].Output,
+                   res[r].Got, res[r].Expected);
+            failed = 1;
+        }
+        printf("\n");
+    }
+    printf("# %s, %.2f s\n", failed ? "FAILED" : "passed",
+           (double)(clock() - c0) / CLOCKS_PER_SEC);
+    free(pVec);
+    return failed;
+}
+
+int main(int argc, char **argv)
+{
+    const char     *log_path = NULL;
+    const char     *spec_path = NULL;
+    int             quiet = 0;
+    int             counters = 0;
+    int             mc = 0;
+    int             failed = 0;
+    int             i;
+    FOC_Scenario_t *pSc;
+    FOC_Engine_t   *pEngine;
+    PWM_Spectrum_t *pSpec;
+
+    if (argc == 3 && strcmp(argv[1], "-b") == 0) {
+        long n = strtol(argv[2], NULL, 10);
+
+        if (n <= 0) {
+            usage();
+            return 2;
+        }
+        return bench_batch((uint32_t)n);
+    }
+    if (argc == 3 && strcmp(argv[1], "-a") == 0) {
+        long n = strtol(argv[2], NULL, 10);
+
+        if (n <= 0) {
+            usage();
+            return 2;
+        }
+        return accuracy_report((uint32_t)n);
+    }
+    if ((argc == 3 || argc == 4) && strcmp(argv[1], "-g") == 0) {
+        return golden_vectors(argv[2], (argc == 4) ? argv[3] : NULL);
+    }
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            log_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            spec_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-q") == 0) {
+            quiet = 1;
+        }
+        else if (strcmp(argv[i], "-c") == 0) {
+            counters = 1;
+        }
+        else if (strcmp(argv[i], "-m") == 0) {
+            mc = 1;
+        }
+        else {
+            usage();
+            return 2;
+        }
+    }
+    if (i >= argc ||
+        ((log_path != NULL || spec_path != NULL) && argc - i != 1) ||
+        (mc && (spec_path != NULL || counters))) {
+        usage();
+        return 2;
+    }
+
+    /* one scenario and engine, reused for every file */
+    pSc     = (FOC_Scenario_t *)malloc(sizeof(FOC_Scenario_t));
+    pEngine = (FOC_Engine_t *)malloc(sizeof(FOC_Engine_t));
+    pSpec   = (PWM_Spectrum_t *)malloc(sizeof(PWM_Spectrum_t));
+    if (pSc == NULL || pEngine == NULL || pSpec == NULL) {
+        fprintf(stderr, "foc_sim: out of memory\n");
+        return 1;
+    }
+
+    if (!quiet && mc) {
+        printf("# scenario trials threads mean_v rms_v p50_v p90_v p99_v "
+               "p99.9_v p99.99_v max_v max_trial wall_s\n");
+    }
+    else if (!quiet) {
+        printf("# scenario periods iq_err_rms id_err_rms i_peak we_final "
+               "theta_err_max wthd wall_s x_realtime\n");
+    }
+
+    for (; i < argc; i++) {
+        char          err[256];
+        FILE         *fp = NULL;
+        FOC_Summary_t sum;
+        clock_t       c0;
+        double        wall;
+
+        if (FOC_Scenario_Load(argv[i], pSc, err, sizeof(err)) != 0) {
+            fprintf(stderr, "foc_sim: %s\n", err);
+            failed = 1;
+            continue;
+        }
+        if (log_path != NULL) {
+            fp = fopen(log_path, "w");
+            if (fp == NULL) {
+                fprintf(stderr, "foc_sim: %s: cannot open\n", log_path);
+                failed = 1;
+                continue;
+            }
+            if (!mc) {
+                fprintf(fp, "t,iq_ref,id_ref,tload,iq,id,vq,vd,ia,ib,ic,"
+                            "we,theta,theta_ctrl,te,sector,tk,cmv,sw\n");
+            }
+        }
+        if (mc) {
+            failed |= run_mc(argv[i], pSc, fp);
+            if (fp != NULL) {
+                fclose(fp);
+            }
+            continue;
+        }
+
+        c0 = clock();
+        if (FOC_Scenario_Run(pSc, pEngine, (fp != NULL) ? log_csv : NULL,
+                             fp, pSpec, &sum) != 0) {
+            fprintf(stderr, "foc_sim: %s: invalid configuration\n", argv[i]);
+            failed = 1;
+        }
+        else {
+            wall = (double)(clock() - c0) / CLOCKS_PER_SEC;
+            printf("%s %llu %.6g %.6g %.6g %.6g %.6g %.6g %.3f %.1f\n",
+                   argv[i], (unsigned long long)sum.Periods, sum.IqErrRms,
+                   sum.IdErrRms, sum.IPeak, sum.WeFinal, sum.ThetaErrMax,
+                   sum.Wthd, wall, (wall > 0.0) ? pSc->Tend / wall : 0.0);
+            if (counters) {
+                PWM_Stats_Dump(FOC_Engine_Stats(pEngine), argv[i], printf);
+            }
+            if (spec_path != NULL) {
+                if (pSc->SpecF1 <= 0.0) {
+                    fprintf(stderr, "foc_sim: %s: spectrum_f1 not set\n",
+                            argv[i]);
+                    failed = 1;
+                }
+                else if (write_spectrum(spec_path, pSpec) != 0) {
+                    fprintf(stderr, "foc_sim: %s: cannot open\n", spec_path);
+                    failed = 1;
+                }
+            }
+        }
+        if (fp != NULL) {
+            fclose(fp);
+        }
+    }
+
+    free(pSc);
+    free(pEngine);
+    free(pSpec);
+    return failed;
+}
@@ -0,0 +1,171 @@
+/**
+  ******************************************************************************
+  * @file    luenberger_obs.c
+  * @brief   This file provides the discrete time Luenberger back-EMF and
+  *          angle/speed observer used by the LuenbergerObs S-function
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * license info:
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include "luenberger_obs.h"
+
+#define PI      3.14159265358979323846
+#define TWO_PI  6.28318530717958647693
+
+/* back-EMF magnitude below which the angle error is not normalized */
+#define EMF_MIN 1.0e-9
+
+/**
+  * @brief  Discretize the model and place the observer poles
+  * @param  pGains gains, written
+  * @param  Rs stator resistance (ohm)
+  * @param  Ls stator inductance (H), (Ld + Lq)/2 for salient motors
+  * @param  Ts sample time (s)
+  * @param  wo back-EMF observer bandwidth (rad/s)
+  * @param  wpll angle/speed observer bandwidth (rad/s)
+  * @retval 0 on success, -1 if a parameter is out of range
+  */
+int LUENBERGER_Init_Gains( LuenbergerObs_Gains_t * pGains, double Rs,
+                           double Ls, double Ts, double wo, double wpll )
+{
+  double a;
+  double g;
+  double zo;
+  double zp;
+
+  if ( Ls <= 0.0 || Ts <= 0.0 || Rs < 0.0 || wo <= 0.0 || wpll <= 0.0 )
+  {
+    return ( -1 );
+  }
+
+  /* zero order hold: i[k+1] = a*i + g*(v - e) */
+  a = exp( -Rs * Ts / Ls );
+  g = ( Rs > 0.0 ) ? ( 1.0 - a ) / Rs : Ts / Ls;
+
+  /* z^2 - (a - L1 + 1) z + (a - L1) - g L2 = (z - zo)^2 */
+  zo = exp( -wo * Ts );
+  pGains->L1    = a + 1.0 - 2.0 * zo;
+  pGains->L2    = ( a - pGains->L1 - zo * zo ) / g;
+  pGains->Phi11 = a - pGains->L1;
+  pGains->Phi12 = -g;
+  pGains->G     = g;
+  pGains->Zo    = zo;
+
+  /* z^2 - (2 - K1) z + (1 - K1) + Ts K2 = (z - zp)^2 */
+  zp = exp( -wpll * Ts );
+  pGains->K1 = 2.0 - 2.0 * zp;
+  pGains->K2 = ( zp - 1.0 ) * ( zp - 1.0 ) / Ts;
+  pGains->Ts = Ts;
+
+  return ( 0 );
+}
+
+/**
+  * @brief  Zero all estimates
+  */
+void LUENBERGER_Reset( LuenbergerObs_State_t * pState )
+{
+  pState->Ialpha = 0.0;
+  pState->Ibeta  = 0.0;
+  pState->Ealpha = 0.0;
+  pState->Ebeta  = 0.0;
+  pState->Phase  = 0.0;
+  pState->Theta  = 0.0;
+  pState->Omega  = 0.0;
+}
+
+/**
+  * @brief  One observer update with the voltage applied and the current
+  *         measured during the last sample
+  * @param  pGains gains from LUENBERGER_Init_Gains()
+  * @param  pState estimates, updated in place
+  * @param  Valphabeta applied stator voltage (V)
+  * @param  Ialphabeta measured stator current (A)
+  */
+void LUENBERGER_Step( const LuenbergerObs_Gains_t * pGains,
+                      LuenbergerObs_State_t * pState,
+                      alphabeta_t Valphabeta, alphabeta_t Ialphabeta )
+{
+  Trig_Components Trig = MCM_Trig_Functions( pState->Phase );
+  double emf;
+  double err;
+  double ea;
+  double eb;
+  double theta;
+  double wTs;
+
+  /* angle error from the back-EMF: -(ea*sin + eb*cos) = E*sin(theta - est) */
+  emf = sqrt( pState->Ealpha * pState->Ealpha + pState->Ebeta * pState->Ebeta );
+  err = -( pState->Ealpha * Trig.hSin + pState->Ebeta * Trig.hCos )
+        / ( ( emf > EMF_MIN ) ? emf : EMF_MIN );
+  if ( pState->Omega < 0.0 )
+  {
+    err = -err;
+  }
+
+  /* back-EMF observer, alpha and beta axes */
+  ea = pState->Ealpha;
+  eb = pState->Ebeta;
+  pState->Ealpha = ea + pGains->L2 * ( Ialphabeta.alpha - pState->Ialpha );
+  pState->Ebeta  = eb + pGains->L2 * ( Ialphabeta.beta - pState->Ibeta );
+  pState->Ialpha = pGains->Phi11 * pState->Ialpha + pGains->Phi12 * ea
+                 + pGains->G * Valphabeta.alpha + pGains->L1 * Ialphabeta.alpha;
+  pState->Ibeta  = pGains->Phi11 * pState->Ibeta + pGains->Phi12 * eb
+                 + pGains->G * Valphabeta.beta + pGains->L1 * Ialphabeta.beta;
+
+  /* angle/speed observer */
+  theta          = pState->Phase + pGains->Ts * pState->Omega + pGains->K1 * err;
+  pState->Omega += pGains->K2 * err;
+  if ( theta >= PI )
+  {
+    theta -= TWO_PI;
+  }
+  else if ( theta < -PI )
+  {
+    theta += TWO_PI;
+  }
+  pState->Phase = theta;
+
+  /* the back-EMF estimate lags the true one by the phase of
+   * ((1 - zo)/(z - zo))^2 at z = exp(j*omega*Ts); add it back, less half
+   * a sample since the zero order hold model sees the mean EMF over Ts */
+  wTs   = pState->Omega * pGains->Ts;
+  theta = theta + 2.0 * atan2( sin( wTs ), cos( wTs ) - pGains->Zo ) - 0.5 * wTs;
+  if ( theta >= PI )
+  {
+    theta -= TWO_PI;
+  }
+  else if ( theta < -PI )
+  {
+    theta += TWO_PI;
+  }
+  pState->Theta = theta;
+}
+
+/**
+  * @brief  Advance n independent observers, e.g. one per parameter set
+  * @param  pHandles n observers with their own gains
+  * @param  pV applied voltages, n
+  * @param  pI measured currents, n
+  * @param  n number of observers
+  */
+void LUENBERGER_Step_Batch( LuenbergerObs_Handle_t * pHandles,
+                            const alphabeta_t * pV, const alphabeta_t * pI,
+                            uint32_t n )
+{
+  uint32_t i;
+
+  for ( i = 0; i < n; i++ )
+  {
+    LUENBERGER_Step( &pHandles[i].Gains, &pHandles[i].State, pV[i], pI[i] );
+  }
+}
+
+/***************  END OF FILE****/
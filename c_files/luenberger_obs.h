@@ -0,0 +1,88 @@
+/**
+  ******************************************************************************
+  * @file    luenberger_obs.h
+  * @brief   This file contains all definitions and functions prototypes for the
+  *          discrete time Luenberger rotor angle/speed observer
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  * Two observers in cascade, both with gains placed once by
+  * LUENBERGER_Init_Gains():
+  *
+  *  1. back-EMF observer, per stationary axis, states [i e]:
+  *       L di/dt = v - Rs*i - e,   de/dt = 0
+  *     discretized exactly (zero order hold), double pole at exp(-wo*Ts).
+  *  2. angle/speed observer (PLL), states [theta omega]:
+  *       theta[k+1] = theta + Ts*omega,  omega[k+1] = omega
+  *     driven by the angle error taken from the estimated back-EMF,
+  *     double pole at exp(-wpll*Ts).
+  *
+  * The back-EMF lies on the q axis of mc_math.h, e = we*PsiM*(cos, -sin),
+  * so theta is directly usable by the MCM_Rev_Park/MCM_Park blocks.
+  * The state update is fixed size and does not allocate.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __LUENBERGER_OBS_H
+#define __LUENBERGER_OBS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "mc_math.h"
+
+typedef struct
+{
+  double Phi11;   /**< (Ad - L*C)(1,1) of the back-EMF observer    */
+  double Phi12;   /**< (Ad - L*C)(1,2)                             */
+  double G;       /**< Bd(1), voltage input gain                   */
+  double Zo;      /**< back-EMF observer pole, for lag compensation */
+  double L1;      /**< current correction gain                     */
+  double L2;      /**< back-EMF correction gain                    */
+  double K1;      /**< PLL angle gain                              */
+  double K2;      /**< PLL speed gain                              */
+  double Ts;      /**< sample time (s)                             */
+} LuenbergerObs_Gains_t;
+
+typedef struct
+{
+  double Ialpha;  /**< estimated currents                          */
+  double Ibeta;
+  double Ealpha;  /**< estimated back-EMF                          */
+  double Ebeta;
+  double Phase;   /**< PLL angle, locked on the back-EMF estimate  */
+  double Theta;   /**< estimated electrical angle, [-pi, pi)       */
+  double Omega;   /**< estimated electrical speed (rad/s)          */
+} LuenbergerObs_State_t;
+
+typedef struct
+{
+  LuenbergerObs_Gains_t Gains;
+  LuenbergerObs_State_t State;
+} LuenbergerObs_Handle_t;
+
+/* Exported functions ------------------------------------------------------- */
+
+int  LUENBERGER_Init_Gains( LuenbergerObs_Gains_t * pGains, double Rs,
+                            double Ls, double Ts, double wo, double wpll );
+void LUENBERGER_Reset( LuenbergerObs_State_t * pState );
+void LUENBERGER_Step( const LuenbergerObs_Gains_t * pGains,
+                      LuenbergerObs_State_t * pState,
+                      alphabeta_t Valphabeta, alphabeta_t Ialphabeta );
+void LUENBERGER_Step_Batch( LuenbergerObs_Handle_t * pHandles,
+                            const alphabeta_t * pV, const alphabeta_t * pI,
+                            uint32_t n );
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __LUENBERGER_OBS_H */
+
+/* *****END OF FILE****/
@@ -0,0 +1,203 @@
+/**
+  ******************************************************************************
+  * @file    mc_math.c
+  * @brief   This file provides the motor control math used by the MCM_*
+  *          S-functions: Clarke, Park, their inverses and the batch kernels
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * license info:
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include "mc_math.h"
+
+/**
+  * @brief  Sine and cosine of an electrical angle. Single provider for all
+  *         transforms; sin() and cos() of the same argument are merged into
+  *         one sincos() call by the compiler.
+  * @param  theta angle in radians
+  * @retval Trig_Components cos and sin of theta
+  */
+Trig_Components MCM_Trig_Functions( double theta )
+{
+  Trig_Components Local_Components;
+
+  Local_Components.hCos = cos( theta );
+  Local_Components.hSin = sin( theta );
+
+  return ( Local_Components );
+}
+
+/**
+  * @brief  Clarke transformation, three phase to stationary alpha-beta
+  * @param  Vabc phase quantities
+  * @retval alphabeta_t alpha and beta quantities
+  */
+alphabeta_t MCM_Clarke_Transform( abc_t Vabc )
+{
+  alphabeta_t Output;
+
+  Output.alpha = ( 2.0 * Vabc.a - Vabc.b - Vabc.c ) * ( 1.0 / 3.0 );
+  Output.beta  = ( Vabc.b - Vabc.c ) * ONE_BY_SQRT3;
+
+  return ( Output );
+}
+
+/**
+  * @brief  Inverse Clarke transformation, alpha-beta to three phase
+  * @param  Valphabeta alpha and beta quantities
+  * @retval abc_t phase quantities
+  */
+abc_t MCM_Inv_Clarke_Transform( alphabeta_t Valphabeta )
+{
+  abc_t Output;
+
+  Output.a = Valphabeta.alpha;
+  Output.b = -0.5 * Valphabeta.alpha + SQRT3_BY_2 * Valphabeta.beta;
+  Output.c = -0.5 * Valphabeta.alpha - SQRT3_BY_2 * Valphabeta.beta;
+
+  return ( Output );
+}
+
+/**
+  * @brief  Park transformation, stationary alpha-beta to rotating q-d
+  * @param  Valphabeta alpha and beta quantities
+  * @param  Trig sin/cos of the rotor angle from MCM_Trig_Functions()
+  * @retval qd_real_t q and d quantities
+  */
+qd_real_t MCM_Park_Transform( alphabeta_t Valphabeta, Trig_Components Trig )
+{
+  qd_real_t Output;
+
+  Output.q = Valphabeta.alpha * Trig.hCos - Valphabeta.beta * Trig.hSin;
+  Output.d = Valphabeta.alpha * Trig.hSin + Valphabeta.beta * Trig.hCos;
+
+  return ( Output );
+}
+
+/**
+  * @brief  Reverse Park transformation, rotating q-d to stationary alpha-beta
+  * @param  Vqd q and d quantities
+  * @param  Trig sin/cos of the rotor angle from MCM_Trig_Functions()
+  * @retval alphabeta_t alpha and beta quantities
+  */
+alphabeta_t MCM_Rev_Park_Transform( qd_real_t Vqd, Trig_Components Trig )
+{
+  alphabeta_t Output;
+
+  Output.alpha =  Vqd.q * Trig.hCos + Vqd.d * Trig.hSin;
+  Output.beta  = -Vqd.q * Trig.hSin + Vqd.d * Trig.hCos;
+
+  return ( Output );
+}
+
+/**
+  * @brief  Fused Clarke + Park, sin/cos evaluated once
+  * @param  Vabc phase quantities
+  * @param  theta rotor angle in radians
+  * @retval qd_real_t q and d quantities
+  */
+qd_real_t MCM_Clarke_Park_Transform( abc_t Vabc, double theta )
+{
+  return ( MCM_Park_Transform( MCM_Clarke_Transform( Vabc ),
+                               MCM_Trig_Functions( theta ) ) );
+}
+
+/* Batch kernels ------------------------------------------------------------
+ * Plain loops over structure of arrays without calls other than libm, so
+ * the compiler can vectorize them; keep them free of branches.
+ */
+
+void MCM_Trig_Functions_Batch( const double * theta, double * hCos,
+                               double * hSin, uint32_t n )
+{
+  uint32_t i;
+
+  for ( i = 0; i < n; i++ )
+  {
+    hCos[i] = cos( theta[i] );
+    hSin[i] = sin( theta[i] );
+  }
+}
+
+void MCM_Clarke_Batch( const double * a, const double * b, const double * c,
+                       double * alpha, double * beta, uint32_t n )
+{
+  uint32_t i;
+
+  for ( i = 0; i < n; i++ )
+  {
+    alpha[i] = ( 2.0 * a[i] - b[i] - c[i] ) * ( 1.0 / 3.0 );
+    beta[i]  = ( b[i] - c[i] ) * ONE_BY_SQRT3;
+  }
+}
+
+void MCM_Inv_Clarke_Batch( const double * alpha, const double * beta,
+                           double * a, double * b, double * c, uint32_t n )
+{
+  uint32_t i;
+
+  for ( i = 0; i < n; i++ )
+  {
+    a[i] = alpha[i];
+    b[i] = -0.5 * alpha[i] + SQRT3_BY_2 * beta[i];
+    c[i] = -0.5 * alpha[i] - SQRT3_BY_2 * beta[i];
+  }
+}
+
+void MCM_Park_Batch( const double * alpha, const double * beta,
+                     const double * theta, double * q, double * d,
+                     uint32_t n )
+{
+  uint32_t i;
+
+  for ( i = 0; i < n; i++ )
+  {
+    double hCos = cos( theta[i] );
+    double hSin = sin( theta[i] );
+
+    q[i] = alpha[i] * hCos - beta[i] * hSin;
+    d[i] = alpha[i] * hSin + beta[i] * hCos;
+  }
+}
+
+void MCM_Rev_Park_Batch( const double * q, const double * d,
+                         const double * theta, double * alpha,
+                         double * beta, uint32_t n )
+{
+  uint32_t i;
+
+  for ( i = 0; i < n; i++ )
+  {
+    double hCos = cos( theta[i] );
+    double hSin = sin( theta[i] );
+
+    alpha[i] =  q[i] * hCos + d[i] * hSin;
+    beta[i]  = -q[i] * hSin + d[i] * hCos;
+  }
+}
+
+void MCM_Clarke_Park_Batch( const double * a, const double * b,
+                            const double * c, const double * theta,
+                            double * q, double * d, uint32_t n )
+{
+  uint32_t i;
+
+  for ( i = 0; i < n; i++ )
+  {
+    double hCos  = cos( theta[i] );
+    double hSin  = sin( theta[i] );
+    double alpha = ( 2.0 * a[i] - b[i] - c[i] ) * ( 1.0 / 3.0 );
+    double beta  = ( b[i] - c[i] ) * ONE_BY_SQRT3;
+
+    q[i] = alpha * hCos - beta * hSin;
+    d[i] = alpha * hSin + beta * hCos;
+  }
+}
+
+/***************  END OF FILE****/
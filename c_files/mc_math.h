@@ -0,0 +1,104 @@
+/**
+  ******************************************************************************
+  * @file    mc_math.h
+  * @brief   This file contains all definitions and functions prototypes for the
+  *          motor control math: Clarke, Park and their inverses, scalar and
+  *          batched (structure of arrays) versions
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  * Conventions (same as the MCM_Rev_Park S-function):
+  *
+  *   Clarke      alpha = (2a - b - c)/3
+  *               beta  = (b - c)/sqrt(3)
+  *   Inv Clarke  a = alpha
+  *               b = (-alpha + sqrt(3)*beta)/2
+  *               c = (-alpha - sqrt(3)*beta)/2
+  *   Park        q =  alpha*cos(theta) - beta*sin(theta)
+  *               d =  alpha*sin(theta) + beta*cos(theta)
+  *   Rev Park    alpha =  q*cos(theta) + d*sin(theta)
+  *               beta  = -q*sin(theta) + d*cos(theta)
+  *
+  * The three input Clarke form rejects any common mode, so it can be fed
+  * directly with the 0/Vbus phase voltages of the svpwm S-function.
+  * All transforms take their sin/cos from MCM_Trig_Functions() so a fused
+  * Clarke + Park evaluates the trigonometry only once.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MC_MATH_H
+#define __MC_MATH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+#define SQRT3           1.73205080756887729353
+#define ONE_BY_SQRT3    0.57735026918962576451
+#define SQRT3_BY_2      0.86602540378443864676
+
+typedef struct
+{
+  double a;
+  double b;
+  double c;
+} abc_t;
+
+typedef struct
+{
+  double alpha;
+  double beta;
+} alphabeta_t;
+
+typedef struct
+{
+  double q;
+  double d;
+} qd_real_t;
+
+typedef struct
+{
+  double hCos;
+  double hSin;
+} Trig_Components;
+
+/* Exported functions ------------------------------------------------------- */
+
+Trig_Components MCM_Trig_Functions( double theta );
+
+abc_t       MCM_Inv_Clarke_Transform( alphabeta_t Valphabeta );
+alphabeta_t MCM_Clarke_Transform( abc_t Vabc );
+qd_real_t   MCM_Park_Transform( alphabeta_t Valphabeta, Trig_Components Trig );
+alphabeta_t MCM_Rev_Park_Transform( qd_real_t Vqd, Trig_Components Trig );
+qd_real_t   MCM_Clarke_Park_Transform( abc_t Vabc, double theta );
+
+/* Batch kernels: n samples, structure of arrays, outputs may not alias inputs */
+void MCM_Trig_Functions_Batch( const double * theta, double * hCos,
+                               double * hSin, uint32_t n );
+void MCM_Clarke_Batch( const double * a, const double * b, const double * c,
+                       double * alpha, double * beta, uint32_t n );
+void MCM_Inv_Clarke_Batch( const double * alpha, const double * beta,
+                           double * a, double * b, double * c, uint32_t n );
+void MCM_Park_Batch( const double * alpha, const double * beta,
+                     const double * theta, double * q, double * d,
+                     uint32_t n );
+void MCM_Rev_Park_Batch( const double * q, const double * d,
+                         const double * theta, double * alpha,
+                         double * beta, uint32_t n );
+void MCM_Clarke_Park_Batch( const double * a, const double * b,
+                            const double * c, const double * theta,
+                            double * q, double * d, uint32_t n );
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __MC_MATH_H */
+
+/* *****END OF FILE****/
@@ -0,0 +1,78 @@
+/**
+  ******************************************************************************
+  * @file    pi_regulator.c
+  * @brief   This file provides the PI regulator used by the FOC current loop,
+  *          clamping anti-windup on the integral term
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * license info:
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "pi_regulator.h"
+
+/**
+  * @brief  Set gains and symmetric output limit, clear the integral term
+  * @param  pHandle regulator instance
+  * @param  Kp proportional gain
+  * @param  Ki integral gain (1/s)
+  * @param  Ts sample time (s)
+  * @param  Limit output limit, +/-
+  */
+void PI_Init( PI_Handle_t * pHandle, double Kp, double Ki, double Ts,
+              double Limit )
+{
+  pHandle->Kp         = Kp;
+  pHandle->KiTs       = Ki * Ts;
+  pHandle->UpperLimit = Limit;
+  pHandle->LowerLimit = -Limit;
+  pHandle->Integral   = 0.0;
+}
+
+/**
+  * @brief  Clear the integral term
+  */
+void PI_Reset( PI_Handle_t * pHandle )
+{
+  pHandle->Integral = 0.0;
+}
+
+/**
+  * @brief  One regulator step
+  * @param  pHandle regulator instance
+  * @param  Error reference - feedback
+  * @retval regulator output, within the limits
+  */
+double PI_Controller( PI_Handle_t * pHandle, double Error )
+{
+  double integral = pHandle->Integral + pHandle->KiTs * Error;
+  double output;
+
+  if ( integral > pHandle->UpperLimit )
+  {
+    integral = pHandle->UpperLimit;
+  }
+  else if ( integral < pHandle->LowerLimit )
+  {
+    integral = pHandle->LowerLimit;
+  }
+  pHandle->Integral = integral;
+
+  output = pHandle->Kp * Error + integral;
+  if ( output > pHandle->UpperLimit )
+  {
+    output = pHandle->UpperLimit;
+  }
+  else if ( output < pHandle->LowerLimit )
+  {
+    output = pHandle->LowerLimit;
+  }
+
+  return ( output );
+}
+
+/***************  END OF FILE****/
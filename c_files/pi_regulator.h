@@ -0,0 +1,44 @@
+/**
+  ******************************************************************************
+  * @file    pi_regulator.h
+  * @brief   This file contains all definitions and functions prototypes for the
+  *          PI current regulators of the FOC loop
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PI_REGULATOR_H
+#define __PI_REGULATOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+typedef struct
+{
+  double Kp;           /**< proportional gain                         */
+  double KiTs;         /**< integral gain times the sample time       */
+  double UpperLimit;   /**< output and integral term upper limit      */
+  double LowerLimit;   /**< output and integral term lower limit      */
+  double Integral;     /**< integral term                             */
+} PI_Handle_t;
+
+/* Exported functions ------------------------------------------------------- */
+
+void   PI_Init( PI_Handle_t * pHandle, double Kp, double Ki, double Ts,
+                double Limit );
+void   PI_Reset( PI_Handle_t * pHandle );
+double PI_Controller( PI_Handle_t * pHandle, double Error );
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __PI_REGULATOR_H */
+
+/* *****END OF FILE****/
@@ -0,0 +1,229 @@
+/**
+  ******************************************************************************
+  * @file    pmsm_model.c
+  * @brief   This file provides the PMSM/BLDC plant model used by the bldc_mtr
+  *          S-function and the standalone simulation, with a fixed step RK4
+  *          or semi-implicit integrator
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * license info:
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include "pmsm_model.h"
+
+#define TWO_PI 6.28318530717958647693
+
+/* state vector layout used by the RK4 stages */
+#define X_ID  0
+#define X_IQ  1
+#define X_WM  2
+#define X_THM 3
+#define NX    4
+
+static double PMSM_Cogging( const PMSM_Params_t * pP, double thm )
+{
+  if ( pP->Kcog == 0.0 )
+  {
+    return ( 0.0 );
+  }
+  return ( pP->Kcog * sin( pP->Ncog * thm ) );
+}
+
+static double PMSM_Airgap_Torque( const PMSM_Handle_t * pHandle,
+                                  double id, double iq, double thm )
+{
+  const PMSM_Params_t * pP = &pHandle->Params;
+
+  return ( pHandle->TorqueK * ( pP->PsiM * iq + ( pP->Ld - pP->Lq ) * id * iq )
+           + PMSM_Cogging( pP, thm ) );
+}
+
+static void PMSM_Derivatives( const PMSM_Handle_t * pHandle, const double * x,
+                              alphabeta_t Valphabeta, double Tload,
+                              double * dx )
+{
+  const PMSM_Params_t * pP = &pHandle->Params;
+  qd_real_t Vqd;
+  double    we;
+  double    Te;
+
+  Vqd = MCM_Park_Transform( Valphabeta,
+                            MCM_Trig_Functions( pP->Pp * x[X_THM] ) );
+  we  = pP->Pp * x[X_WM];
+  Te  = PMSM_Airgap_Torque( pHandle, x[X_ID], x[X_IQ], x[X_THM] );
+
+  dx[X_ID]  = ( Vqd.d - pP->Rs * x[X_ID] + we * pP->Lq * x[X_IQ] )
+              * pHandle->InvLd;
+  dx[X_IQ]  = ( Vqd.q - pP->Rs * x[X_IQ] - we * ( pP->Ld * x[X_ID] + pP->PsiM ) )
+              * pHandle->InvLq;
+  dx[X_WM]  = ( Te - Tload - pP->B * x[X_WM] ) * pHandle->InvJ;
+  dx[X_THM] = x[X_WM];
+}
+
+static void PMSM_Step_RK4( const PMSM_Handle_t * pHandle, PMSM_State_t * pState,
+                           alphabeta_t Valphabeta, double Tload, double h )
+{
+  double x[NX] = { pState->id, pState->iq, pState->wm, pState->thm };
+  double k1[NX], k2[NX], k3[NX], k4[NX], xt[NX];
+  int i;
+
+  PMSM_Derivatives( pHandle, x, Valphabeta, Tload, k1 );
+  for ( i = 0; i < NX; i++ ) xt[i] = x[i] + 0.5 * h * k1[i];
+  PMSM_Derivatives( pHandle, xt, Valphabeta, Tload, k2 );
+  for ( i = 0; i < NX; i++ ) xt[i] = x[i] + 0.5 * h * k2[i];
+  PMSM_Derivatives( pHandle, xt, Valphabeta, Tload, k3 );
+  for ( i = 0; i < NX; i++ ) xt[i] = x[i] + h * k3[i];
+  PMSM_Derivatives( pHandle, xt, Valphabeta, Tload, k4 );
+
+  pState->id  = x[X_ID]  + h / 6.0 * ( k1[X_ID]  + 2.0 * ( k2[X_ID]  + k3[X_ID] )  + k4[X_ID] );
+  pState->iq  = x[X_IQ]  + h / 6.0 * ( k1[X_IQ]  + 2.0 * ( k2[X_IQ]  + k3[X_IQ] )  + k4[X_IQ] );
+  pState->wm  = x[X_WM]  + h / 6.0 * ( k1[X_WM]  + 2.0 * ( k2[X_WM]  + k3[X_WM] )  + k4[X_WM] );
+  pState->thm = x[X_THM] + h / 6.0 * ( k1[X_THM] + 2.0 * ( k2[X_THM] + k3[X_THM] ) + k4[X_THM] );
+}
+
+/*
+ * Backward Euler on the R-L circuit with the speed frozen over the step
+ * (a 2x2 solve, unconditionally stable for stiff low inductance motors),
+ * then the mechanics with the new currents and implicit friction.
+ */
+static void PMSM_Step_Semi_Implicit( const PMSM_Handle_t * pHandle,
+                                     PMSM_State_t * pState,
+                                     alphabeta_t Valphabeta, double Tload,
+                                     double h )
+{
+  const PMSM_Params_t * pP = &pHandle->Params;
+  qd_real_t Vqd;
+  double we = pP->Pp * pState->wm;
+  double a  = pP->Ld / h + pP->Rs;
+  double b  = pP->Lq / h + pP->Rs;
+  double rd;
+  double rq;
+  double inv_det;
+  double id;
+  double iq;
+  double Te;
+
+  /* voltage seen at the middle of the step */
+  Vqd = MCM_Park_Transform( Valphabeta,
+          MCM_Trig_Functions( pP->Pp * ( pState->thm + 0.5 * h * pState->wm ) ) );
+
+  rd = Vqd.d + pP->Ld / h * pState->id;
+  rq = Vqd.q - we * pP->PsiM + pP->Lq / h * pState->iq;
+
+  inv_det = 1.0 / ( a * b + we * we * pP->Ld * pP->Lq );
+  id = ( rd * b + we * pP->Lq * rq ) * inv_det;
+  iq = ( a * rq - we * pP->Ld * rd ) * inv_det;
+
+  Te = PMSM_Airgap_Torque( pHandle, id, iq, pState->thm );
+
+  pState->id  = id;
+  pState->iq  = iq;
+  pState->wm  = ( pState->wm + h * pHandle->InvJ * ( Te - Tload ) )
+                / ( 1.0 + h * pP->B * pHandle->InvJ );
+  pState->thm = pState->thm + h * pState->wm;
+}
+
+/**
+  * @brief  Validate the motor parameters and precompute the constants
+  * @param  pHandle model instance
+  * @param  pParams motor parameters
+  * @param  Method integrator
+  * @retval 0 on success, -1 if a parameter is out of range
+  */
+int PMSM_Init( PMSM_Handle_t * pHandle, const PMSM_Params_t * pParams,
+               PMSM_Integrator_t Method )
+{
+  if ( pParams->Ld <= 0.0 || pParams->Lq <= 0.0 || pParams->J <= 0.0 ||
+       pParams->Pp <= 0.0 || pParams->Rs < 0.0 || pParams->B < 0.0 )
+  {
+    return ( -1 );
+  }
+
+  pHandle->Params  = *pParams;
+  pHandle->Method  = Method;
+  pHandle->InvLd   = 1.0 / pParams->Ld;
+  pHandle->InvLq   = 1.0 / pParams->Lq;
+  pHandle->InvJ    = 1.0 / pParams->J;
+  pHandle->TorqueK = 1.5 * pParams->Pp;
+
+  return ( 0 );
+}
+
+/**
+  * @brief  Motor at standstill, zero current
+  */
+void PMSM_Reset( PMSM_State_t * pState )
+{
+  pState->id  = 0.0;
+  pState->iq  = 0.0;
+  pState->wm  = 0.0;
+  pState->thm = 0.0;
+}
+
+/**
+  * @brief  Advance the model by h seconds with constant stator voltage
+  * @param  pHandle model instance
+  * @param  pState states, updated in place
+  * @param  Valphabeta stator voltage in the stationary frame (V)
+  * @param  Tload load torque (Nm)
+  * @param  h step (s)
+  */
+void PMSM_Step( const PMSM_Handle_t * pHandle, PMSM_State_t * pState,
+                alphabeta_t Valphabeta, double Tload, double h )
+{
+  if ( pHandle->Method == PMSM_SEMI_IMPLICIT )
+  {
+    PMSM_Step_Semi_Implicit( pHandle, pState, Valphabeta, Tload, h );
+  }
+  else
+  {
+    PMSM_Step_RK4( pHandle, pState, Valphabeta, Tload, h );
+  }
+
+  /* keep the mechanical angle in [0, 2*pi) */
+  if ( pState->thm >= TWO_PI || pState->thm < 0.0 )
+  {
+    pState->thm -= TWO_PI * floor( pState->thm / TWO_PI );
+  }
+}
+
+/**
+  * @brief  Electromagnetic torque including cogging (Nm)
+  */
+double PMSM_Torque( const PMSM_Handle_t * pHandle, const PMSM_State_t * pState )
+{
+  return ( PMSM_Airgap_Torque( pHandle, pState->id, pState->iq, pState->thm ) );
+}
+
+/**
+  * @brief  Electrical angle Pp*thm (rad), the theta of the MCM_* transforms
+  */
+double PMSM_Elec_Angle( const PMSM_Handle_t * pHandle,
+                        const PMSM_State_t * pState )
+{
+  return ( pHandle->Params.Pp * pState->thm );
+}
+
+/**
+  * @brief  Phase currents from the dq states
+  */
+abc_t PMSM_Phase_Currents( const PMSM_Handle_t * pHandle,
+                           const PMSM_State_t * pState )
+{
+  qd_real_t Iqd;
+
+  Iqd.q = pState->iq;
+  Iqd.d = pState->id;
+
+  return ( MCM_Inv_Clarke_Transform(
+             MCM_Rev_Park_Transform( Iqd, MCM_Trig_Functions(
+                                       PMSM_Elec_Angle( pHandle, pState ) ) ) ) );
+}
+
+/***************  END OF FILE****/
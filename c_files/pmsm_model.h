@@ -0,0 +1,92 @@
+/**
+  ******************************************************************************
+  * @file    pmsm_model.h
+  * @brief   This file contains all definitions and functions prototypes for the
+  *          PMSM/BLDC plant model (dq frame electrical + mechanical dynamics)
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  * States: id, iq (A), wm (mech rad/s), thm (mech rad, [0, 2*pi)).
+  * The dq frame is the one of mc_math.h, theta_e = Pp*thm:
+  *
+  *   Ld did/dt = vd - Rs*id + we*Lq*iq
+  *   Lq diq/dt = vq - Rs*iq - we*(Ld*id + PsiM)
+  *   J  dwm/dt = Te - Tload - B*wm
+  *   Te        = 1.5*Pp*(PsiM*iq + (Ld - Lq)*id*iq) + Kcog*sin(Ncog*thm)
+  *
+  * Voltages are given in the stationary frame so the Park transform is
+  * redone at every integrator stage; this lets the model consume averaged or
+  * switched svpwm phase voltages (0/Vbus, common mode rejected by Clarke).
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PMSM_MODEL_H
+#define __PMSM_MODEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include "mc_math.h"
+
+typedef enum
+{
+  PMSM_RK4           = 0,  /**< classic 4th order Runge-Kutta             */
+  PMSM_SEMI_IMPLICIT = 1   /**< backward Euler currents, then mechanics   */
+} PMSM_Integrator_t;
+
+typedef struct
+{
+  double Rs;      /**< stator resistance (ohm)                   */
+  double Ld;      /**< d-axis inductance (H)                     */
+  double Lq;      /**< q-axis inductance (H)                     */
+  double PsiM;    /**< permanent magnet flux linkage (Wb)        */
+  double Pp;      /**< pole pairs                                */
+  double J;       /**< rotor inertia (kg m^2)                    */
+  double B;       /**< viscous friction (Nm s/rad)               */
+  double Kcog;    /**< cogging torque amplitude (Nm), 0 = none   */
+  double Ncog;    /**< cogging periods per mechanical revolution */
+} PMSM_Params_t;
+
+typedef struct
+{
+  double id;
+  double iq;
+  double wm;
+  double thm;
+} PMSM_State_t;
+
+typedef struct
+{
+  PMSM_Params_t     Params;
+  PMSM_Integrator_t Method;
+  double            InvLd;     /**< 1/Ld, precomputed in PMSM_Init */
+  double            InvLq;     /**< 1/Lq                           */
+  double            InvJ;      /**< 1/J                            */
+  double            TorqueK;   /**< 1.5*Pp                         */
+} PMSM_Handle_t;
+
+/* Exported functions ------------------------------------------------------- */
+
+int    PMSM_Init( PMSM_Handle_t * pHandle, const PMSM_Params_t * pParams,
+                  PMSM_Integrator_t Method );
+void   PMSM_Reset( PMSM_State_t * pState );
+void   PMSM_Step( const PMSM_Handle_t * pHandle, PMSM_State_t * pState,
+                  alphabeta_t Valphabeta, double Tload, double h );
+double PMSM_Torque( const PMSM_Handle_t * pHandle, const PMSM_State_t * pState );
+double PMSM_Elec_Angle( const PMSM_Handle_t * pHandle,
+                        const PMSM_State_t * pState );
+abc_t  PMSM_Phase_Currents( const PMSM_Handle_t * pHandle,
+                            const PMSM_State_t * pState );
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __PMSM_MODEL_H */
+
+/* *****END OF FILE****/
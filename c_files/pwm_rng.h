@@ -0,0 +1,71 @@
+/**
+  ******************************************************************************
+  * @file    pwm_rng.h
+  * @brief   Counter-based random numbers for the random (spread-spectrum) pwm
+  *          carrier
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  * Draw k of a stream is a pure function of (key, k): the SplitMix64 output
+  * function applied to key + (k+1)*gamma. No state is carried between
+  * draws, so period k gets the same number whatever order or thread the
+  * periods run in, and a run is reproduced from its seed alone. Streams
+  * with different keys (RNG_Key(seed, stream)) are independent for
+  * practical purposes. A draw is a handful of integer multiplies.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PWM_RNG_H
+#define __PWM_RNG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+#define RNG_GAMMA 0x9E3779B97F4A7C15ULL
+
+static inline uint64_t RNG_Mix64( uint64_t z )
+{
+  z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+  z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+  return ( z ^ ( z >> 31 ) );
+}
+
+/* stream key from a user seed and a stream number (thread, instance) */
+static inline uint64_t RNG_Key( uint64_t Seed, uint64_t Stream )
+{
+  return ( RNG_Mix64( Seed ) ^ RNG_Mix64( Stream * RNG_GAMMA + 1u ) );
+}
+
+/* draw k of the stream, 64 random bits */
+static inline uint64_t RNG_U64( uint64_t Key, uint64_t k )
+{
+  return ( RNG_Mix64( Key + ( k + 1u ) * RNG_GAMMA ) );
+}
+
+/* draw k of the stream, uniform on [0, 1) */
+static inline double RNG_Uniform( uint64_t Key, uint64_t k )
+{
+  return ( ( double )( RNG_U64( Key, k ) >> 11 ) * ( 1.0 / 9007199254740992.0 ) );
+}
+
+/* pwm period k: Ts*(1 + Spread*(2u - 1)), uniform on Ts*(1 -/+ Spread) */
+static inline double RNG_Dither_Period( uint64_t Key, uint64_t k, double Ts,
+                                        double Spread )
+{
+  return ( Ts * ( 1.0 + Spread * ( 2.0 * RNG_Uniform( Key, k ) - 1.0 ) ) );
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __PWM_RNG_H */
+
+/* *****END OF FILE****/
@@ -0,0 +1,281 @@
+/**
+  ******************************************************************************
+  * @file    pwm_spectrum.c
+  * @brief   This file provides the streaming harmonic analyzer of the U/V/W
+  *          pwm outputs, closed-form Fourier integrals of the pulse edges
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * license info:
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <string.h>
+#include "pwm_spectrum.h"
+#include "svpwm_core.h"
+
+#define PI     3.14159265358979323846
+#define TWO_PI 6.28318530717958647693
+
+/* X(h) += exp(-j h w a) - exp(-j h w b) for h = 1..NHarm, the 1/(j h w)
+   factor is applied when the window closes */
+static void PWM_Spectrum_Pulse( PWM_Spectrum_t * pSpec, int Ph,
+                                double a, double b )
+{
+  const double w  = TWO_PI * pSpec->F1;
+  const double ca = cos( w * a );
+  const double sa = -sin( w * a );
+  const double cb = cos( w * b );
+  const double sb = -sin( w * b );
+  double * pRe = pSpec->Re[Ph];
+  double * pIm = pSpec->Im[Ph];
+  double   ra = ca;
+  double   ia = sa;
+  double   rb = cb;
+  double   ib = sb;
+  double   t;
+  uint32_t h;
+
+  for ( h = 0; h < pSpec->NHarm; h++ )
+  {
+    pRe[h] += ra - rb;
+    pIm[h] += ia - ib;
+    /* next harmonic: multiply by exp(-j w a), exp(-j w b) */
+    t  = ra * ca - ia * sa;
+    ia = ra * sa + ia * ca;
+    ra = t;
+    t  = rb * cb - ib * sb;
+    ib = rb * sb + ib * cb;
+    rb = t;
+  }
+}
+
+/* amplitudes of the open window into the sums, open the next window */
+static void PWM_Spectrum_Close( PWM_Spectrum_t * pSpec )
+{
+  const double w = TWO_PI * pSpec->F1;
+  uint32_t h;
+  int      ph;
+
+  for ( h = 0; h < pSpec->NHarm; h++ )
+  {
+    /* peak amplitude (2/T) |X| with X = Vbus * acc / (j h w) */
+    const double k = 2.0 * pSpec->Vbus / ( pSpec->Window * ( h + 1 ) * w );
+    double re;
+    double im;
+
+    for ( ph = 0; ph < 3; ph++ )
+    {
+      re = pSpec->Re[ph][h];
+      im = pSpec->Im[ph][h];
+      pSpec->SumSq[ph][h] += k * k * ( re * re + im * im );
+    }
+    re = pSpec->Re[0][h] - pSpec->Re[1][h];
+    im = pSpec->Im[0][h] - pSpec->Im[1][h];
+    pSpec->SumSq[PWM_SPECTRUM_UV][h] += k * k * ( re * re + im * im );
+  }
+
+  memset( pSpec->Re, 0, sizeof( pSpec->Re ) );
+  memset( pSpec->Im, 0, sizeof( pSpec->Im ) );
+  pSpec->Tw0 += pSpec->Window;
+  pSpec->Windows++;
+}
+
+/**
+  * @brief  Set up an analyzer, first window starting at t = 0
+  * @param  pSpec analyzer
+  * @param  F1 fundamental (Hz)
+  * @param  NHarm bins h = 1..NHarm, at most PWM_SPECTRUM_MAX_HARM
+  * @param  Cycles fundamental periods per window
+  * @param  Vbus pulse height (V)
+  * @retval 0 on success, -1 on invalid arguments
+  */
+int PWM_Spectrum_Init( PWM_Spectrum_t * pSpec, double F1, uint32_t NHarm,
+                       uint32_t Cycles, double Vbus )
+{
+  if ( !( F1 > 0.0 ) || NHarm < 1 || NHarm > PWM_SPECTRUM_MAX_HARM ||
+       Cycles < 1 )
+  {
+    return ( -1 );
+  }
+  pSpec->F1     = F1;
+  pSpec->Vbus   = Vbus;
+  pSpec->NHarm  = NHarm;
+  pSpec->Window = Cycles / F1;
+  PWM_Spectrum_Reset( pSpec, 0.0 );
+
+  return ( 0 );
+}
+
+/**
+  * @brief  Drop all windows, the next one starts at t0
+  */
+void PWM_Spectrum_Reset( PWM_Spectrum_t * pSpec, double t0 )
+{
+  memset( pSpec->Re, 0, sizeof( pSpec->Re ) );
+  memset( pSpec->Im, 0, sizeof( pSpec->Im ) );
+  memset( pSpec->SumSq, 0, sizeof( pSpec->SumSq ) );
+  pSpec->Tw0     = t0;
+  pSpec->Windows = 0;
+}
+
+/**
+  * @brief  Add one center-aligned pwm period
+  * @param  pSpec analyzer
+  * @param  t0 period start (s), periods must be added in time order
+  * @param  Tk period length (s)
+  * @param  pCmp compare values U, V, W (s), see svpwm_core.h
+  * @param  pInv inverted carrier flags U, V, W, NULL for none
+  */
+void PWM_Spectrum_Add_Period( PWM_Spectrum_t * pSpec, double t0, double Tk,
+                              const double * pCmp, const uint8_t * pInv )
+{
+  double a[2];
+  double b[2];
+  double wend;
+  int    np;
+  int    ph;
+  int    i;
+
+  /* windows that ended before this period */
+  while ( t0 >= pSpec->Tw0 + pSpec->Window )
+  {
+    PWM_Spectrum_Close( pSpec );
+  }
+
+  for ( ;; )
+  {
+    wend = pSpec->Tw0 + pSpec->Window;
+
+    for ( ph = 0; ph < 3; ph++ )
+    {
+      const double e = 0.5 * Tk * SVPWM_Duty( pCmp[ph], Tk );
+
+      if ( pInv != NULL && pInv[ph] )
+      {
+        /* high on [Tk/2 - e, Tk/2 + e] */
+        a[0] = t0 + 0.5 * Tk - e;
+        b[0] = t0 + 0.5 * Tk + e;
+        np   = 1;
+      }
+      else
+      {
+        /* high on [0, e] and [Tk - e, Tk] of the period */
+        a[0] = t0;
+        b[0] = t0 + e;
+        a[1] = t0 + Tk - e;
+        b[1] = t0 + Tk;
+        np   = 2;
+      }
+      for ( i = 0; i < np; i++ )
+      {
+        if ( a[i] < pSpec->Tw0 )
+        {
+          a[i] = pSpec->Tw0;
+        }
+        if ( b[i] > wend )
+        {
+          b[i] = wend;
+        }
+        if ( b[i] > a[i] )
+        {
+          PWM_Spectrum_Pulse( pSpec, ph, a[i] - pSpec->Tw0,
+                              b[i] - pSpec->Tw0 );
+        }
+      }
+    }
+
+    if ( t0 + Tk <= wend )
+    {
+      break;
+    }
+    /* the period runs into the next window */
+    PWM_Spectrum_Close( pSpec );
+  }
+}
+
+/**
+  * @brief  Rms average over the closed windows of the peak amplitude of
+  *         harmonic h (V), 0 before the first window closes
+  */
+double PWM_Spectrum_Magnitude( const PWM_Spectrum_t * pSpec,
+                               PWM_Spectrum_Ch_t Ch, uint32_t h )
+{
+  if ( pSpec->Windows == 0 || h < 1 || h > pSpec->NHarm )
+  {
+    return ( 0.0 );
+  }
+  return ( sqrt( pSpec->SumSq[Ch][h - 1] / pSpec->Windows ) );
+}
+
+/**
+  * @brief  Weighted THD, sqrt( sum_{h>=2} (V_h/h)^2 ) / V_1
+  */
+double PWM_Spectrum_Wthd( const PWM_Spectrum_t * pSpec, PWM_Spectrum_Ch_t Ch )
+{
+  double   v1 = PWM_Spectrum_Magnitude( pSpec, Ch, 1 );
+  double   sum = 0.0;
+  uint32_t h;
+
+  if ( v1 <= 0.0 )
+  {
+    return ( 0.0 );
+  }
+  for ( h = 2; h <= pSpec->NHarm; h++ )
+  {
+    double vh = PWM_Spectrum_Magnitude( pSpec, Ch, h ) / h;
+
+    sum += vh * vh;
+  }
+  return ( sqrt( sum ) / v1 );
+}
+
+/**
+  * @brief  Carrier-band Fourier coefficients of n pwm periods
+  * @param  pCmp compare values, n x 3 (U, V, W of period i at 3i..3i+2), s
+  * @param  pInv inverted carrier flags, n x 3, NULL for none
+  * @param  pTk period lengths, n, s
+  * @param  n number of periods
+  * @param  K highest carrier harmonic
+  * @param  Vbus pulse height (V)
+  * @param  pA result, n x 3 x (K+1): a_0..a_K of phase ph of period i at
+  *         pA[(3i + ph)(K + 1)], cosine terms about the period start
+  */
+void PWM_Period_Coeffs( const double * pCmp, const uint8_t * pInv,
+                        const double * pTk, uint32_t n, uint32_t K,
+                        double Vbus, double * pA )
+{
+  uint32_t i;
+  uint32_t k;
+
+  for ( i = 0; i < 3 * n; i++ )
+  {
+    const double d = SVPWM_Duty( pCmp[i], pTk[i / 3] );
+    double * a   = pA + ( size_t )i * ( K + 1 );
+    double   c2  = 2.0 * cos( PI * d );
+    double   s0  = 0.0;            /* sin(pi (k-1) d) */
+    double   s1  = sin( PI * d );  /* sin(pi k d)     */
+    double   s2;
+    /* a pulse centered at Tk/2 is the same shifted by half a period:
+       a_k * (-1)^k */
+    double   g   = 2.0 * Vbus / PI;
+    double   sgn = ( pInv != NULL && pInv[i] ) ? -1.0 : 1.0;
+
+    a[0] = Vbus * d;
+    for ( k = 1; k <= K; k++ )
+    {
+      g   *= sgn;
+      a[k] = g * s1 / k;
+      /* sin(pi (k+1) d) = 2 cos(pi d) sin(pi k d) - sin(pi (k-1) d) */
+      s2 = c2 * s1 - s0;
+      s0 = s1;
+      s1 = s2;
+    }
+  }
+}
+
+/***************  END OF FILE****/
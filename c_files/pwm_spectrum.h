@@ -0,0 +1,91 @@
+/**
+  ******************************************************************************
+  * @file    pwm_spectrum.h
+  * @brief   This file contains all definitions and functions prototypes for the
+  *          streaming harmonic analyzer of the U/V/W pwm outputs
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  * The phase voltages are 0/Vbus pulse trains, fully described per period
+  * by the compare values (svpwm_core.h). The Fourier integral of a pulse
+  * on [a, b] at w = h*2*pi*F1 is closed form,
+  *
+  *   X(h) = Vbus * ( exp(-j w a) - exp(-j w b) ) / ( j w )
+  *
+  * so every period adds its two pulses per phase to the harmonic bins
+  * h = 1..NHarm and no waveform is stored. The time axis is cut into
+  * windows of Cycles fundamental periods; pulses crossing a window end
+  * are split. At each window end the peak amplitudes (2/T)|X(h)| of U, V,
+  * W and of the line-to-line voltage U-V are taken and their squares
+  * averaged over the windows run so far.
+  *
+  * PWM_Period_Coeffs() gives the carrier-band view instead: over its own
+  * period Tk a phase is an even pulse train about the period start, high
+  * for duty d = Cmp/Tk, so
+  *
+  *   v(t) = a0 + sum_k a_k cos(2 pi k t / Tk),
+  *   a0 = Vbus d,  a_k = (2 Vbus / (pi k)) sin(pi k d)
+  *
+  * evaluated for many periods at once, one sin/cos per phase and period.
+  * Phases on the inverted carrier (pulse centered at Tk/2) get a_k (-1)^k.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PWM_SPECTRUM_H
+#define __PWM_SPECTRUM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+#define PWM_SPECTRUM_MAX_HARM 512
+
+typedef enum
+{
+  PWM_SPECTRUM_U  = 0,
+  PWM_SPECTRUM_V  = 1,
+  PWM_SPECTRUM_W  = 2,
+  PWM_SPECTRUM_UV = 3,   /**< line-to-line U - V */
+  PWM_SPECTRUM_NCH
+} PWM_Spectrum_Ch_t;
+
+typedef struct
+{
+  double   F1;          /**< fundamental (Hz), bin h is at h*F1          */
+  double   Vbus;        /**< pulse height (V)                            */
+  uint32_t NHarm;       /**< bins 1..NHarm                               */
+  double   Window;      /**< Cycles/F1 (s)                               */
+  double   Tw0;         /**< start of the open window (s)                */
+  double   Re[3][PWM_SPECTRUM_MAX_HARM];   /**< open window, U V W       */
+  double   Im[3][PWM_SPECTRUM_MAX_HARM];
+  double   SumSq[PWM_SPECTRUM_NCH][PWM_SPECTRUM_MAX_HARM];
+  uint32_t Windows;     /**< windows closed                              */
+} PWM_Spectrum_t;
+
+/* Exported functions ------------------------------------------------------- */
+
+int    PWM_Spectrum_Init( PWM_Spectrum_t * pSpec, double F1, uint32_t NHarm,
+                          uint32_t Cycles, double Vbus );
+void   PWM_Spectrum_Reset( PWM_Spectrum_t * pSpec, double t0 );
+void   PWM_Spectrum_Add_Period( PWM_Spectrum_t * pSpec, double t0, double Tk,
+                                const double * pCmp, const uint8_t * pInv );
+double PWM_Spectrum_Magnitude( const PWM_Spectrum_t * pSpec,
+                               PWM_Spectrum_Ch_t Ch, uint32_t h );
+double PWM_Spectrum_Wthd( const PWM_Spectrum_t * pSpec, PWM_Spectrum_Ch_t Ch );
+void   PWM_Period_Coeffs( const double * pCmp, const uint8_t * pInv,
+                          const double * pTk, uint32_t n, uint32_t K,
+                          double Vbus, double * pA );
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __PWM_SPECTRUM_H */
+
+/* *****END OF FILE****/
@@ -0,0 +1,125 @@
+/**
+  ******************************************************************************
+  * @file    pwm_stats.c
+  * @brief   This file provides the run-time counters of the voltage chain,
+  *          see pwm_stats.h
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * license info:
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "pwm_stats.h"
+
+/* percentage, 0 for no calls */
+static double PWM_Stats_Pct( uint64_t n, uint64_t total )
+{
+  return ( ( total > 0u ) ? 100.0 * (double)n / (double)total : 0.0 );
+}
+
+/**
+  * @brief  All counters cleared, no sector yet
+  */
+void PWM_Stats_Reset( PWM_Stats_t * pStats )
+{
+  memset( pStats, 0, sizeof( PWM_Stats_t ) );
+}
+
+/**
+  * @brief  One Circle_Limitation() call
+  * @param  Index table index from Circle_Limitation_Indexed(), -1 = not
+  *         limited
+  */
+void PWM_Stats_Limit( PWM_Stats_t * pStats, int32_t Index )
+{
+  pStats->LimitCalls++;
+  if ( Index >= 0 )
+  {
+    pStats->LimitHits++;
+    if ( (uint32_t)Index < PWM_STATS_TABLE )
+    {
+      pStats->TableHist[Index]++;
+    }
+  }
+}
+
+/**
+  * @brief  One pwm period
+  * @param  pTiming its timing, Sector 1..6, Tz and Ts as computed (before
+  *         any timer quantization)
+  */
+void PWM_Stats_Period( PWM_Stats_t * pStats, const SVPWM_Timing_t * pTiming )
+{
+  int16_t s = pTiming->Sector;
+
+  pStats->Periods++;
+  pStats->Overmod += ( pTiming->Tz < 0.0 ) ? 1u : 0u;
+  if ( s >= 1 && s <= 6 )
+  {
+    pStats->SectorChanges += ( pStats->Sector != 0 && s != pStats->Sector ) ? 1u : 0u;
+    pStats->SectorPeriods[s]++;
+    pStats->SectorTime[s] += pTiming->Ts;
+    pStats->Sector = s;
+  }
+}
+
+/**
+  * @brief  Report of the counters that saw any calls
+  * @param  pTitle line prefix, e.g. the block path
+  * @param  pPrint printf-like output, ssPrintf in an S-function
+  */
+void PWM_Stats_Dump( const PWM_Stats_t * pStats, const char * pTitle,
+                     PWM_Stats_Print_Fn pPrint )
+{
+  double   time = 0.0;
+  uint32_t i;
+
+  if ( pStats->LimitCalls > 0u )
+  {
+    pPrint( "%s: circle limitation %llu of %llu calls (%.3f %%)\n", pTitle,
+            (unsigned long long)pStats->LimitHits,
+            (unsigned long long)pStats->LimitCalls,
+            PWM_Stats_Pct( pStats->LimitHits, pStats->LimitCalls ) );
+    if ( pStats->LimitHits > 0u )
+    {
+      pPrint( "  table index:count" );
+      for ( i = 0u; i < PWM_STATS_TABLE; i++ )
+      {
+        if ( pStats->TableHist[i] != 0u )
+        {
+          pPrint( " %u:%llu", i, (unsigned long long)pStats->TableHist[i] );
+        }
+      }
+      pPrint( "\n" );
+    }
+  }
+
+  if ( pStats->Periods > 0u )
+  {
+    for ( i = 1u; i <= 6u; i++ )
+    {
+      time += pStats->SectorTime[i];
+    }
+    pPrint( "%s: %llu periods, overmodulated %llu (%.3f %%), "
+            "%llu sector changes\n", pTitle,
+            (unsigned long long)pStats->Periods,
+            (unsigned long long)pStats->Overmod,
+            PWM_Stats_Pct( pStats->Overmod, pStats->Periods ),
+            (unsigned long long)pStats->SectorChanges );
+    pPrint( "  %-6s %12s %12s %8s\n", "sector", "periods", "time_s", "share" );
+    for ( i = 1u; i <= 6u; i++ )
+    {
+      pPrint( "  %-6u %12llu %12.6g %7.2f%%\n", i,
+              (unsigned long long)pStats->SectorPeriods[i],
+              pStats->SectorTime[i],
+              ( time > 0.0 ) ? 100.0 * pStats->SectorTime[i] / time : 0.0 );
+    }
+  }
+}
+
+/***************  END OF FILE****/
@@ -0,0 +1,70 @@
+/**
+  ******************************************************************************
+  * @file    pwm_stats.h
+  * @brief   This file contains all definitions and functions prototypes for the
+  *          run-time counters of the voltage chain: circle limitation hits,
+  *          overmodulation and sector residence
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  * One PWM_Stats_t per block instance or engine, updated by its own
+  * thread only, so the counters are plain increments:
+  *   PWM_Stats_Limit()   per Circle_Limitation() call, with the index
+  *                       Circle_Limitation_Indexed() reports: hits and the
+  *                       histogram of the table elements used
+  *   PWM_Stats_Period()  per pwm period: Tz < 0 (del3 negative, the
+  *                       request outside the hexagon), periods and time
+  *                       spent in each sector, sector changes
+  * The hit ratio shows whether the unlimited fast path is the common case.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PWM_STATS_H
+#define __PWM_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "circle_limitation.h"
+#include "svpwm_core.h"
+
+/* Circle_limit_table elements */
+#define PWM_STATS_TABLE ( sizeof( ( (CircleLimitation_Handle_t *)0 )->Circle_limit_table ) / \
+                          sizeof( uint16_t ) )
+
+typedef struct
+{
+  uint64_t LimitCalls;                  /**< Circle_Limitation() calls      */
+  uint64_t LimitHits;                   /**< calls that scaled Vqd          */
+  uint64_t TableHist[PWM_STATS_TABLE];  /**< hits per table index           */
+  uint64_t Periods;                     /**< pwm periods                    */
+  uint64_t Overmod;                     /**< periods with Tz < 0            */
+  uint64_t SectorChanges;
+  uint64_t SectorPeriods[7];            /**< periods in sector 1..6         */
+  double   SectorTime[7];               /**< time in sector 1..6 (s)        */
+  int16_t  Sector;                      /**< sector of the last period      */
+} PWM_Stats_t;
+
+typedef int ( *PWM_Stats_Print_Fn )( const char *, ... );
+
+/* Exported functions ------------------------------------------------------- */
+
+void PWM_Stats_Reset( PWM_Stats_t * pStats );
+void PWM_Stats_Limit( PWM_Stats_t * pStats, int32_t Index );
+void PWM_Stats_Period( PWM_Stats_t * pStats, const SVPWM_Timing_t * pTiming );
+void PWM_Stats_Dump( const PWM_Stats_t * pStats, const char * pTitle,
+                     PWM_Stats_Print_Fn pPrint );
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __PWM_STATS_H */
+
+/* *****END OF FILE****/
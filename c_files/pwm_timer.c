@@ -0,0 +1,126 @@
+/**
+  ******************************************************************************
+  * @file    pwm_timer.c
+  * @brief   This file provides the center-aligned MCU timer emulation, see
+  *          pwm_timer.h
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * license info:
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "pwm_timer.h"
+
+/**
+  * @brief  Auto-reload value of a period
+  * @param  Ts pwm period (s)
+  * @retval ARR, the configured one or round(Ts*Fclk/2), at least 1
+  */
+uint32_t PWM_Timer_Arr( const PWM_Timer_Config_t * pCfg, double Ts )
+{
+  double arr = 0.5 * Ts * pCfg->Fclk + 0.5;
+
+  if ( pCfg->Arr != 0u )
+  {
+    return ( pCfg->Arr );
+  }
+  return ( ( arr < 1.0 ) ? 1u : (uint32_t)arr );
+}
+
+/**
+  * @brief  Compare values of one period to timer counts, rounded to the
+  *         nearest count
+  * @param  pTiming compare values over pTiming->Ts
+  * @param  Arr auto-reload of that period
+  * @param  pRegs register values the ISR writes
+  */
+void PWM_Timer_Quantize( const SVPWM_Timing_t * pTiming, uint32_t Arr,
+                         PWM_Timer_Regs_t * pRegs )
+{
+  int i;
+
+  for ( i = 0; i < 3; i++ )
+  {
+    double d = SVPWM_Duty( pTiming->Cmp[i], pTiming->Ts );
+
+    pRegs->Ccr[i] = (uint32_t)( d * (double)Arr + 0.5 );
+    pRegs->Inv[i] = pTiming->Inv[i];
+  }
+}
+
+/**
+  * @brief  Preload and shadow registers cleared, all channels off
+  */
+void PWM_Timer_Reset( PWM_Timer_t * pTimer )
+{
+  memset( pTimer, 0, sizeof( PWM_Timer_t ) );
+}
+
+/**
+  * @brief  ISR write of the compare registers, to the preload registers,
+  *         and to the shadow ones too without preload
+  */
+void PWM_Timer_Write( const PWM_Timer_Config_t * pCfg,
+                      PWM_Timer_t * pTimer,
+                      const PWM_Timer_Regs_t * pRegs )
+{
+  pTimer->Preload = *pRegs;
+  if ( pCfg->Update == PWM_TIMER_DIRECT )
+  {
+    pTimer->Shadow = *pRegs;
+  }
+}
+
+/**
+  * @brief  Update event at the counter underflow (period start): shadow
+  *         registers loaded from the preload ones
+  */
+void PWM_Timer_Update_Event( PWM_Timer_t * pTimer )
+{
+  pTimer->Shadow = pTimer->Preload;
+}
+
+/**
+  * @brief  Registers the compare logic uses
+  * @param  SecondHalf 1 after the counter overflow (down-counting half)
+  * @retval shadow registers, with PWM_TIMER_PRELOAD_HALF the preload ones
+  *         in the second half, loaded by the overflow update event
+  */
+const PWM_Timer_Regs_t * PWM_Timer_Active( const PWM_Timer_Config_t * pCfg,
+                                           const PWM_Timer_t * pTimer,
+                                           int SecondHalf )
+{
+  if ( pCfg->Update == PWM_TIMER_PRELOAD_HALF && SecondHalf )
+  {
+    return ( &pTimer->Preload );
+  }
+  return ( &pTimer->Shadow );
+}
+
+/**
+  * @brief  Compare values the registers produce
+  * @param  Arr auto-reload of the running period
+  * @param  pTiming Ts in, Cmp and Inv replaced; T1, T2, sector etc. of
+  *         the request are kept
+  */
+void PWM_Timer_Timing( const PWM_Timer_Regs_t * pRegs, uint32_t Arr,
+                       SVPWM_Timing_t * pTiming )
+{
+  const double k = pTiming->Ts / (double)Arr;
+  int          i;
+
+  for ( i = 0; i < 3; i++ )
+  {
+    uint32_t ccr = ( pRegs->Ccr[i] > Arr ) ? Arr : pRegs->Ccr[i];
+
+    pTiming->Cmp[i] = (double)ccr * k;
+    pTiming->Inv[i] = pRegs->Inv[i];
+  }
+}
+
+/***************  END OF FILE****/
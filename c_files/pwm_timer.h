@@ -0,0 +1,93 @@
+/**
+  ******************************************************************************
+  * @file    pwm_timer.h
+  * @brief   This file contains all definitions and functions prototypes for the
+  *          center-aligned MCU timer emulation, compare values quantized to
+  *          CCR/ARR counts with preload (shadow) registers
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  * A center-aligned timer clocked at Fclk counts 0 -> ARR -> 0 over one pwm
+  * period, Ts = 2*ARR/Fclk, and a channel in pwm mode 1 is active while
+  * CNT < CCR. That is the svpwm carrier in counts: Cmp = CCR*Ts/ARR, so
+  * CCR = round(Cmp/Ts*ARR), limited to 0..ARR (0 and 100 %). A phase on
+  * the inverted carrier (Inv, svpwm_core.h) is a channel in pwm mode 2 with
+  * the same CCR.
+  *
+  * CCR writes of the control ISR go to the preload register; the compare
+  * logic uses the shadow register, loaded from the preload at the update
+  * event:
+  *   PWM_TIMER_DIRECT   no preload, a write takes effect at once
+  *   PWM_TIMER_PRELOAD  update event at underflow only (repetition counter
+  *                      1): values written in period k run in period k+1
+  *   PWM_TIMER_PRELOAD_HALF  update event at underflow and overflow
+  *                      (repetition counter 0): values written in the
+  *                      first half of period k run from its second half
+  *
+  * The ISR is assumed done before the next update event.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PWM_TIMER_H
+#define __PWM_TIMER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "svpwm_core.h"
+
+typedef enum
+{
+  PWM_TIMER_DIRECT       = 0,  /**< no preload                          */
+  PWM_TIMER_PRELOAD      = 1,  /**< update event once per period        */
+  PWM_TIMER_PRELOAD_HALF = 2   /**< update event every half period      */
+} PWM_Timer_Update_t;
+
+typedef struct
+{
+  double             Fclk;    /**< timer clock (Hz)                       */
+  uint32_t           Arr;     /**< auto-reload, 0 = round(Ts*Fclk/2)      */
+  PWM_Timer_Update_t Update;
+} PWM_Timer_Config_t;
+
+typedef struct
+{
+  uint32_t Ccr[3];   /**< compare registers U, V, W (counts)         */
+  uint8_t  Inv[3];   /**< channel in pwm mode 2                      */
+} PWM_Timer_Regs_t;
+
+typedef struct
+{
+  PWM_Timer_Regs_t Preload;
+  PWM_Timer_Regs_t Shadow;
+} PWM_Timer_t;
+
+/* Exported functions ------------------------------------------------------- */
+
+uint32_t PWM_Timer_Arr( const PWM_Timer_Config_t * pCfg, double Ts );
+void     PWM_Timer_Quantize( const SVPWM_Timing_t * pTiming, uint32_t Arr,
+                             PWM_Timer_Regs_t * pRegs );
+void     PWM_Timer_Reset( PWM_Timer_t * pTimer );
+void     PWM_Timer_Write( const PWM_Timer_Config_t * pCfg,
+                          PWM_Timer_t * pTimer,
+                          const PWM_Timer_Regs_t * pRegs );
+void     PWM_Timer_Update_Event( PWM_Timer_t * pTimer );
+const PWM_Timer_Regs_t * PWM_Timer_Active( const PWM_Timer_Config_t * pCfg,
+                                           const PWM_Timer_t * pTimer,
+                                           int SecondHalf );
+void     PWM_Timer_Timing( const PWM_Timer_Regs_t * pRegs, uint32_t Arr,
+                           SVPWM_Timing_t * pTiming );
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __PWM_TIMER_H */
+
+/* *****END OF FILE****/
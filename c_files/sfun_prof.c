@@ -0,0 +1,142 @@
+/**
+  ******************************************************************************
+  * @file    sfun_prof.c
+  * @brief   This file provides the per-stage cycle profiling of the S-function
+  *          outputs, see sfun_prof.h
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * license info:
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "sfun_prof.h"
+
+/* log2 bin of a tick count */
+static uint32_t SFun_Prof_Bin( uint64_t Ticks )
+{
+  uint32_t b = 0u;
+
+#if defined( __GNUC__ )
+  b = ( Ticks != 0u ) ? 63u - (uint32_t)__builtin_clzll( Ticks ) : 0u;
+#else
+  while ( Ticks >>= 1 )
+  {
+    b++;
+  }
+#endif
+  return ( ( b < SFUN_PROF_BINS ) ? b : SFUN_PROF_BINS - 1u );
+}
+
+/* upper edge of the bin holding fraction q of the calls */
+static uint64_t SFun_Prof_Quantile( const SFun_Prof_Stage_t * pStage, double q )
+{
+  uint64_t n   = 0u;
+  uint32_t b;
+
+  for ( b = 0u; b < SFUN_PROF_BINS - 1u; b++ )
+  {
+    n += pStage->Hist[b];
+    if ( (double)n >= q * (double)pStage->Count )
+    {
+      break;
+    }
+  }
+  return ( (uint64_t)2u << b );
+}
+
+/**
+  * @brief  Empty histograms
+  * @param  pNames stage names, NStages, kept by pointer
+  * @param  NStages number of stages, at most SFUN_PROF_STAGES
+  */
+void SFun_Prof_Init( SFun_Prof_t * pProf, const char * const * pNames,
+                     uint32_t NStages )
+{
+  uint32_t s;
+
+  memset( pProf, 0, sizeof( SFun_Prof_t ) );
+  pProf->NStages = ( NStages < SFUN_PROF_STAGES ) ? NStages : SFUN_PROF_STAGES;
+  for ( s = 0u; s < pProf->NStages; s++ )
+  {
+    pProf->Stage[s].Name = pNames[s];
+    pProf->Stage[s].Min  = UINT64_MAX;
+  }
+}
+
+/**
+  * @brief  One call of a stage
+  * @param  Ticks duration (ticks)
+  */
+void SFun_Prof_Add( SFun_Prof_t * pProf, uint32_t Stage, uint64_t Ticks )
+{
+  SFun_Prof_Stage_t * pStage;
+
+  if ( Stage >= pProf->NStages )
+  {
+    return;
+  }
+  pStage = &pProf->Stage[Stage];
+  pStage->Count++;
+  pStage->Sum += Ticks;
+  pStage->Min  = ( Ticks < pStage->Min ) ? Ticks : pStage->Min;
+  pStage->Max  = ( Ticks > pStage->Max ) ? Ticks : pStage->Max;
+  pStage->Hist[SFun_Prof_Bin( Ticks )]++;
+}
+
+/**
+  * @brief  Table of the stages: calls, mean, min, median and 99 % bin
+  *         edges, max, then the occupied bins as log2:count
+  * @param  pTitle first line, e.g. the block path
+  * @param  pPrint printf-like output, ssPrintf in an S-function
+  */
+void SFun_Prof_Dump( const SFun_Prof_t * pProf, const char * pTitle,
+                     SFun_Prof_Print_Fn pPrint )
+{
+  double   total = 0.0;
+  uint32_t s;
+  uint32_t b;
+
+#if defined( SFUN_PROF_TSC )
+  pPrint( "%s: profile, rdtsc ticks per call\n", pTitle );
+#else
+  pPrint( "%s: profile, ns per call\n", pTitle );
+#endif
+  pPrint( "  %-10s %10s %10s %8s %8s %8s %10s\n",
+          "stage", "calls", "mean", "min", "p50<", "p99<", "max" );
+  for ( s = 0u; s < pProf->NStages; s++ )
+  {
+    const SFun_Prof_Stage_t * pStage = &pProf->Stage[s];
+    double mean;
+
+    if ( pStage->Count == 0u )
+    {
+      pPrint( "  %-10s %10u\n", pStage->Name, 0u );
+      continue;
+    }
+    mean = (double)pStage->Sum / (double)pStage->Count;
+    total += mean;
+    pPrint( "  %-10s %10llu %10.1f %8llu %8llu %8llu %10llu\n", pStage->Name,
+            (unsigned long long)pStage->Count, mean,
+            (unsigned long long)pStage->Min,
+            (unsigned long long)SFun_Prof_Quantile( pStage, 0.5 ),
+            (unsigned long long)SFun_Prof_Quantile( pStage, 0.99 ),
+            (unsigned long long)pStage->Max );
+    pPrint( "  %-10s", "" );
+    for ( b = 0u; b < SFUN_PROF_BINS; b++ )
+    {
+      if ( pStage->Hist[b] != 0u )
+      {
+        pPrint( " %u:%llu", b, (unsigned long long)pStage->Hist[b] );
+      }
+    }
+    pPrint( "\n" );
+  }
+  pPrint( "  %-10s %10s %10.1f\n", "total", "", total );
+}
+
+/***************  END OF FILE****/
@@ -0,0 +1,118 @@
+/**
+  ******************************************************************************
+  * @file    sfun_prof.h
+  * @brief   This file contains all definitions and functions prototypes for the
+  *          per-stage cycle profiling of the S-function outputs
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  * Compiled out unless SFUN_PROFILE is defined (mex -DSFUN_PROFILE ...):
+  * the SFUN_PROF_xxx macros then expand to nothing and the S-functions
+  * do not touch their profile PWork.
+  *
+  * mdlOutputs marks its start with SFUN_PROF_START() and the end of every
+  * stage with SFUN_PROF_STAGE(); the ticks since the previous mark go to
+  * that stage's log2 histogram, bin b counting [2^b, 2^(b+1)) ticks (bin
+  * 0 also 0 ticks). A tick is a time stamp counter cycle (rdtsc) on x86,
+  * a nanosecond of CLOCK_MONOTONIC elsewhere. Each block instance has its
+  * own SFun_Prof_t and Simulink runs an instance's methods on one thread,
+  * so the counters are plain increments, no locks and no atomics.
+  * SFun_Prof_Dump() prints the table at mdlTerminate.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SFUN_PROF_H
+#define __SFUN_PROF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#include <x86intrin.h>
+#define SFUN_PROF_TSC
+#elif defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_IX86 ) )
+#include <intrin.h>
+#define SFUN_PROF_TSC
+#else
+#include <time.h>
+#endif
+
+#define SFUN_PROF_BINS   48   /**< log2 bins, up to 2^48 ticks   */
+#define SFUN_PROF_STAGES 12   /**< stages per instance, at most  */
+
+typedef struct
+{
+  const char * Name;
+  uint64_t     Count;
+  uint64_t     Sum;                    /**< ticks                  */
+  uint64_t     Min;
+  uint64_t     Max;
+  uint64_t     Hist[SFUN_PROF_BINS];
+} SFun_Prof_Stage_t;
+
+typedef struct
+{
+  uint32_t          NStages;
+  uint64_t          Mark;              /**< time stamp of the last mark */
+  SFun_Prof_Stage_t Stage[SFUN_PROF_STAGES];
+} SFun_Prof_t;
+
+typedef int ( *SFun_Prof_Print_Fn )( const char *, ... );
+
+/* time stamp, rdtsc or CLOCK_MONOTONIC ns */
+static inline uint64_t SFun_Prof_Ticks( void )
+{
+#if defined( SFUN_PROF_TSC )
+  return ( (uint64_t)__rdtsc() );
+#else
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ( (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec );
+#endif
+}
+
+/* Exported functions ------------------------------------------------------- */
+
+void SFun_Prof_Init( SFun_Prof_t * pProf, const char * const * pNames,
+                     uint32_t NStages );
+void SFun_Prof_Add( SFun_Prof_t * pProf, uint32_t Stage, uint64_t Ticks );
+void SFun_Prof_Dump( const SFun_Prof_t * pProf, const char * pTitle,
+                     SFun_Prof_Print_Fn pPrint );
+
+/* mark the start of a call */
+static inline void SFun_Prof_Start( SFun_Prof_t * pProf )
+{
+  pProf->Mark = SFun_Prof_Ticks();
+}
+
+/* mark the end of Stage, the start of the next one */
+static inline void SFun_Prof_Stage( SFun_Prof_t * pProf, uint32_t Stage )
+{
+  uint64_t t = SFun_Prof_Ticks();
+
+  SFun_Prof_Add( pProf, Stage, t - pProf->Mark );
+  pProf->Mark = t;
+}
+
+#if defined( SFUN_PROFILE )
+#define SFUN_PROF_START( pProf )        SFun_Prof_Start( (SFun_Prof_t *)( pProf ) )
+#define SFUN_PROF_STAGE( pProf, Stage ) SFun_Prof_Stage( (SFun_Prof_t *)( pProf ), ( Stage ) )
+#else
+#define SFUN_PROF_START( pProf )        ( (void)0 )
+#define SFUN_PROF_STAGE( pProf, Stage ) ( (void)0 )
+#endif
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __SFUN_PROF_H */
+
+/* *****END OF FILE****/
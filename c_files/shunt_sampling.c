@@ -0,0 +1,233 @@
+/**
+  ******************************************************************************
+  * @file    shunt_sampling.c
+  * @brief   This file provides the single-shunt and two-shunt current sampling
+  *          windows of a pwm period, see shunt_sampling.h
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * license info:
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "shunt_sampling.h"
+
+#define SHUNT_TOL 1e-12   /* s, rounding of edges shifted to the window */
+
+/* phase x high at time t of the period */
+static int Shunt_High( const Shunt_Sampling_t * pSmp, int x, double t )
+{
+  int inside = ( t > pSmp->Edge[0][x] ) && ( t < pSmp->Edge[1][x] );
+
+  return ( pSmp->Inv[x] ? inside : !inside );
+}
+
+/* single-shunt phase shift: stretch the two active vectors of the first
+   half period to Tmin, keeping every duty */
+static void Shunt_Shift( Shunt_Sampling_t * pSmp, double Tmin )
+{
+  double (*e)[3] = pSmp->Edge;
+  int    a = 0;   /* first edge, min phase */
+  int    b = 1;
+  int    c = 2;   /* last edge, max phase  */
+  int    k;
+  double s;
+
+  if ( e[0][b] < e[0][a] ) { k = a; a = b; b = k; }
+  if ( e[0][c] < e[0][b] ) { k = b; b = c; c = k; }
+  if ( e[0][b] < e[0][a] ) { k = a; a = b; b = k; }
+
+  s = Tmin - ( e[0][c] - e[0][b] );
+  if ( s > pSmp->Ts - e[1][c] )
+  {
+    s = pSmp->Ts - e[1][c];
+  }
+  if ( s > 0.0 )
+  {
+    e[0][c] += s;
+    e[1][c] += s;
+    pSmp->Flags |= SHUNT_FLAG_SHIFTED;
+  }
+
+  s = Tmin - ( e[0][b] - e[0][a] );
+  if ( s > e[0][a] )
+  {
+    s = e[0][a];
+  }
+  if ( s > 0.0 )
+  {
+    e[0][a] -= s;
+    e[1][a] -= s;
+    pSmp->Flags |= SHUNT_FLAG_SHIFTED;
+  }
+}
+
+/**
+  * @brief  Sampling instants of one period
+  * @param  pCfg shunt topology and ADC timing
+  * @param  pTiming compare values, from SVPWM_Calc_Timing() and
+  *         SVPWM_Apply_Modulation()
+  * @param  pSmp phase edges (shifted if enabled), sample times and flags
+  */
+void Shunt_Sampling( const Shunt_Config_t * pCfg,
+                     const SVPWM_Timing_t * pTiming,
+                     Shunt_Sampling_t * pSmp )
+{
+  const double Ts     = pTiming->Ts;
+  const double target = 0.5 * ( Ts - pCfg->Tsample );
+  double       edge[7];
+  double       best   = -1.0;
+  int          ne     = 0;
+  int          inv    = 0;
+  int          n      = 0;
+  int          i;
+  int          j;
+  int          x;
+
+  pSmp->Ts = Ts;
+  pSmp->Flags = 0u;
+  for ( x = 0; x < 3; x++ )
+  {
+    double w = SVPWM_Duty( pTiming->Cmp[x], Ts ) * Ts;
+
+    pSmp->Inv[x] = pTiming->Inv[x];
+    pSmp->Edge[0][x] = pTiming->Inv[x] ? 0.5 * ( Ts - w ) : 0.5 * w;
+    pSmp->Edge[1][x] = pTiming->Inv[x] ? 0.5 * ( Ts + w ) : Ts - 0.5 * w;
+    inv |= pTiming->Inv[x];
+  }
+  for ( i = 0; i < 2; i++ )
+  {
+    pSmp->t[i] = 0.0;
+    pSmp->Phase[i] = 0;
+  }
+
+  if ( pCfg->Topology == SHUNT_SINGLE && pCfg->Shift && !inv )
+  {
+    Shunt_Shift( pSmp, pCfg->Trise + pCfg->Tsample );
+  }
+
+  /* edges inside the period, sorted; a phase without a pulse has none */
+  for ( x = 0; x < 3; x++ )
+  {
+    if ( pSmp->Edge[1][x] <= pSmp->Edge[0][x] )
+    {
+      continue;
+    }
+    for ( i = 0; i < 2; i++ )
+    {
+      double v = pSmp->Edge[i][x];
+
+      if ( v > 0.0 && v < Ts )
+      {
+        for ( j = ne++; j > 0 && edge[j - 1] > v; j-- )
+        {
+          edge[j] = edge[j - 1];
+        }
+        edge[j] = v;
+      }
+    }
+  }
+  edge[ne] = Ts;
+
+  /* constant switching state on [from, to], sample in [start, last] */
+  for ( i = 0; i <= ne; i++ )
+  {
+    double from  = ( i > 0 ) ? edge[i - 1] : 0.0;
+    double to    = edge[i];
+    double start = ( i > 0 ) ? from + pCfg->Trise : from;
+    double last  = to - pCfg->Tsample;
+    double mid   = 0.5 * ( from + to );
+    int    high[3];
+    int    nh;
+
+    if ( last + SHUNT_TOL < start )
+    {
+      continue;
+    }
+    for ( x = 0; x < 3; x++ )
+    {
+      high[x] = Shunt_High( pSmp, x, mid );
+    }
+    nh = high[0] + high[1] + high[2];
+
+    if ( pCfg->Topology == SHUNT_TWO )
+    {
+      double t = ( target < start ) ? start : ( ( target > last ) ? last : target );
+      double d = ( t > target ) ? t - target : target - t;
+
+      if ( !high[0] && !high[1] && ( best < 0.0 || d < best ) )
+      {
+        best = d;
+        pSmp->t[0] = t;
+        pSmp->t[1] = t;
+        pSmp->Phase[0] = 1;
+        pSmp->Phase[1] = 2;
+        n = 2;
+      }
+    }
+    else if ( n < 2 && ( nh == 1 || nh == 2 ) )
+    {
+      int8_t code = 0;
+
+      for ( x = 0; x < 3; x++ )
+      {
+        if ( high[x] == ( nh == 1 ) )
+        {
+          code = (int8_t)( ( nh == 1 ) ? x + 1 : -( x + 1 ) );
+        }
+      }
+      if ( n == 0 || ( pSmp->Phase[0] != code && pSmp->Phase[0] != -code ) )
+      {
+        pSmp->t[n] = start;
+        pSmp->Phase[n] = code;
+        n++;
+      }
+    }
+  }
+
+  if ( n < 2 )
+  {
+    pSmp->Flags |= SHUNT_FLAG_SHORT;
+  }
+}
+
+/**
+  * @brief  Sampling instants of n periods
+  * @retval number of periods flagged SHUNT_FLAG_SHORT
+  */
+uint32_t Shunt_Sampling_Batch( const Shunt_Config_t * pCfg,
+                               const SVPWM_Timing_t * pTiming, uint32_t n,
+                               Shunt_Sampling_t * pSmp )
+{
+  uint32_t nShort = 0u;
+  uint32_t k;
+
+  for ( k = 0u; k < n; k++ )
+  {
+    Shunt_Sampling( pCfg, &pTiming[k], &pSmp[k] );
+    nShort += ( pSmp[k].Flags & SHUNT_FLAG_SHORT ) ? 1u : 0u;
+  }
+  return ( nShort );
+}
+
+/**
+  * @brief  Half-bridge levels at time t of the period, phase shifted
+  *         edges included
+  * @param  t time since the period start, 0..Ts (s)
+  * @param  pUVW U, V, W levels, 0 or Vbus
+  */
+void Shunt_Phase_Levels( const Shunt_Sampling_t * pSmp, double t,
+                         double Vbus, double * pUVW )
+{
+  int x;
+
+  for ( x = 0; x < 3; x++ )
+  {
+    pUVW[x] = Shunt_High( pSmp, x, t ) ? Vbus : 0.0;
+  }
+}
+
+/***************  END OF FILE****/
@@ -0,0 +1,100 @@
+/**
+  ******************************************************************************
+  * @file    shunt_sampling.h
+  * @brief   This file contains all definitions and functions prototypes for the
+  *          single-shunt and two-shunt current sampling windows of a pwm
+  *          period
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  * A period of center-aligned pwm (svpwm_core.h) is a sequence of switching
+  * states between the phase edges. A shunt reads a phase current only
+  * during some states, and only Trise after the last edge of any phase
+  * (ringing) for Tsample (ADC sample and hold):
+  *
+  *   two-shunt     low-side shunts in U and V, both low sides on; W is
+  *                 -(U + V). Sampled as close to the period middle as
+  *                 possible, where the current equals its period average
+  *   single-shunt  DC link shunt, an active vector with one phase high
+  *                 carries +i of that phase, one with two phases high -i
+  *                 of the low one. Two active vectors with different
+  *                 phases give the three currents, the first usable of
+  *                 each is sampled
+  *
+  * At high modulation (two-shunt) or near sector boundaries and at low
+  * modulation (single-shunt) the windows get shorter than Trise + Tsample
+  * and the period is flagged SHUNT_FLAG_SHORT. For single-shunt the short
+  * active vectors can be stretched by phase shifting: in the first half of
+  * the period the edge of the max phase moves later and the edge of the
+  * min phase earlier until both windows are Trise + Tsample long, their
+  * second half edges move the same way so every duty is unchanged
+  * (asymmetric pulses, the timer compare value changes at the period
+  * middle). Phase shifting needs all phases on the normal carrier
+  * (SVPWM_MOD_SVPWM) and is skipped otherwise.
+  *
+  * Phase x is described by its two edges Edge[0][x] <= Edge[1][x] in the
+  * period: high outside [Edge[0], Edge[1]], or inside with Inv set.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SHUNT_SAMPLING_H
+#define __SHUNT_SAMPLING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "svpwm_core.h"
+
+#define SHUNT_FLAG_SHORT    0x01u  /**< currents not reconstructible      */
+#define SHUNT_FLAG_SHIFTED  0x02u  /**< single-shunt edges phase shifted  */
+
+typedef enum
+{
+  SHUNT_TWO    = 0,   /**< low-side shunts in U and V               */
+  SHUNT_SINGLE = 1    /**< one DC link shunt                        */
+} Shunt_Topology_t;
+
+typedef struct
+{
+  Shunt_Topology_t Topology;
+  double           Trise;    /**< settling after any edge (s)           */
+  double           Tsample;  /**< ADC sample and hold (s)               */
+  uint8_t          Shift;    /**< single-shunt: phase shift short
+                                  active vectors                        */
+} Shunt_Config_t;
+
+typedef struct
+{
+  double  Ts;          /**< period (s)                                   */
+  double  Edge[2][3];  /**< phase edges in the period (s), after shift   */
+  uint8_t Inv[3];      /**< high between the edges                       */
+  double  t[2];        /**< sample start times in the period (s)         */
+  int8_t  Phase[2];    /**< current read at t[i]: +x or -x for +/-i of
+                            phase x = 1..3, 0 = no sample                */
+  uint8_t Flags;       /**< SHUNT_FLAG_xxx                               */
+} Shunt_Sampling_t;
+
+/* Exported functions ------------------------------------------------------- */
+
+void     Shunt_Sampling( const Shunt_Config_t * pCfg,
+                         const SVPWM_Timing_t * pTiming,
+                         Shunt_Sampling_t * pSmp );
+uint32_t Shunt_Sampling_Batch( const Shunt_Config_t * pCfg,
+                               const SVPWM_Timing_t * pTiming, uint32_t n,
+                               Shunt_Sampling_t * pSmp );
+void     Shunt_Phase_Levels( const Shunt_Sampling_t * pSmp, double t,
+                             double Vbus, double * pUVW );
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __SHUNT_SAMPLING_H */
+
+/* *****END OF FILE****/
@@ -3,15 +3,127 @@
  *
  *  Simulate SVMPWM for 3-phase PMSM motor for FOC
  *
- *  parameters: Vbus, Ts (2 parameters set before run-time)
- *  inputs:     Valpha, Vbeta SCALED to signed 14-bit
- *              discrete time @ PWM rate pulse train
+ *  parameters: Vbus, Ts, Options (3 parameters set before run-time)
+ *              Options = [] for the defaults, or a vector indexed by
+ *              OPT_xxx below; missing trailing elements take defaults:
+ *                OPT_PWM_MODE 0: fixed period Ts (default)
+ *                             1: variable period from input 2
+ *                             2: random period, uniform on
+ *                                Ts*(1 -/+ spread), input 2 unused
+ *                OPT_TS_MIN   shortest accepted period, default Ts/4
+ *                OPT_TS_MAX   longest accepted period, default 4*Ts
+ *                OPT_SPREAD   random mode spread, 0..1, default 0.1
+ *                OPT_SEED     random mode seed, default 1; same seed,
+ *                             same sequence of periods (pwm_rng.h)
+ *                OPT_SPEC_F1  harmonic analyzer fundamental, Hz,
+ *                             default 0 = analyzer off
+ *                OPT_SPEC_NH  analyzer harmonics, default 50
+ *                OPT_SPEC_CYC fundamental periods per analyzer window,
+ *                             default 1
+ *                OPT_MODULATION 0: svpwm (default), 1: AZSPWM,
+ *                             2: NSPWM, reduced common-mode variants,
+ *                             see svpwm_core.h
+ *                OPT_SECTOR   0: sector searched every sample (default)
+ *                             1: sector tracked from the previous sample,
+ *                             neighbours only, full search on a jump
+ *                             2: min/max zero-sequence engine, no sector
+ *                             search, same compare values (svpwm_core.h)
+ *                             the angle output is 0 in modes 1 and 2
+ *                OPT_FLOAT32  1: compare values computed in float32 like
+ *                             a single precision firmware (svpwm_real.h),
+ *                             sector mode 0 only; default 0 = double
+ *                OPT_VBUS     0: bus voltage is the Vbus parameter (default)
+ *                             1: measured bus on input 3, the Vbus
+ *                             parameter stays the nominal bus the inputs
+ *                             are normalized to; no compensation
+ *                             2: as 1, and bus ripple compensated: the
+ *                             dwell times scale by Vbus/Vbus_k, with the
+ *                             reciprocal 1/Vbus_k latched once per period
+ *                OPT_SHUNT    current sampling windows (shunt_sampling.h)
+ *                             0: off (default), 1: two-shunt,
+ *                             2: single-shunt, 3: single-shunt with
+ *                             phase shift of too short active vectors
+ *                OPT_TRISE    settling after a switching edge, default
+ *                             1.5e-6 s
+ *                OPT_TSAMPLE  ADC sample and hold, default 0.5e-6 s
+ *                OPT_TIMER    compare values quantized to center-aligned
+ *                             timer counts (pwm_timer.h), 0: off (default)
+ *                             1: no preload, 2: preload, update event at
+ *                             underflow, 3: preload, update event at
+ *                             underflow and overflow
+ *                OPT_FCLK     timer clock, default 170e6 Hz
+ *                OPT_ARR      auto-reload, default 0 = round(Ts_k*Fclk/2)
+ *                OPT_LEVELS   2: two-level inverter (default)
+ *                             3: three-level NPC / T-type (svpwm_3l.h),
+ *                             needs the defaults for modulation, sector,
+ *                             float32, shunt, timer and analyzer
+ *                OPT_KNP      three-level neutral point balancing gain,
+ *                             A/V, default 0 = redundant vectors split
+ *                             half and half
+ *                OPT_PHASES   3: three-phase (default)
+ *                             6: dual three-phase, two isolated star
+ *                             points 30 degrees apart, with vector space
+ *                             decomposition (svpwm_6ph.h); needs the
+ *                             defaults for levels, float32, shunt, timer
+ *                             and analyzer
+ *  inputs:     Valpha, Vbeta SCALED to signed 14-bit, six-phase:
+ *              Valpha, Vbeta, Vx, Vy
+ *              fixed mode:    discrete time @ PWM rate pulse train
+ *              variable mode: requested pwm period Ts_k, s, read at
+ *                             every period start
+ *              Vbus mode 1, 2: measured bus voltage Vbus_k, V
+ *              three-level, Knp > 0: Ia, Ib, Ic and the capacitor
+ *                             voltage difference upper - lower, V
  *  Outputs:    U, V, W and angle ramp and sector.
  *              (U,V & W) are voltage levels of Vbus or 0 (gnd)
+ *              port 2: Ts_k, the pwm period in use
+ *              port 3: line-line U-V WTHD and peak amplitudes of
+ *                      harmonics 1..NH, rms over the analyzer windows
+ *                      closed so far (pwm_spectrum.h); no waveform is
+ *                      stored, each period adds its pulse edges
+ *              port 4: common-mode voltage (U+V+W)/3 now and its
+ *                      period average, transitions in the period of
+ *                      U, V, W and their total, from the compare values
+ *              port 5: requested Valpha, Vbeta (V, on the nominal bus) and
+ *                      the period average Valpha, Vbeta the compare values
+ *                      achieve on the bus in use
+ *              port 6, shunt mode only: sample start times t1, t2 in
+ *                      the period, currents read +/-1..3 for +/-i of
+ *                      U, V, W (0 = none) and the SHUNT_FLAG_xxx flags
+ *              next port, timer mode only: ARR and CCR1..3 in effect
+ *  With phase shift U, V and W follow the shifted (asymmetric) edges.
+ *  Three-level: U, V, W are 0, Vbus/2 or Vbus; the debug outputs are
+ *  the region (1..4) instead of the angle, the sector and the dwell times
+ *  of the nearest three vectors instead of T1, T2, Tz.
+ *  Six-phase: port 1 is a1, b1, c1, a2, b2, c2, the sectors of set 1
+ *  and 2 and the ramp; port 4 the common-mode voltage now and its period
+ *  average of set 1, the same of set 2, and the transitions of each set;
+ *  port 5 requested and achieved Valpha, Vbeta, Vx, Vy.
+ *  In timer mode every output after the sector/T1/T2 debug values follows
+ *  the timer registers in effect; the harmonic analyzer sees those loaded
+ *  at the period start.
+ *  The phase levels, common-mode and achieved voltages use the bus in use,
+ *  the harmonic analyzer always the Vbus parameter.
+ *  Run-time counters (pwm_stats.h), two-level only: periods with Tz < 0
+ *  (overmodulated), sector changes and the periods and time spent in each
+ *  sector, counted at the period starts and printed at the end of the
+ *  simulation.
+ *  Built with -DSFUN_PROFILE (sfun_prof.h) mdlOutputs times its stages,
+ *  carrier, angle, sector, dwell, mapping (compare values, modulation and
+ *  counters), timer, compare, shunt and monitor (common-mode, achieved
+ *  voltage and analyzer outputs), per instance; the histograms are printed
+ *  at the end of the simulation. Only the default sector search has the
+ *  angle and sector stages, the other engines, float32 and the whole
+ *  three-level or six-phase path count as dwell.
  *  states: 1, continuous.
  *  Operate at 'fast' sample rate Tfast (pwm rate) + continuous
  *  direct feed-through
  *
+ *  Variable and random mode: the block hits at every period start (variable sample
+ *  time), latches Ts_k and runs the carrier internally with the same
+ *  0 -> Ts_k -> 0 shape and slope as the integrated pulse train; the
+ *  compare times are computed for Ts_k.
+ *
  *  Given input samples (Valpha, Vbeta), compute angle and decompose
  *  these into three components, U, V and W
  *  Generate a continuous ramp between max and min with equal
@@ -34,15 +146,138 @@
 
 #include <math.h>
 #include <string.h>
-#include <stdio.h>#define Ui0(element) (*uPtrs0[element])      /* Pointer to Input Port0 */
+#include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include "simstruc.h"
 #include "matrix.h"
+#include "svpwm_core.h"
+#include "svpwm_real.h"
+#include "pwm_rng.h"
+#include "pwm_spectrum.h"
+#include "shunt_sampling.h"
+#include "pwm_timer.h"
+#include "svpwm_3l.h"
+#include "svpwm_6ph.h"
+#include "sfun_prof.h"
+#include "pwm_stats.h"
 
 #define Ui0(element) (*uPtrs0[element])    /* Pointer to Input Port0 */
 #define Ui1(element) (*uPtrs1[element])    /* Pointer to Input Port1 */
+#define Ui2(element) (*uPtrs2[element])    /* Pointer to Input Port2 */
+#define UiNp(element) (*uPtrsNp[element])  /* Pointer to the NP input */
 #define Vbus_PARAM(S) ssGetSFcnParam(S,0)  /* define Vbus */
 #define Ts_PARAM(S) ssGetSFcnParam(S,1)    /* define Ts   */
+#define OPT_PARAM(S) ssGetSFcnParam(S,2)   /* define Options */
+
+/* Options vector index */
+#define OPT_PWM_MODE 0
+#define OPT_TS_MIN   1
+#define OPT_TS_MAX   2
+#define OPT_SPREAD   3
+#define OPT_SEED     4
+#define OPT_SPEC_F1  5
+#define OPT_SPEC_NH  6
+#define OPT_SPEC_CYC 7
+#define OPT_MODULATION 8
+#define OPT_SECTOR   9
+#define OPT_FLOAT32  10
+#define OPT_VBUS     11
+#define OPT_SHUNT    12
+#define OPT_TRISE    13
+#define OPT_TSAMPLE  14
+#define OPT_TIMER    15
+#define OPT_FCLK     16
+#define OPT_ARR      17
+#define OPT_LEVELS   18
+#define OPT_KNP      19
+#define OPT_PHASES   20
+
+#define PWM_FIXED    0
+#define PWM_VARIABLE 1
+#define PWM_RANDOM   2
+
+#define VBUS_PARAM   0
+#define VBUS_INPUT   1
+#define VBUS_COMP    2
+
+#define SHUNT_OFF    0
+#define SHUNT_2      1
+#define SHUNT_1      2
+#define SHUNT_1_SHIFT 3
+
+#define TIMER_OFF    0
+
+/* DWork 0, variable and random mode carrier */
+#define DW_T0    0  // start of the current period
+#define DW_TK    1  // period in use
+#define DW_K     2  // periods started, random mode draw counter
+#define DW_SECTOR 3 // tracked sector, 0 = none yet
+#define DW_INV_VBUS 4 // 1/Vbus_k latched at the period start
+#define DW_SECTOR2 5 // six-phase, tracked sector of set 2
+#define DW_WIDTH 6
+
+/* DWork 1, timer mode preload and shadow registers, PWM_Timer_t bytes */
+
+/* DWork 2, the parameters parsed once, svpwmOpts_t bytes: mdlStart and
+   mdlProcessParameters fill it, the run-time methods only read it */
+typedef struct
+{
+    real_T             Vbus;       // nominal line voltage
+    real_T             Ts;         // nominal pwm period
+    int_T              PwmMode;
+    real_T             TsMin;
+    real_T             TsMax;
+    real_T             Spread;
+    uint64_t           RngKey;     // random mode stream of the seed
+    real_T             SpecF1;
+    int_T              SpecNH;
+    uint32_t           SpecCyc;
+    SVPWM_Modulation_t Modulation;
+    SVPWM_Engine_t     Engine;
+    int_T              Float32;
+    int_T              VbusMode;
+    int_T              ShuntMode;
+    Shunt_Config_t     Shunt;
+    int_T              TimerMode;
+    PWM_Timer_Config_t Timer;
+    int_T              Levels;
+    real_T             Knp;
+    int_T              NpPort;     // -1: no neutral point input
+    int_T              Phases;
+} svpwmOpts_t;
+
+#define OPTS(S) ((const svpwmOpts_t *)ssGetDWork(S, 2))
+
+/* PWork 0 PWM_Spectrum_t, analyzer on only; PWork 1 SFun_Prof_t,
+   SFUN_PROFILE builds only; PWork 2 PWM_Stats_t */
+#define PW_SPECTRUM 0
+#define PW_PROF     1
+#define PW_STATS    2
+
+/* mdlOutputs profile stages */
+#define PROF_CARRIER 0
+#define PROF_ANGLE   1
+#define PROF_SECTOR  2
+#define PROF_DWELL   3
+#define PROF_MAPPING 4
+#define PROF_TIMER   5
+#define PROF_COMPARE 6
+#define PROF_SHUNT   7
+#define PROF_MONITOR 8
+#define PROF_STAGES  9
+
+#if defined(SFUN_PROFILE)
+static const char * const svpwmProfStages[PROF_STAGES] =
+{
+    "carrier", "angle", "sector", "dwell", "mapping", "timer", "compare",
+    "shunt", "monitor"
+};
+#endif
+
+/* a stage mark, skipped when there is no profile to mark (mdlUpdate) */
+#define PROF_MARK(pProf, stage) \
+    do { if ((pProf) != NULL) SFUN_PROF_STAGE(pProf, stage); } while (0)
 
 #define NUM_CSTATES 1  // continuous states
 #define NUM_DSTATES 0  // discrete states
@@ -78,6 +313,165 @@
 #define OK_EMPTY_DOUBLE_PARAM(pVal) (mxIsNumeric(pVal) && !mxIsLogical(pVal) &&\
 !mxIsSparse(pVal) && !mxIsComplex(pVal) && mxIsDouble(pVal))
 
+/* Options element idx, or dflt when Options is shorter or empty */
+static real_T getOpt(SimStruct *S, int_T idx, real_T dflt)
+{
+    const mxArray *pOpt = OPT_PARAM(S);
+
+    if ( (int_T)mxGetNumberOfElements(pOpt) <= idx ) {
+        return dflt;
+    }
+    return mxGetPr(pOpt)[idx];
+}
+
+static real_T getTsMin(SimStruct *S)
+{
+    return getOpt(S, OPT_TS_MIN, 0.25*mxGetPr(Ts_PARAM(S))[0]);
+}
+
+static real_T getTsMax(SimStruct *S)
+{
+    return getOpt(S, OPT_TS_MAX, 4.0*mxGetPr(Ts_PARAM(S))[0]);
+}
+
+static int_T getSpecNH(SimStruct *S)
+{
+    return (int_T)getOpt(S, OPT_SPEC_NH, 50.0);
+}
+
+static int_T getVbusMode(SimStruct *S)
+{
+    return (int_T)getOpt(S, OPT_VBUS, VBUS_PARAM);
+}
+
+/* bus voltage in use, the parameter or measured on input 3 */
+static real_T getVbus(SimStruct *S, const svpwmOpts_t *pOpt)
+{
+    if (pOpt->VbusMode != VBUS_PARAM) {
+        InputRealPtrsType uPtrs2 = ssGetInputPortRealSignalPtrs(S,2);
+        return Ui2(0);
+    }
+    return pOpt->Vbus;
+}
+
+static int_T getShuntMode(SimStruct *S)
+{
+    return (int_T)getOpt(S, OPT_SHUNT, SHUNT_OFF);
+}
+
+static int_T getTimerMode(SimStruct *S)
+{
+    return (int_T)getOpt(S, OPT_TIMER, TIMER_OFF);
+}
+
+static int_T getLevels(SimStruct *S)
+{
+    return (int_T)getOpt(S, OPT_LEVELS, 2.0);
+}
+
+static int_T getPhases(SimStruct *S)
+{
+    return (int_T)getOpt(S, OPT_PHASES, 3.0);
+}
+
+/* three-level neutral point input: Ia, Ib, Ic, dVnp */
+static int_T getNpPort(SimStruct *S)
+{
+    if (getLevels(S) != 3 || getOpt(S, OPT_KNP, 0.0) <= 0.0) {
+        return -1;
+    }
+    return (getVbusMode(S) != VBUS_PARAM) ? 3 : 2;
+}
+
+/* Options, Vbus and Ts into pOpt, defaults filled in */
+static void parseOpts(SimStruct *S, svpwmOpts_t *pOpt)
+{
+    pOpt->Vbus       = mxGetPr(Vbus_PARAM(S))[0];
+    pOpt->Ts         = mxGetPr(Ts_PARAM(S))[0];
+    pOpt->PwmMode    = (int_T)getOpt(S, OPT_PWM_MODE, PWM_FIXED);
+    pOpt->TsMin      = getTsMin(S);
+    pOpt->TsMax      = getTsMax(S);
+    pOpt->Spread     = getOpt(S, OPT_SPREAD, 0.1);
+    pOpt->RngKey     = RNG_Key((uint64_t)getOpt(S, OPT_SEED, 1.0), 0);
+    pOpt->SpecF1     = getOpt(S, OPT_SPEC_F1, 0.0);
+    pOpt->SpecNH     = getSpecNH(S);
+    pOpt->SpecCyc    = (uint32_t)getOpt(S, OPT_SPEC_CYC, 1.0);
+    pOpt->Modulation = (SVPWM_Modulation_t)getOpt(S, OPT_MODULATION,
+                                                  SVPWM_MOD_SVPWM);
+    pOpt->Engine     = (SVPWM_Engine_t)getOpt(S, OPT_SECTOR,
+                                              SVPWM_ENGINE_FULL);
+    pOpt->Float32    = (getOpt(S, OPT_FLOAT32, 0.0) != 0.0);
+    pOpt->VbusMode   = getVbusMode(S);
+    pOpt->ShuntMode  = getShuntMode(S);
+    pOpt->Shunt.Topology = (pOpt->ShuntMode == SHUNT_2) ? SHUNT_TWO
+                                                        : SHUNT_SINGLE;
+    pOpt->Shunt.Trise    = getOpt(S, OPT_TRISE, 1.5e-6);
+    pOpt->Shunt.Tsample  = getOpt(S, OPT_TSAMPLE, 0.5e-6);
+    pOpt->Shunt.Shift    = (pOpt->ShuntMode == SHUNT_1_SHIFT);
+    pOpt->TimerMode    = getTimerMode(S);
+    pOpt->Timer.Fclk   = getOpt(S, OPT_FCLK, 170e6);
+    pOpt->Timer.Arr    = (uint32_t)getOpt(S, OPT_ARR, 0.0);
+    pOpt->Timer.Update = (PWM_Timer_Update_t)(pOpt->TimerMode - 1);
+    pOpt->Levels     = getLevels(S);
+    pOpt->Knp        = getOpt(S, OPT_KNP, 0.0);
+    pOpt->NpPort     = getNpPort(S);
+    pOpt->Phases     = getPhases(S);
+}
+
+/* ripple compensation gain Vbus/Vbus_k, a multiply per sample */
+static real_T getBusGain(SimStruct *S, const svpwmOpts_t *pOpt)
+{
+    const real_T *dw = (const real_T *)ssGetDWork(S, 0);
+
+    if (pOpt->VbusMode == VBUS_COMP) {
+        return pOpt->Vbus * dw[DW_INV_VBUS];
+    }
+    return 1.0;
+}
+
+/* compare values of one period for the selected timing engine and
+   modulation, the tracked sector is kept in DWork; pProf, SFUN_PROFILE
+   builds: the full engine runs by its stages, angle, sector, dwell times
+   and mapping, each one marked; any other engine is marked as dwell */
+static void calcTiming(SimStruct *S, real_T Va, real_T Vb, real_T Ts,
+                       SVPWM_Timing_t *pTm, void *pProf)
+{
+    const svpwmOpts_t *pOpt   = OPTS(S);
+    real_T            *dw     = (real_T *)ssGetDWork(S, 0);
+    int16_t            sector = (int16_t)dw[DW_SECTOR];
+    SVPWM_Engine_t     engine = pOpt->Engine;
+    real_T             gain   = getBusGain(S, pOpt);
+
+    Va *= gain;
+    Vb *= gain;
+    if (pOpt->Float32) {
+        SVPWM_Timing_F32_t tm32;
+
+        SVPWM_Calc_Timing_F32((float)Va, (float)Vb, (float)Ts, &tm32);
+        SVPWM_Timing_From_F32(&tm32, pTm);
+        PROF_MARK(pProf, PROF_DWELL);
+    }
+#if defined(SFUN_PROFILE)
+    else if (engine == SVPWM_ENGINE_FULL && pProf != NULL) {
+        real_T angle = atan2(Vb, Va);
+
+        SFUN_PROF_STAGE(pProf, PROF_ANGLE);
+        sector = SVPWM_Sector_Full(angle);
+        SFUN_PROF_STAGE(pProf, PROF_SECTOR);
+        SVPWM_Dwell_Times(Va, Vb, angle, sector, Ts, pTm);
+        SFUN_PROF_STAGE(pProf, PROF_DWELL);
+        SVPWM_Map_Phases(pTm);
+        dw[DW_SECTOR] = sector;
+    }
+#endif
+    else {
+        SVPWM_Calc_Timing_Engine(engine, Va, Vb, Ts, &sector, pTm);
+        dw[DW_SECTOR] = sector;
+        PROF_MARK(pProf, PROF_DWELL);
+    }
+    SVPWM_Apply_Modulation(pTm, pOpt->Modulation);
+}
+
 /*====================*
  * S-function methods *
  *====================*/
@@ -93,18 +487,125 @@
   {
       /* Check 1st parameter: Vbus */
       {
-          if ( (mxGetN(Vbus_PARAM(S)) != 1) || !IS_PARAM_DOUBLE(Vbus_PARAM(S)) ) {
+          if ( (mxGetN(Vbus_PARAM(S)) != 1) || !IS_PARAM_DOUBLE(Vbus_PARAM(S)) ||
+               mxGetPr(Vbus_PARAM(S))[0] <= 0.0 ) {
               ssSetErrorStatus(S,"1st parameter to S-function, Vbus, is in error ");
               return;
           }
       }
       /* Check 2nd parameter: Ts */
       {
-          if ( (mxGetN(Ts_PARAM(S)) != 1) || !IS_PARAM_DOUBLE(Ts_PARAM(S)) ) {
+          if ( (mxGetN(Ts_PARAM(S)) != 1) || !IS_PARAM_DOUBLE(Ts_PARAM(S)) ||
+               mxGetPr(Ts_PARAM(S))[0] <= 0.0 ) {
               ssSetErrorStatus(S,"2nd parameter to S-function, Ts, is in error ");
               return;
           }
       }
+      /* Check 3rd parameter: Options */
+      {
+          if ( !OK_EMPTY_DOUBLE_PARAM(OPT_PARAM(S)) ) {
+              ssSetErrorStatus(S,"3rd parameter to S-function, Options, is in error ");
+              return;
+          }
+          if ( (getOpt(S, OPT_PWM_MODE, PWM_FIXED) != PWM_FIXED &&
+                getOpt(S, OPT_PWM_MODE, PWM_FIXED) != PWM_VARIABLE &&
+                getOpt(S, OPT_PWM_MODE, PWM_FIXED) != PWM_RANDOM) ||
+               getTsMin(S) <= 0.0 || getTsMax(S) < getTsMin(S) ) {
+              ssSetErrorStatus(S,"Options: pwm mode must be 0, 1 or 2 and "
+                                 "0 < Ts min <= Ts max ");
+              return;
+          }
+          if ( getOpt(S, OPT_SPREAD, 0.1) < 0.0 ||
+               getOpt(S, OPT_SPREAD, 0.1) >= 1.0 ||
+               getOpt(S, OPT_SEED, 1.0) < 0.0 ) {
+              ssSetErrorStatus(S,"Options: spread must be in [0,1), "
+                                 "seed >= 0 ");
+              return;
+          }
+          if ( getOpt(S, OPT_SPEC_F1, 0.0) < 0.0 || getSpecNH(S) < 1 ||
+               getSpecNH(S) > PWM_SPECTRUM_MAX_HARM ||
+               getOpt(S, OPT_SPEC_CYC, 1.0) < 1.0 ) {
+              ssSetErrorStatus(S,"Options: analyzer needs F1 >= 0, "
+                                 "1 <= NH <= 512, cycles >= 1 ");
+              return;
+          }
+          if ( getOpt(S, OPT_MODULATION, SVPWM_MOD_SVPWM) != SVPWM_MOD_SVPWM &&
+               getOpt(S, OPT_MODULATION, SVPWM_MOD_SVPWM) != SVPWM_MOD_AZSPWM &&
+               getOpt(S, OPT_MODULATION, SVPWM_MOD_SVPWM) != SVPWM_MOD_NSPWM ) {
+              ssSetErrorStatus(S,"Options: modulation must be 0, 1 or 2 ");
+              return;
+          }
+          if ( getOpt(S, OPT_SECTOR, 0.0) != SVPWM_ENGINE_FULL &&
+               getOpt(S, OPT_SECTOR, 0.0) != SVPWM_ENGINE_TRACKED &&
+               getOpt(S, OPT_SECTOR, 0.0) != SVPWM_ENGINE_MINMAX ) {
+              ssSetErrorStatus(S,"Options: sector mode must be 0, 1 or 2 ");
+              return;
+          }
+          if ( getOpt(S, OPT_FLOAT32, 0.0) != 0.0 &&
+               ( getOpt(S, OPT_FLOAT32, 0.0) != 1.0 ||
+                 getOpt(S, OPT_SECTOR, 0.0) != SVPWM_ENGINE_FULL ) ) {
+              ssSetErrorStatus(S,"Options: float32 must be 0 or 1, "
+                                 "1 needs sector mode 0 ");
+              return;
+          }
+          if ( getOpt(S, OPT_VBUS, VBUS_PARAM) != VBUS_PARAM &&
+               getOpt(S, OPT_VBUS, VBUS_PARAM) != VBUS_INPUT &&
+               getOpt(S, OPT_VBUS, VBUS_PARAM) != VBUS_COMP ) {
+              ssSetErrorStatus(S,"Options: Vbus mode must be 0, 1 or 2 ");
+              return;
+          }
+          if ( getOpt(S, OPT_SHUNT, SHUNT_OFF) != SHUNT_OFF &&
+               getOpt(S, OPT_SHUNT, SHUNT_OFF) != SHUNT_2 &&
+               getOpt(S, OPT_SHUNT, SHUNT_OFF) != SHUNT_1 &&
+               getOpt(S, OPT_SHUNT, SHUNT_OFF) != SHUNT_1_SHIFT ) {
+              ssSetErrorStatus(S,"Options: shunt mode must be 0, 1, 2 or 3 ");
+              return;
+          }
+          if ( getOpt(S, OPT_TRISE, 1.5e-6) < 0.0 ||
+               getOpt(S, OPT_TSAMPLE, 0.5e-6) < 0.0 ) {
+              ssSetErrorStatus(S,"Options: Trise and Tsample must be >= 0 ");
+              return;
+          }
+          if ( getOpt(S, OPT_TIMER, TIMER_OFF) < TIMER_OFF ||
+               getOpt(S, OPT_TIMER, TIMER_OFF) > 1 + PWM_TIMER_PRELOAD_HALF ||
+               getOpt(S, OPT_TIMER, TIMER_OFF) !=
+                   floor(getOpt(S, OPT_TIMER, TIMER_OFF)) ||
+               getOpt(S, OPT_FCLK, 170e6) <= 0.0 ||
+               getOpt(S, OPT_ARR, 0.0) < 0.0 ||
+               getOpt(S, OPT_ARR, 0.0) > 4294967295.0 ) {
+              ssSetErrorStatus(S,"Options: timer mode must be 0..3, "
+                                 "Fclk > 0, 0 <= ARR < 2^32 ");
+              return;
+          }
+          if ( (getOpt(S, OPT_LEVELS, 2.0) != 2.0 &&
+                getOpt(S, OPT_LEVELS, 2.0) != 3.0) ||
+               getOpt(S, OPT_KNP, 0.0) < 0.0 ) {
+              ssSetErrorStatus(S,"Options: levels must be 2 or 3, Knp >= 0 ");
+              return;
+          }
+          if ( getOpt(S, OPT_LEVELS, 2.0) == 3.0 &&
+               ( getOpt(S, OPT_MODULATION, SVPWM_MOD_SVPWM) != SVPWM_MOD_SVPWM ||
+                 getOpt(S, OPT_SECTOR, 0.0) != SVPWM_ENGINE_FULL ||
+                 getOpt(S, OPT_FLOAT32, 0.0) != 0.0 ||
+                 getOpt(S, OPT_SHUNT, SHUNT_OFF) != SHUNT_OFF ||
+                 getOpt(S, OPT_TIMER, TIMER_OFF) != TIMER_OFF ||
+                 getOpt(S, OPT_SPEC_F1, 0.0) != 0.0 ) ) {
+              ssSetErrorStatus(S,"Options: three-level needs modulation, "
+                                 "sector, float32, shunt, timer and F1 0 ");
+              return;
+          }
+          if ( getOpt(S, OPT_PHASES, 3.0) != 3.0 &&
+               ( getOpt(S, OPT_PHASES, 3.0) != 6.0 ||
+                 getOpt(S, OPT_LEVELS, 2.0) != 2.0 ||
+                 getOpt(S, OPT_FLOAT32, 0.0) != 0.0 ||
+                 getOpt(S, OPT_SHUNT, SHUNT_OFF) != SHUNT_OFF ||
+                 getOpt(S, OPT_TIMER, TIMER_OFF) != TIMER_OFF ||
+                 getOpt(S, OPT_SPEC_F1, 0.0) != 0.0 ) ) {
+              ssSetErrorStatus(S,"Options: phases must be 3 or 6, 6 needs "
+                                 "levels 2 and float32, shunt, timer, F1 0 ");
+              return;
+          }
+      }
   }
 #endif /* MDL_CHECK_PARAMETERS */
 
@@ -120,27 +621,59 @@ static void mdlInitializeSizes(SimStruct *S)
         /* Return if number of expected != number of actual parameters */
         return;
     }
+#if defined(MATLAB_MEX_FILE)
+    mdlCheckParameters(S);
+    if (ssGetErrorStatus(S) != NULL) return;
+#endif
 
     ssSetNumContStates(S, NUM_CSTATES); // ramp
     ssSetNumDiscStates(S, NUM_DSTATES); // none
 
-    if (!ssSetNumInputPorts(S, 2)) return;
-    ssSetInputPortWidth(S, 0, 2);
+    if (!ssSetNumInputPorts(S, 2 + (getVbusMode(S) != VBUS_PARAM) +
+                               (getNpPort(S) >= 0))) return;
+    ssSetInputPortWidth(S, 0, (getPhases(S) == 6) ? 4 : 2);
     ssSetInputPortWidth(S, 1, 1);
     ssSetInputPortDirectFeedThrough(S, 0, TRUE);
     ssSetInputPortDirectFeedThrough(S, 1, TRUE);
+    if (getVbusMode(S) != VBUS_PARAM) {
+        ssSetInputPortWidth(S, 2, 1);  // Vbus_k
+        ssSetInputPortDirectFeedThrough(S, 2, TRUE);
+    }
+    if (getNpPort(S) >= 0) {
+        ssSetInputPortWidth(S, getNpPort(S), 4);  // Ia, Ib, Ic, dVnp
+        ssSetInputPortDirectFeedThrough(S, getNpPort(S), TRUE);
+    }
 
     ssSetInputPortRequiredContiguous(S, 0, 0); // not required
 
-    if (!ssSetNumOutputPorts(S, 1)) return;
+    if (!ssSetNumOutputPorts(S, 5 + (getShuntMode(S) != SHUNT_OFF) +
+                                (getTimerMode(S) != TIMER_OFF))) return;
     ssSetOutputPortWidth(S, 0, 9);
+    ssSetOutputPortWidth(S, 1, 1);  // Ts_k
+    ssSetOutputPortWidth(S, 2, 1 + getSpecNH(S));  // WTHD, harmonics
+    ssSetOutputPortWidth(S, 3, 6);  // CMV, switching counts
+    // requested, achieved Valpha/Vbeta (and Vx/Vy)
+    ssSetOutputPortWidth(S, 4, (getPhases(S) == 6) ? 8 : 4);
+    if (getShuntMode(S) != SHUNT_OFF) {
+        ssSetOutputPortWidth(S, 5, 5);  // sampling instants, flags
+    }
+    if (getTimerMode(S) != TIMER_OFF) {
+        ssSetOutputPortWidth(S, ssGetNumOutputPorts(S) - 1, 4);  // ARR, CCR
+    }
 
     // ssSetOptions(S, SS_OPTION_EXCEPTION_FREE_CODE); // why/how is this used
 
     ssSetNumSampleTimes(S, 2);
     ssSetNumRWork(S, 0);
     ssSetNumIWork(S, 0);
-    ssSetNumPWork(S, 0);
+    ssSetNumPWork(S, 3);  // PWM_Spectrum_t, SFun_Prof_t, PWM_Stats_t
+    if (!ssSetNumDWork(S, 3)) return;
+    ssSetDWorkWidth(S, 0, DW_WIDTH);
+    ssSetDWorkDataType(S, 0, SS_DOUBLE);
+    ssSetDWorkWidth(S, 1, sizeof(PWM_Timer_t));
+    ssSetDWorkDataType(S, 1, SS_UINT8);
+    ssSetDWorkWidth(S, 2, sizeof(svpwmOpts_t));
+    ssSetDWorkDataType(S, 2, SS_UINT8);
     ssSetNumModes(S, 0);
     ssSetNumNonsampledZCs(S, 0);
 
@@ -148,6 +681,7 @@ static void mdlInitializeSizes(SimStruct *S)
      * built-in block */
     ssSetOperatingPointCompliance(S, USE_DEFAULT_OPERATING_POINT);
     // ssSetOptions(S, SS_OPTION_EXCEPTION_FREE_CODE);  // redundant
+    ssSetOptions(S, SS_OPTION_CALL_TERMINATE_ON_EXIT);
 }
 
 /* Function: mdlInitializeSampleTimes =========================================
@@ -158,7 +692,12 @@ static void mdlInitializeSizes(SimStruct *S)
  */
 static void mdlInitializeSampleTimes(SimStruct *S)
 {
-    ssSetSampleTime(S, 0, 50E-6);
+    if (getOpt(S, OPT_PWM_MODE, PWM_FIXED) != PWM_FIXED) {
+        ssSetSampleTime(S, 0, VARIABLE_SAMPLE_TIME);  // period starts
+    }
+    else {
+        ssSetSampleTime(S, 0, mxGetPr(Ts_PARAM(S))[0]);
+    }
     ssSetSampleTime(S, 1, CONTINUOUS_SAMPLE_TIME);
 
     ssSetOffsetTime(S, 0, 0.0);
@@ -187,10 +726,197 @@ static void mdlInitializeSampleTimes(SimStruct *S)
      {
         *x0++=0.0;   // initialize continuous-time ramp state
      }
+
+     {
+        real_T *dw = (real_T *)ssGetDWork(S, 0);
+        dw[DW_T0] = 0.0;
+        dw[DW_TK] = OPTS(S)->Ts;
+        dw[DW_K]  = 0.0;
+        dw[DW_SECTOR] = 0.0;
+        dw[DW_SECTOR2] = 0.0;
+        dw[DW_INV_VBUS] = 1.0 / OPTS(S)->Vbus;
+        PWM_Timer_Reset((PWM_Timer_t *)ssGetDWork(S, 1));
+     }
   }
 
 #endif /* MDL_INITIALIZE_CONDITIONS */
 
+#define MDL_START  /* Change to #undef to remove function */
+#if defined(MDL_START)
+  /* Function: mdlStart =======================================================
+   * Abstract:
+   *    Parse the parameters, allocate the run-time counters, the harmonic
+   *    analyzer when it is switched on, and the profile in SFUN_PROFILE
+   *    builds.
+   */
+  static void mdlStart(SimStruct *S)
+  {
+      const svpwmOpts_t *pOpt = OPTS(S);
+      PWM_Spectrum_t    *pSpec;
+
+      parseOpts(S, (svpwmOpts_t *)ssGetDWork(S, 2));
+      ssGetPWork(S)[PW_SPECTRUM] = NULL;
+      ssGetPWork(S)[PW_PROF] = NULL;
+      ssGetPWork(S)[PW_STATS] = malloc(sizeof(PWM_Stats_t));
+      if (ssGetPWork(S)[PW_STATS] == NULL) {
+          ssSetErrorStatus(S,"svpwm: out of memory");
+          return;
+      }
+      PWM_Stats_Reset((PWM_Stats_t *)ssGetPWork(S)[PW_STATS]);
+#if defined(SFUN_PROFILE)
+      ssGetPWork(S)[PW_PROF] = malloc(sizeof(SFun_Prof_t));
+      if (ssGetPWork(S)[PW_PROF] == NULL) {
+          ssSetErrorStatus(S,"svpwm: out of memory");
+          return;
+      }
+      SFun_Prof_Init((SFun_Prof_t *)ssGetPWork(S)[PW_PROF], svpwmProfStages,
+                     PROF_STAGES);
+#endif
+      if (pOpt->SpecF1 <= 0.0) {
+          return;
+      }
+      pSpec = (PWM_Spectrum_t *)calloc(1, sizeof(PWM_Spectrum_t));
+      if (pSpec == NULL) {
+          ssSetErrorStatus(S,"svpwm: out of memory");
+          return;
+      }
+      ssGetPWork(S)[PW_SPECTRUM] = pSpec;
+      PWM_Spectrum_Init(pSpec, pOpt->SpecF1, (uint32_t)pOpt->SpecNH,
+                        pOpt->SpecCyc, pOpt->Vbus);
+  }
+#endif /*  MDL_START */
+
+#define MDL_PROCESS_PARAMETERS  /* Change to #undef to remove function */
+#if defined(MDL_PROCESS_PARAMETERS) && defined(MATLAB_MEX_FILE)
+  /* Function: mdlProcessParameters ===========================================
+   * Abstract:
+   *    Parameters changed during the simulation, already checked: parse
+   *    them again. Options that size ports or work vectors cannot change
+   *    here; the analyzer keeps its settings from mdlStart.
+   */
+  static void mdlProcessParameters(SimStruct *S)
+  {
+      parseOpts(S, (svpwmOpts_t *)ssGetDWork(S, 2));
+  }
+#endif /* MDL_PROCESS_PARAMETERS */
+
+/* three-level outputs of the period, neutral point balanced with Knp > 0 */
+static void outputs3L(SimStruct *S, int_T tid, real_T Va, real_T Vb,
+                      real_T Ts, real_T ramp, real_T Vdc)
+{
+    real_T *y    = ssGetOutputPortRealSignal(S,0);
+    real_T *y1   = ssGetOutputPortRealSignal(S,1);
+    real_T *y3   = ssGetOutputPortRealSignal(S,3);
+    real_T *y4   = ssGetOutputPortRealSignal(S,4);
+    const svpwmOpts_t *pOpt = OPTS(S);
+    real_T  Vref = pOpt->Vbus;
+    real_T  gain = getBusGain(S, pOpt);
+    real_T  UVW[3];
+    int_T   x;
+    SVPWM_3L_Timing_t tm;
+
+    SVPWM_3L_Calc_Timing(Va * gain, Vb * gain, Ts, &tm);
+    if (pOpt->NpPort >= 0) {
+        InputRealPtrsType uPtrsNp = ssGetInputPortRealSignalPtrs(S,
+                                        pOpt->NpPort);
+        real_T Iabc[3];
+
+        Iabc[0] = UiNp(0);
+        Iabc[1] = UiNp(1);
+        Iabc[2] = UiNp(2);
+        SVPWM_3L_Balance(&tm, Iabc, UiNp(3), pOpt->Knp);
+    }
+    SVPWM_3L_Phase_Levels(&tm, ramp, Vdc, UVW);
+
+    y[0] = UVW[0]; // U
+    y[1] = UVW[1]; // V
+    y[2] = UVW[2]; // W
+    // debug variables:
+    y[3] = tm.Region; // (1:4)
+    y[4] = tm.Sector; // (1:6)
+    y[5] = ramp;
+    y[6] = tm.D[0];
+    y[7] = tm.D[1];
+    y[8] = tm.D[2];
+
+    y1[0] = Ts;
+
+    // common-mode voltage, a leg switches twice when it leaves its base
+    y3[0] = (UVW[0] + UVW[1] + UVW[2]) / 3.0;
+    y3[1] = 0.0;
+    y3[5] = 0.0;
+    for (x = 0; x < 3; x++) {
+        y3[1] += (tm.Base[x] + tm.Cmp[x] / Ts) * 0.5 * Vdc / 3.0;
+        y3[2 + x] = (tm.Cmp[x] > 0.0 && tm.Cmp[x] < Ts) ? 2.0 : 0.0;
+        y3[5] += y3[2 + x];
+    }
+
+    y4[0] = Va * (2.0/3.0) * Vref;
+    y4[1] = Vb * (2.0/3.0) * Vref;
+    SVPWM_3L_Vab_Average(&tm, Vdc, &y4[2]);
+
+    if (ssIsSampleHit(S, 0, tid)) {
+        real_T *y2 = ssGetOutputPortRealSignal(S,2);
+
+        for (x = 0; x <= pOpt->SpecNH; x++) {
+            y2[x] = 0.0;
+        }
+    }
+}
+
+/* dual three-phase outputs of the period, both sets on the same carrier */
+static void outputs6Ph(SimStruct *S, int_T tid, const real_T *pVsd,
+                       real_T Ts, real_T ramp, real_T Vdc)
+{
+    real_T *y    = ssGetOutputPortRealSignal(S,0);
+    real_T *y1   = ssGetOutputPortRealSignal(S,1);
+    real_T *y3   = ssGetOutputPortRealSignal(S,3);
+    real_T *y4   = ssGetOutputPortRealSignal(S,4);
+    real_T *dw   = (real_T *)ssGetDWork(S, 0);
+    const svpwmOpts_t *pOpt = OPTS(S);
+    real_T  Vref = pOpt->Vbus;
+    real_T  gain = getBusGain(S, pOpt);
+    int16_t sector[2];
+    int     sw[3];
+    int_T   x;
+    SVPWM_6Ph_Timing_t tm;
+
+    sector[0] = (int16_t)dw[DW_SECTOR];
+    sector[1] = (int16_t)dw[DW_SECTOR2];
+    SVPWM_6Ph_Calc_Timing(pOpt->Engine, pVsd[0] * gain, pVsd[1] * gain, pVsd[2] * gain,
+                          pVsd[3] * gain, Ts, sector, &tm);
+    dw[DW_SECTOR]  = sector[0];
+    dw[DW_SECTOR2] = sector[1];
+    SVPWM_6Ph_Apply_Modulation(&tm, pOpt->Modulation);
+
+    SVPWM_6Ph_Phase_Levels(&tm, ramp, Vdc, y);  // a1, b1, c1, a2, b2, c2
+    y[6] = tm.Set[0].Sector;
+    y[7] = tm.Set[1].Sector;
+    y[8] = ramp;
+
+    y1[0] = Ts;
+
+    // common-mode voltage of each star point
+    for (x = 0; x < 2; x++) {
+        y3[2*x]     = (y[3*x] + y[3*x + 1] + y[3*x + 2]) / 3.0;
+        y3[2*x + 1] = SVPWM_Cmv_Average(&tm.Set[x], Vdc);
+        y3[4 + x]   = SVPWM_Switchings(&tm.Set[x], sw);
+    }
+
+    for (x = 0; x < 4; x++) {
+        y4[x] = pVsd[x] * (2.0/3.0) * Vref;
+    }
+    SVPWM_6Ph_Vsd_Average(&tm, Vdc, &y4[4]);
+
+    if (ssIsSampleHit(S, 0, tid)) {
+        real_T *y2 = ssGetOutputPortRealSignal(S,2);
+
+        for (x = 0; x <= pOpt->SpecNH; x++) {
+            y2[x] = 0.0;
+        }
+    }
+}
+
 /* Function: mdlOutputs =======================================================
  * Abstract:  REQUIRED
  *    In this function, you compute the outputs of your S-function
@@ -200,170 +926,236 @@ static void mdlOutputs(SimStruct *S, int_T tid)
 {
     real_T *x    = ssGetContStates(S);
     real_T *y    = ssGetOutputPortRealSignal(S,0);
+    real_T *y1   = ssGetOutputPortRealSignal(S,1);
+    real_T *dw   = (real_T *)ssGetDWork(S, 0);
     InputRealPtrsType uPtrs0 = ssGetInputPortRealSignalPtrs(S,0);
     InputRealPtrsType uPtrs1 = ssGetInputPortRealSignalPtrs(S,1);
 
-    UNUSED_ARG(tid); /* not used in single tasking mode */
-
     real_T ramp = 4.0*x[0];             // scaled ramp
+    real_T tau;                         // time since the period start
     real_T Va = Ui0(0) / (pow(2.0,14)); // Valpha
     real_T Vb = Ui0(1) / (pow(2.0,14)); // Vbeta
-    real_T U;
-    real_T V;
-    real_T W;
-    real_T angle;    // radians
-    real_T deg;      // degrees
-    int16_t sector;
-    real_T ta;       // computed switch time T1 + T2 + T0/2
-    real_T tb;       // computed switch time T1 + T0/2
-    real_T tc;       // computed switch time T2 + T0/2
-    real_T td;       // computed switch time T0/2
-    real_T sine1;    // input to inverter half-bridge 1
-    real_T sine2;    // input to inverter half-bridge 2
-    real_T sine3;    // input to inverter half-bridge 3
-
-    real_T T1;
-    real_T T2;
-    real_T Tz;
-    real_T del1;
-    real_T del2;
-    real_T del3;
-    real_T Mi;
-
-    const real_T      *Vbus = mxGetPr(Vbus_PARAM(S)); // line voltage
-    const real_T      *Ts   = mxGetPr(Ts_PARAM(S));   // pwm period
-
-    // ref: Part 1: "https://www.youtube.com/watch?v=vJuaTbwjfMo&t=0s"
-    //      Part 2: "https://www.youtube.com/watch?v=oq868piQ9Q4"
-
-    // compute angle and modulation index
-    angle = atan2(Vb, Va);    // radians  ? change to (A,B) ?
-    deg = angle * 180.0/PI;   // degrees
-    Mi = sqrt(Vb*Vb + Va*Va); //
-    
-
-    // compute sector number [1..6]
-    if (deg>= 0 && deg <= 60) {
-       sector = 1; }
-    else if (deg > 60 && deg <= 120) {
-       sector = 2; }
-    else if (deg > 120 && deg <= 180) {
-       sector = 3; }
-    else if (deg < -120 && deg > -180) {
-       sector = 4; }
-    else if (deg < -60 && deg >= -120) {
-       sector = 5; }
-    else if (deg < 0  && deg >= -60) {
-       sector = 6; }
+    real_T UVW[3];   // U, V, W
+    SVPWM_Timing_t tm;
+
+    const svpwmOpts_t *pOpt = OPTS(S);
+    const real_T      *Vbus = &pOpt->Vbus;       // nominal line voltage
+    real_T             Vdc  = getVbus(S, pOpt);  // line voltage in use
+    real_T             Ts   = pOpt->Ts;          // pwm period
+
+    SFUN_PROF_START(ssGetPWork(S)[PW_PROF]);
+    if (pOpt->PwmMode != PWM_FIXED) {
+        // internal carrier over the latched period, 0 -> Ts -> 0
+        tau = ssGetT(S) - dw[DW_T0];
+        Ts = dw[DW_TK];
+        if (tau < 0.0) tau = 0.0;
+        if (tau > Ts)  tau = Ts;
+        ramp = Ts - fabs(Ts - 2.0*tau);
+    }
     else {
-        sector = 1;
-    }
-
-    real_T n = sector;
-
-    // compute switching times here
-    //
-    del1 = (2.0/sqrt(3))*(Mi)*(cos(angle)*sin(n*PI/3.0) - sin(angle)*cos(n*PI/3.0));
-    del2 = (2.0/sqrt(3))*(Mi)*(sin(angle)*cos((n-1.0)*PI/3.0) - cos(angle)*sin((n-1.0)*PI/3.0));
-    del3 = 1.0 - fabs(del1)- fabs(del2);
-
-    T1 = del1*(*Ts);
-    T2 = del2*(*Ts);
-    Tz = del3*(*Ts);
-
-    //  !!! below needs derivation & checking
-    //  U,V,W not switching high/low but instead ramping
-    //  %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
-    td = (Tz)/2.0;
-    ta = T1 + T2 + td;
-    tb = T1 + td;
-    tc = T2 + td;
-
-    // gate switch times to appropriate half-bridge:
-    switch(sector) {
-    case 1  :
-      sine1 = ta;   // sequence U
-      sine2 = tc;   //          V
-      sine3 = td;   //          W
-      break;
-    case 2  :
-      sine1 = tb;
-      sine2 = ta;
-      sine3 = td;
-      break;
-    case 3  :
-      sine1 = td;
-      sine2 = ta;
-      sine3 = tc;
-      break;
-    case 4  :
-      sine1 = td;
-      sine2 = tb;
-      sine3 = ta;
-      break;
-    case 5  :
-      sine1 = tc;
-      sine2 = td;
-      sine3 = ta;
-      break;
-    case 6  :
-      sine1 = ta;
-      sine2 = td;
-      sine3 = tb;
-      break;
-    /* catch errors here --- verify what to use */
-    default :
-      sine1 = ta;
-      sine2 = tc;
-      sine3 = td;
+        // ramp slope is 2, rising while the pulse train input is high
+        tau = (Ui1(0) > 0.5) ? 0.5*ramp : Ts - 0.5*ramp;
+    }
+
+    // ripple compensation: one divide per period, held for its samples
+    if (pOpt->VbusMode == VBUS_COMP && ssIsSampleHit(S, 0, tid) && Vdc > 0.0) {
+        dw[DW_INV_VBUS] = 1.0 / Vdc;
+    }
+    SFUN_PROF_STAGE(ssGetPWork(S)[PW_PROF], PROF_CARRIER);
+
+    if (pOpt->Levels == 3) {
+        outputs3L(S, tid, Va, Vb, Ts, ramp, Vdc);
+        SFUN_PROF_STAGE(ssGetPWork(S)[PW_PROF], PROF_DWELL);
+        return;
+    }
+    if (pOpt->Phases == 6) {
+        real_T Vsd[4];
+
+        Vsd[0] = Va;
+        Vsd[1] = Vb;
+        Vsd[2] = Ui0(2) / (pow(2.0,14));  // Vx
+        Vsd[3] = Ui0(3) / (pow(2.0,14));  // Vy
+        outputs6Ph(S, tid, Vsd, Ts, ramp, Vdc);
+        SFUN_PROF_STAGE(ssGetPWork(S)[PW_PROF], PROF_DWELL);
+        return;
+    }
+
+    // angle, sector, switching times and the half-bridge compare values
+    // (sine1..sine3), see svpwm_core.c
+    calcTiming(S, Va, Vb, Ts, &tm, ssGetPWork(S)[PW_PROF]);
+    if (ssIsSampleHit(S, 0, tid)) {
+        PWM_Stats_Period((PWM_Stats_t *)ssGetPWork(S)[PW_STATS], &tm);
+    }
+    SFUN_PROF_STAGE(ssGetPWork(S)[PW_PROF], PROF_MAPPING);
+
+    // timer mode: the ISR writes the counts at the period start, the
+    // compare logic runs on the registers in effect
+    if (pOpt->TimerMode != TIMER_OFF) {
+        real_T            *yt   = ssGetOutputPortRealSignal(S,
+                                      ssGetNumOutputPorts(S) - 1);
+        PWM_Timer_t       *pTim = (PWM_Timer_t *)ssGetDWork(S, 1);
+        PWM_Timer_Regs_t   regs;
+        const PWM_Timer_Regs_t *pAct;
+        uint32_t           arr;
+
+        arr = PWM_Timer_Arr(&pOpt->Timer, Ts);
+        if (ssIsSampleHit(S, 0, tid)) {
+            PWM_Timer_Update_Event(pTim);
+            PWM_Timer_Quantize(&tm, arr, &regs);
+            PWM_Timer_Write(&pOpt->Timer, pTim, &regs);
+        }
+        pAct = PWM_Timer_Active(&pOpt->Timer, pTim, tau >= 0.5*Ts);
+        PWM_Timer_Timing(pAct, arr, &tm);
+        yt[0] = arr;
+        yt[1] = pAct->Ccr[0];
+        yt[2] = pAct->Ccr[1];
+        yt[3] = pAct->Ccr[2];
+        SFUN_PROF_STAGE(ssGetPWork(S)[PW_PROF], PROF_TIMER);
     }
 
     // operate the inverter ramp in code following,
     // and set output half bridges U, V and W
-    if (sine1 > ramp){
-        U = *Vbus ;
-    } 
-    else U = 0.0;
-    if (sine2 > ramp){
-        V = *Vbus ;
-    }
-    else V = 0.0;
-    if (sine3 > ramp){
-        W = *Vbus ;
+    SVPWM_Phase_Levels(&tm, ramp, Vdc, UVW);
+    SFUN_PROF_STAGE(ssGetPWork(S)[PW_PROF], PROF_COMPARE);
+
+    // shunt current sampling windows, phase shifted edges replace U, V, W
+    if (pOpt->ShuntMode != SHUNT_OFF) {
+        real_T          *y5 = ssGetOutputPortRealSignal(S,5);
+        Shunt_Sampling_t smp;
+
+        Shunt_Sampling(&pOpt->Shunt, &tm, &smp);
+        if (smp.Flags & SHUNT_FLAG_SHIFTED) {
+            Shunt_Phase_Levels(&smp, tau, Vdc, UVW);
+        }
+        y5[0] = smp.t[0];
+        y5[1] = smp.t[1];
+        y5[2] = smp.Phase[0];
+        y5[3] = smp.Phase[1];
+        y5[4] = smp.Flags;
+        SFUN_PROF_STAGE(ssGetPWork(S)[PW_PROF], PROF_SHUNT);
     }
-    else W = 0.0;
 
     // outputs here
     /* ============================================================== */
-    y[0] = U;
-    y[1] = V;
-    y[2] = W;
+    y[0] = UVW[0]; // U
+    y[1] = UVW[1]; // V
+    y[2] = UVW[2]; // W
     // debug variables:
-    y[3] = angle;  // radians
-    y[4] = sector; // (1:6)
+    y[3] = tm.Angle;  // radians, 0 for the tracked and min/max engines
+    y[4] = tm.Sector; // (1:6)
     y[5] = ramp;
-    y[6] = T1;
-    y[7] = T2;
-    y[8] = Tz;
+    y[6] = tm.T1;
+    y[7] = tm.T2;
+    y[8] = tm.Tz;
+
+    y1[0] = Ts;
+
+    // common-mode voltage and edge counts, analytic from the compare values
+    {
+        real_T *y3 = ssGetOutputPortRealSignal(S,3);
+        int     sw[3];
+
+        y3[0] = (UVW[0] + UVW[1] + UVW[2]) / 3.0;
+        y3[1] = SVPWM_Cmv_Average(&tm, Vdc);
+        y3[5] = SVPWM_Switchings(&tm, sw);
+        y3[2] = sw[0];
+        y3[3] = sw[1];
+        y3[4] = sw[2];
+    }
 
+    // requested vs achieved (alpha, beta) voltage
+    {
+        real_T *y4 = ssGetOutputPortRealSignal(S,4);
+
+        y4[0] = Va * (2.0/3.0) * (*Vbus);
+        y4[1] = Vb * (2.0/3.0) * (*Vbus);
+        SVPWM_Vab_Average(&tm, Vdc, &y4[2]);
+    }
+
+    // analyzer results change only at period starts
+    if (ssIsSampleHit(S, 0, tid)) {
+        const PWM_Spectrum_t *pSpec =
+            (const PWM_Spectrum_t *)ssGetPWork(S)[PW_SPECTRUM];
+        real_T *y2 = ssGetOutputPortRealSignal(S,2);
+        int_T   h;
+
+        for (h = 0; h <= pOpt->SpecNH; h++) {
+            y2[h] = 0.0;
+        }
+        if (pSpec != NULL) {
+            y2[0] = PWM_Spectrum_Wthd(pSpec, PWM_SPECTRUM_UV);
+            for (h = 1; h <= (int_T)pSpec->NHarm; h++) {
+                y2[h] = PWM_Spectrum_Magnitude(pSpec, PWM_SPECTRUM_UV, h);
+            }
+        }
+    }
+    SFUN_PROF_STAGE(ssGetPWork(S)[PW_PROF], PROF_MONITOR);
 }
 
-#undef MDL_UPDATE  /* Change to #undef to remove function */
+#define MDL_GET_TIME_OF_NEXT_VAR_HIT  /* Change to #undef to remove function */
+#if defined(MDL_GET_TIME_OF_NEXT_VAR_HIT)
+  /* Function: mdlGetTimeOfNextVarHit =====================================
+   * Abstract:
+   *    Variable and random mode: a new period starts now, latch its
+   *    length Ts_k (requested on input 2 or drawn for period k from the
+   *    seeded stream, clamped to [Ts min, Ts max]) and hit again at its end.
+   */
+  static void mdlGetTimeOfNextVarHit(SimStruct *S)
+  {
+    InputRealPtrsType uPtrs1 = ssGetInputPortRealSignalPtrs(S,1);
+    real_T           *dw     = (real_T *)ssGetDWork(S, 0);
+    const svpwmOpts_t *pOpt  = OPTS(S);
+    real_T            Tk;
+
+    if (pOpt->PwmMode == PWM_RANDOM) {
+        Tk = RNG_Dither_Period(pOpt->RngKey, (uint64_t)dw[DW_K], pOpt->Ts,
+                               pOpt->Spread);
+    }
+    else {
+        Tk = Ui1(0);
+    }
+
+    if (!(Tk >= pOpt->TsMin)) Tk = pOpt->TsMin;  // also catches NaN
+    if (Tk > pOpt->TsMax)     Tk = pOpt->TsMax;
+
+    dw[DW_T0] = ssGetT(S);
+    dw[DW_TK] = Tk;
+    dw[DW_K] += 1.0;
+    ssSetTNext(S, dw[DW_T0] + Tk);
+  }
+#endif /* MDL_GET_TIME_OF_NEXT_VAR_HIT */
+
+#define MDL_UPDATE  /* Change to #undef to remove function */
 #if defined(MDL_UPDATE)
   /* Function: mdlUpdate ==================================================
    * Abstract:
-   *    This function is called once for every major integration time step.
-   *    Discrete states are typically updated here, but this function is
-   *    useful for performing any tasks that should only take place once
-   *    per integration step.
+   *    At every period start hand the period just begun, its length and
+   *    compare values, to the harmonic analyzer.
    */
   static void mdlUpdate(SimStruct *S, int_T tid)
   {
-    real_T      *dx   = ssGetdX(S);
-    real_T      *xC   = ssGetContStates(S);
-    real_T      *xD   = ssGetDiscStates(S);
+    PWM_Spectrum_t   *pSpec  = (PWM_Spectrum_t *)ssGetPWork(S)[PW_SPECTRUM];
+    const real_T     *dw     = (const real_T *)ssGetDWork(S, 0);
+    InputRealPtrsType uPtrs0 = ssGetInputPortRealSignalPtrs(S,0);
+    SVPWM_Timing_t    tm;
+    const svpwmOpts_t *pOpt  = OPTS(S);
+    real_T            t0     = ssGetT(S);
+    real_T            Ts     = pOpt->Ts;
 
-    InputRealPtrsType uPtrs = ssGetInputPortRealSignalPtrs(S,0);
+    if (pSpec == NULL || !ssIsSampleHit(S, 0, tid)) {
+        return;
+    }
+    if (pOpt->PwmMode != PWM_FIXED) {
+        t0 = dw[DW_T0];
+        Ts = dw[DW_TK];
+    }
+    calcTiming(S, Ui0(0) / (pow(2.0,14)), Ui0(1) / (pow(2.0,14)), Ts, &tm,
+               NULL);
+    if (pOpt->TimerMode != TIMER_OFF) {
+        PWM_Timer_Timing(&((const PWM_Timer_t *)ssGetDWork(S, 1))->Shadow,
+                         PWM_Timer_Arr(&pOpt->Timer, Ts), &tm);
+    }
+    PWM_Spectrum_Add_Period(pSpec, t0, Ts, tm.Cmp, tm.Inv);
   }
 #endif /* MDL_UPDATE */
 
@@ -380,6 +1172,10 @@ static void mdlOutputs(SimStruct *S, int_T tid)
     real_T            *x     = ssGetContStates(S);
     InputRealPtrsType uPtrs1 = ssGetInputPortRealSignalPtrs(S,1);
     // real_T            ramp   = x[0];   // doesn't do anything
+    if (OPTS(S)->PwmMode != PWM_FIXED) {
+        dx[0] = 0.0;          // carrier runs internally
+        return;
+    }
     dx[0]= Ui1(0) - 0.500;    // mean is zero
   }
 #endif /* MDL_DERIVATIVES */
@@ -389,9 +1185,29 @@ static void mdlOutputs(SimStruct *S, int_T tid)
  *    In this function, you should perform any actions that are necessary
  *    at the termination of a simulation.  For example, if memory was
  *    allocated in mdlStart, this is the place to free it.
+ *    The run-time counters and, in SFUN_PROFILE builds, the stage
+ *    profile are printed first.
  */
 static void mdlTerminate(SimStruct *S)
 {
+    if (ssGetPWork(S) != NULL) {
+        free(ssGetPWork(S)[PW_SPECTRUM]);
+        ssGetPWork(S)[PW_SPECTRUM] = NULL;
+        if (ssGetPWork(S)[PW_STATS] != NULL) {
+            PWM_Stats_Dump((const PWM_Stats_t *)ssGetPWork(S)[PW_STATS],
+                           ssGetPath(S), ssPrintf);
+            free(ssGetPWork(S)[PW_STATS]);
+            ssGetPWork(S)[PW_STATS] = NULL;
+        }
+#if defined(SFUN_PROFILE)
+        if (ssGetPWork(S)[PW_PROF] != NULL) {
+            SFun_Prof_Dump((const SFun_Prof_t *)ssGetPWork(S)[PW_PROF],
+                           ssGetPath(S), ssPrintf);
+            free(ssGetPWork(S)[PW_PROF]);
+            ssGetPWork(S)[PW_PROF] = NULL;
+        }
+#endif
+    }
 }
 
 /*=============================*
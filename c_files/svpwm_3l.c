@@ -0,0 +1,268 @@
+/**
+  ******************************************************************************
+  * @file    svpwm_3l.c
+  * @brief   This file provides the three-level (NPC / T-type) space vector
+  *          PWM timing, see svpwm_3l.h
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * license info:
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include "svpwm_3l.h"
+
+#define R3 0.57735026918962576451   /* 1/sqrt(3) */
+
+/* lower level of a leg at Level 0..2, 0 or 1 */
+static double SVPWM_3L_Base( double Level )
+{
+  return ( ( Level >= 1.0 ) ? 1.0 : 0.0 );
+}
+
+/* 60 degree sector of a g-h point, the origin is in sector 1 */
+static int16_t SVPWM_3L_Sector( double g, double h )
+{
+  if ( g >= 0.0 && h >= 0.0 && ( g > 0.0 || h == 0.0 ) )
+  {
+    return ( 1 );
+  }
+  if ( g <= 0.0 && g + h > 0.0 )
+  {
+    return ( 2 );
+  }
+  if ( h > 0.0 )
+  {
+    return ( 3 );
+  }
+  if ( g < 0.0 )
+  {
+    return ( 4 );
+  }
+  return ( ( g + h < 0.0 ) ? 5 : 6 );
+}
+
+/**
+  * @brief  Three-level timing of one period, Sigma = 0.5
+  * @param  Va, Vb normalized reference, see svpwm_3l.h
+  * @param  Ts pwm period (s)
+  * @param  pTiming region, nearest three vectors, dwell and leg times
+  */
+void SVPWM_3L_Calc_Timing( double Va, double Vb, double Ts,
+                           SVPWM_3L_Timing_t * pTiming )
+{
+  double u  = ( 4.0/3.0 ) * Va;
+  double v  = -( 2.0/3.0 ) * Va + ( 2.0 * R3 ) * Vb;
+  double w  = -( 2.0/3.0 ) * Va - ( 2.0 * R3 ) * Vb;
+  double hi = ( u > v ) ? u : v;
+  double lo = ( u > v ) ? v : u;
+  double rh;
+  double zs;
+  double g;
+  double h;
+  double gi;
+  double hi_;
+  double fg;
+  double fh;
+  int    lower;
+  int    s;
+
+  hi = ( w > hi ) ? w : hi;
+  lo = ( w < lo ) ? w : lo;
+  rh = 0.5 * ( hi - lo );
+  rh = ( rh > 1.0 ) ? rh : 1.0;   /* > 1: scaled onto the hexagon */
+  zs = 0.5 * ( hi + lo );
+
+  pTiming->Ts       = Ts;
+  pTiming->Level[0] = 1.0 + ( u - zs ) / rh;
+  pTiming->Level[1] = 1.0 + ( v - zs ) / rh;
+  pTiming->Level[2] = 1.0 + ( w - zs ) / rh;
+
+  /* g-h decomposition, nearest three vectors */
+  g   = pTiming->Level[0] - pTiming->Level[1];
+  h   = pTiming->Level[1] - pTiming->Level[2];
+  gi  = floor( g );
+  hi_ = floor( h );
+  gi  = ( gi > 1.0 ) ? 1.0 : gi;     /* g = 2 on the hexagon edge */
+  hi_ = ( hi_ > 1.0 ) ? 1.0 : hi_;
+  fg  = g - gi;
+  fh  = h - hi_;
+  pTiming->G = g;
+  pTiming->H = h;
+
+  pTiming->Vg[1] = ( int8_t )( gi + 1.0 );
+  pTiming->Vh[1] = ( int8_t )hi_;
+  pTiming->Vg[2] = ( int8_t )gi;
+  pTiming->Vh[2] = ( int8_t )( hi_ + 1.0 );
+  /* on the diagonal take the triangle nearer the origin, on the hexagon
+     edge g + h = -2 or 2 the one inside (rounding) */
+  lower = ( fg + fh < 1.0 ) || ( fg + fh == 1.0 && gi + hi_ >= 0.0 );
+  lower = ( gi + hi_ < -2.0 ) ? 0 : ( ( gi + hi_ > 0.0 ) ? 1 : lower );
+  if ( lower )
+  {
+    pTiming->Vg[0] = ( int8_t )gi;
+    pTiming->Vh[0] = ( int8_t )hi_;
+    pTiming->D[0]  = ( fg + fh < 1.0 ) ? ( 1.0 - fg - fh ) * Ts : 0.0;
+    pTiming->D[1]  = fg * Ts;
+    pTiming->D[2]  = fh * Ts;
+  }
+  else
+  {
+    pTiming->Vg[0] = ( int8_t )( gi + 1.0 );
+    pTiming->Vh[0] = ( int8_t )( hi_ + 1.0 );
+    pTiming->D[0]  = ( fg + fh > 1.0 ) ? ( fg + fh - 1.0 ) * Ts : 0.0;
+    pTiming->D[1]  = ( 1.0 - fh ) * Ts;
+    pTiming->D[2]  = ( 1.0 - fg ) * Ts;
+  }
+
+  /* region: rotate by -60 degrees into sector 1, (g, h) -> (g + h, -g) */
+  pTiming->Sector = SVPWM_3L_Sector( g, h );
+  for ( s = 1; s < pTiming->Sector; s++ )
+  {
+    double t = g + h;
+
+    h = -g;
+    g = t;
+  }
+  pTiming->Region = ( g + h <= 1.0 ) ? 1 : ( ( g >= 1.0 ) ? 2 :
+                    ( ( h >= 1.0 ) ? 4 : 3 ) );
+
+  SVPWM_3L_Set_Sigma( pTiming, 0.5 );
+}
+
+/* leg fractions above Base at Sigma = 0.5 before the shift, min and max */
+static void SVPWM_3L_Fractions( SVPWM_3L_Timing_t * pTiming, double * pF,
+                                double * pMin, double * pMax )
+{
+  int x;
+
+  for ( x = 0; x < 3; x++ )
+  {
+    double n = SVPWM_3L_Base( pTiming->Level[x] );
+
+    pTiming->Base[x] = ( uint8_t )n;
+    pF[x] = pTiming->Level[x] - n;
+  }
+  *pMax = ( pF[0] > pF[1] ) ? pF[0] : pF[1];
+  *pMin = ( pF[0] > pF[1] ) ? pF[1] : pF[0];
+  *pMax = ( pF[2] > *pMax ) ? pF[2] : *pMax;
+  *pMin = ( pF[2] < *pMin ) ? pF[2] : *pMin;
+}
+
+/**
+  * @brief  Split of the redundant vector between its two states
+  * @param  Sigma p-type share 0..1, clamped
+  */
+void SVPWM_3L_Set_Sigma( SVPWM_3L_Timing_t * pTiming, double Sigma )
+{
+  double f[3];
+  double fmax;
+  double fmin;
+  double delta;
+  int    x;
+
+  SVPWM_3L_Fractions( pTiming, f, &fmin, &fmax );
+  Sigma = ( Sigma < 0.0 ) ? 0.0 : ( ( Sigma > 1.0 ) ? 1.0 : Sigma );
+
+  /* p-type time fmin + delta = Sigma * (1 - fmax + fmin) */
+  delta = Sigma * ( 1.0 - fmax + fmin ) - fmin;
+
+  pTiming->Sigma = Sigma;
+  for ( x = 0; x < 3; x++ )
+  {
+    pTiming->Cmp[x] = ( f[x] + delta ) * pTiming->Ts;
+  }
+}
+
+/**
+  * @brief  Period average current out of the neutral point
+  * @param  pIabc phase currents, positive into the motor (A)
+  */
+double SVPWM_3L_Np_Current( const SVPWM_3L_Timing_t * pTiming,
+                            const double * pIabc )
+{
+  double inp = 0.0;
+  int    x;
+
+  for ( x = 0; x < 3; x++ )
+  {
+    double d = pTiming->Cmp[x] / pTiming->Ts;
+
+    inp += pIabc[x] * ( ( pTiming->Base[x] == 0 ) ? d : 1.0 - d );
+  }
+  return ( inp );
+}
+
+/**
+  * @brief  Neutral point balancing: Sigma for a mean neutral point current
+  *         of -Knp * dVnp, as far as the redundant vector allows
+  * @param  pIabc phase currents, positive into the motor (A)
+  * @param  dVnp upper minus lower capacitor voltage (V)
+  * @param  Knp balancing gain (A/V)
+  */
+void SVPWM_3L_Balance( SVPWM_3L_Timing_t * pTiming, const double * pIabc,
+                       double dVnp, double Knp )
+{
+  double f[3];
+  double fmax;
+  double fmin;
+  double slope = 0.0;
+  double d_r;
+  double inp0;
+  int    x;
+
+  /* the p-type time moves every leg one way: d(inp)/d(time) = slope */
+  SVPWM_3L_Fractions( pTiming, f, &fmin, &fmax );
+  for ( x = 0; x < 3; x++ )
+  {
+    slope += ( pTiming->Base[x] == 0 ) ? pIabc[x] : -pIabc[x];
+  }
+  d_r = 1.0 - fmax + fmin;
+  if ( d_r <= 0.0 || slope == 0.0 )
+  {
+    SVPWM_3L_Set_Sigma( pTiming, 0.5 );
+    return;
+  }
+  SVPWM_3L_Set_Sigma( pTiming, 0.0 );
+  inp0 = SVPWM_3L_Np_Current( pTiming, pIabc );
+  SVPWM_3L_Set_Sigma( pTiming, ( -Knp * dVnp - inp0 ) / ( slope * d_r ) );
+}
+
+/**
+  * @brief  Leg voltages at carrier value ramp, 0, Vbus/2 or Vbus
+  */
+void SVPWM_3L_Phase_Levels( const SVPWM_3L_Timing_t * pTiming, double ramp,
+                            double Vbus, double * pUVW )
+{
+  int x;
+
+  for ( x = 0; x < 3; x++ )
+  {
+    pUVW[x] = 0.5 * Vbus * ( pTiming->Base[x] +
+                             ( ( pTiming->Cmp[x] > ramp ) ? 1 : 0 ) );
+  }
+}
+
+/**
+  * @brief  Period average (alpha, beta) voltage of the leg times
+  * @param  pVab Valpha, Vbeta (V)
+  */
+void SVPWM_3L_Vab_Average( const SVPWM_3L_Timing_t * pTiming, double Vbus,
+                           double * pVab )
+{
+  double l[3];
+  int    x;
+
+  for ( x = 0; x < 3; x++ )
+  {
+    l[x] = 0.5 * Vbus * ( pTiming->Base[x] + pTiming->Cmp[x] / pTiming->Ts );
+  }
+  pVab[0] = ( 2.0 * l[0] - l[1] - l[2] ) / 3.0;
+  pVab[1] = ( l[1] - l[2] ) * R3;
+}
+
+/***************  END OF FILE****/
@@ -0,0 +1,88 @@
+/**
+  ******************************************************************************
+  * @file    svpwm_3l.h
+  * @brief   This file contains all definitions and functions prototypes for the
+  *          three-level (NPC / T-type) space vector PWM timing
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  * Inputs are normalized as for the two-level svpwm (svpwm_core.h), 1.0 is
+  * 2/3*Vbus, linear range |V| <= sqrt(3)/2. A phase leg connects to 0,
+  * Vbus/2 (neutral point) or Vbus, level 0, 1 or 2.
+  *
+  * Vector decomposition without trig, in g-h coordinates (60 degree axes,
+  * g along phase U, unit Vbus/2): a switching state with levels
+  * (La, Lb, Lc) is the integer point g = La - Lb, h = Lb - Lc, and the
+  * reference is g = 2Va - 2Vb/sqrt(3), h = 4Vb/sqrt(3). With gi, hi the
+  * integer parts the nearest three vectors are
+  *   fg + fh < 1:  (gi,hi), (gi+1,hi), (gi,hi+1)
+  *                 dwell 1-fg-fh, fg, fh
+  *   otherwise:    (gi+1,hi+1), (gi+1,hi), (gi,hi+1)
+  *                 dwell fg+fh-1, 1-fh, 1-fg
+  * (fg, fh fractional parts, times Ts). Outside the hexagon
+  * max(|g|, |h|, |g+h|) <= 2 the reference is scaled onto it.
+  * Sector 1..6 is the 60 degree sector, Region 1..4 the triangle in it
+  * (1 touches the zero vector, 2 and 4 touch the large vectors of its
+  * first and second edge, 3 the middle one).
+  *
+  * The leg timing is the equivalent phase disposition carrier form: phase
+  * x switches between Base[x] and Base[x] + 1, at the upper level for
+  * Cmp[x] centered like the two-level svpwm. That visits the nearest three
+  * vectors, one of them in both of its redundant states: the first and
+  * last state of the period, all phases one level apart. Sigma is the
+  * share of that vector's dwell in the upper (p-type) state, 0.5 by
+  * default; the neutral point current of the two states is opposite, so
+  * moving Sigma balances the dc link capacitors (SVPWM_3L_Balance()).
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SVPWM_3L_H
+#define __SVPWM_3L_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+typedef struct
+{
+  double  G;          /**< reference in g-h coordinates (Vbus/2)        */
+  double  H;
+  int16_t Sector;     /**< 1..6                                         */
+  int16_t Region;     /**< 1..4                                         */
+  int8_t  Vg[3];      /**< nearest three vectors, g-h coordinates       */
+  int8_t  Vh[3];
+  double  D[3];       /**< their dwell times (s)                        */
+  double  Level[3];   /**< period average leg levels, Sigma = 0.5       */
+  double  Sigma;      /**< p-type share of the redundant vector         */
+  uint8_t Base[3];    /**< lower level of phases U, V, W, 0 or 1        */
+  double  Cmp[3];     /**< time at Base + 1 (s)                         */
+  double  Ts;         /**< pwm period the times are for (s)             */
+} SVPWM_3L_Timing_t;
+
+/* Exported functions ------------------------------------------------------- */
+
+void   SVPWM_3L_Calc_Timing( double Va, double Vb, double Ts,
+                             SVPWM_3L_Timing_t * pTiming );
+void   SVPWM_3L_Set_Sigma( SVPWM_3L_Timing_t * pTiming, double Sigma );
+double SVPWM_3L_Np_Current( const SVPWM_3L_Timing_t * pTiming,
+                            const double * pIabc );
+void   SVPWM_3L_Balance( SVPWM_3L_Timing_t * pTiming, const double * pIabc,
+                         double dVnp, double Knp );
+void   SVPWM_3L_Phase_Levels( const SVPWM_3L_Timing_t * pTiming, double ramp,
+                              double Vbus, double * pUVW );
+void   SVPWM_3L_Vab_Average( const SVPWM_3L_Timing_t * pTiming, double Vbus,
+                             double * pVab );
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __SVPWM_3L_H */
+
+/* *****END OF FILE****/
@@ -0,0 +1,153 @@
+/**
+  ******************************************************************************
+  * @file    svpwm_6ph.c
+  * @brief   This file provides the dual three-phase (VSD) and generic N-phase
+  *          min/max space vector PWM timing, see svpwm_6ph.h
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * license info:
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include "svpwm_6ph.h"
+
+#define C30 0.86602540378443864676   /* cos(30 deg) */
+#define S30 0.5                      /* sin(30 deg) */
+#define TWO_PI 6.28318530717958647693
+
+/**
+  * @brief  Per-set three-phase references of a VSD reference
+  * @param  Va, Vb (alpha, beta) plane, normalized
+  * @param  Vx, Vy (x, y) plane, normalized
+  * @param  pV1 set 1 (alpha, beta)
+  * @param  pV2 set 2 (alpha, beta) in its own frame, -30 degrees
+  */
+void SVPWM_6Ph_Split( double Va, double Vb, double Vx, double Vy,
+                      double * pV1, double * pV2 )
+{
+  double a = Va - Vx;
+  double b = Vb + Vy;
+
+  pV1[0] = Va + Vx;
+  pV1[1] = Vb - Vy;
+  pV2[0] = C30 * a + S30 * b;
+  pV2[1] = C30 * b - S30 * a;
+}
+
+/**
+  * @brief  Compare values of both sets from the selected timing engine
+  * @param  Engine see SVPWM_Engine_t
+  * @param  Ts pwm period (s), both sets on the same carrier
+  * @param  pSector tracked sectors of set 1 and 2, SVPWM_ENGINE_TRACKED only
+  * @param  pTiming per-set references and compare values
+  */
+void SVPWM_6Ph_Calc_Timing( SVPWM_Engine_t Engine, double Va, double Vb,
+                            double Vx, double Vy, double Ts,
+                            int16_t * pSector, SVPWM_6Ph_Timing_t * pTiming )
+{
+  int s;
+
+  SVPWM_6Ph_Split( Va, Vb, Vx, Vy, pTiming->Vab[0], pTiming->Vab[1] );
+  for ( s = 0; s < 2; s++ )
+  {
+    SVPWM_Calc_Timing_Engine( Engine, pTiming->Vab[s][0], pTiming->Vab[s][1],
+                              Ts, &pSector[s], &pTiming->Set[s] );
+  }
+}
+
+/**
+  * @brief  SVPWM_Apply_Modulation() on both sets
+  */
+void SVPWM_6Ph_Apply_Modulation( SVPWM_6Ph_Timing_t * pTiming,
+                                 SVPWM_Modulation_t Mode )
+{
+  SVPWM_Apply_Modulation( &pTiming->Set[0], Mode );
+  SVPWM_Apply_Modulation( &pTiming->Set[1], Mode );
+}
+
+/**
+  * @brief  Half-bridge levels at carrier value ramp
+  * @param  pLegs a1, b1, c1, a2, b2, c2, 0 or Vbus
+  */
+void SVPWM_6Ph_Phase_Levels( const SVPWM_6Ph_Timing_t * pTiming, double ramp,
+                             double Vbus, double * pLegs )
+{
+  SVPWM_Phase_Levels( &pTiming->Set[0], ramp, Vbus, &pLegs[0] );
+  SVPWM_Phase_Levels( &pTiming->Set[1], ramp, Vbus, &pLegs[3] );
+}
+
+/**
+  * @brief  Period average VSD voltages the compare values produce on a bus
+  *         Vbus, the per-set averages of SVPWM_Vab_Average() combined
+  * @param  pVsd Valpha, Vbeta, Vx, Vy (V)
+  */
+void SVPWM_6Ph_Vsd_Average( const SVPWM_6Ph_Timing_t * pTiming, double Vbus,
+                            double * pVsd )
+{
+  double v1[2];
+  double v2[2];
+  double a2;
+  double b2;
+
+  SVPWM_Vab_Average( &pTiming->Set[0], Vbus, v1 );
+  SVPWM_Vab_Average( &pTiming->Set[1], Vbus, v2 );
+  a2 = C30 * v2[0] - S30 * v2[1];   /* set 2 back to the common frame */
+  b2 = S30 * v2[0] + C30 * v2[1];
+
+  pVsd[0] = 0.5 * ( v1[0] + a2 );
+  pVsd[1] = 0.5 * ( v1[1] + b2 );
+  pVsd[2] = 0.5 * ( v1[0] - a2 );
+  pVsd[3] = 0.5 * ( b2 - v1[1] );
+}
+
+/**
+  * @brief  Phase references of a symmetrical N-phase machine, phase k at
+  *         k*360/N degrees, (alpha, beta) plane only
+  * @param  Va, Vb normalized, 1.0 = 2/3*Vbus phase amplitude
+  * @param  pRef duty - 1/2 of the N phases before the zero sequence
+  */
+void SVPWM_NPh_Refs( double Va, double Vb, uint32_t N, double * pRef )
+{
+  uint32_t k;
+
+  for ( k = 0u; k < N; k++ )
+  {
+    double t = TWO_PI * (double)k / (double)N;
+
+    pRef[k] = ( 2.0/3.0 ) * ( Va * cos( t ) + Vb * sin( t ) );
+  }
+}
+
+/**
+  * @brief  Min/max zero-sequence compare values of N phases on one star
+  *         point, not clipped (overmodulated: < 0 or > Ts)
+  * @param  pRef duty - 1/2 of the N phases, 1.0 = Vbus
+  * @param  Ts pwm period (s)
+  * @param  pCmp compare times (s), N
+  */
+void SVPWM_NPh_MinMax( const double * pRef, uint32_t N, double Ts,
+                       double * pCmp )
+{
+  double   hi = pRef[0];
+  double   lo = pRef[0];
+  double   zs;
+  uint32_t k;
+
+  for ( k = 1u; k < N; k++ )
+  {
+    hi = ( pRef[k] > hi ) ? pRef[k] : hi;
+    lo = ( pRef[k] < lo ) ? pRef[k] : lo;
+  }
+  zs = 0.5 * ( hi + lo );
+  for ( k = 0u; k < N; k++ )
+  {
+    pCmp[k] = ( 0.5 + ( pRef[k] - zs ) ) * Ts;
+  }
+}
+
+/***************  END OF FILE****/
@@ -0,0 +1,77 @@
+/**
+  ******************************************************************************
+  * @file    svpwm_6ph.h
+  * @brief   This file contains all definitions and functions prototypes for the
+  *          multiphase space vector PWM timing: dual three-phase with vector
+  *          space decomposition and generic N-phase min/max
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  * Dual three-phase (asymmetrical six-phase) machine: set 1 a1, b1, c1 at
+  * 0, 120, 240 degrees, set 2 a2, b2, c2 at 30, 150, 270 degrees, two
+  * isolated neutral points. Vector space decomposition (VSD) splits the
+  * six phase voltages into the (alpha, beta) plane, which makes torque,
+  * the (x, y) plane of the 5th/7th harmonics, loss only, and the zero
+  * sequences, which the isolated neutrals block:
+  *   v_k = Va cos(t_k) + Vb sin(t_k) + Vx cos(5 t_k) + Vy sin(5 t_k)
+  * 5 t_k is t_k for set 1 and 180 degrees - t_k for set 2, so each set sees
+  * a three-phase reference in its own frame
+  *   set 1: (Va + Vx, Vb - Vy)
+  *   set 2: (Va - Vx, Vb + Vy) rotated by -30 degrees
+  * and runs the two-level timing of svpwm_core.h unchanged. Vx = Vy = 0
+  * gives the same (alpha, beta) vector on both sets, a nonzero (x, y)
+  * reference compensates current unbalance or injects harmonics. Units as
+  * in svpwm_core.h (1.0 = 2/3*Vbus); each set is linear while its own
+  * reference is <= sqrt(3)/2.
+  *
+  * Generic N-phase: phase references (duty - 1/2, 1.0 = Vbus) of one star
+  * point get the common zero sequence -(max + min)/2, the N-phase form of
+  * SVPWM_Calc_Timing_MinMax(); SVPWM_NPh_Refs() gives the references of a
+  * symmetrical N-phase machine for an (alpha, beta) vector.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SVPWM_6PH_H
+#define __SVPWM_6PH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "svpwm_core.h"
+
+typedef struct
+{
+  SVPWM_Timing_t Set[2];   /**< set 1 (a1, b1, c1), set 2 (a2, b2, c2)   */
+  double         Vab[2][2];/**< per-set reference, own frame, normalized */
+} SVPWM_6Ph_Timing_t;
+
+/* Exported functions ------------------------------------------------------- */
+
+void SVPWM_6Ph_Split( double Va, double Vb, double Vx, double Vy,
+                      double * pV1, double * pV2 );
+void SVPWM_6Ph_Calc_Timing( SVPWM_Engine_t Engine, double Va, double Vb,
+                            double Vx, double Vy, double Ts,
+                            int16_t * pSector, SVPWM_6Ph_Timing_t * pTiming );
+void SVPWM_6Ph_Apply_Modulation( SVPWM_6Ph_Timing_t * pTiming,
+                                 SVPWM_Modulation_t Mode );
+void SVPWM_6Ph_Phase_Levels( const SVPWM_6Ph_Timing_t * pTiming, double ramp,
+                             double Vbus, double * pLegs );
+void SVPWM_6Ph_Vsd_Average( const SVPWM_6Ph_Timing_t * pTiming, double Vbus,
+                            double * pVsd );
+void SVPWM_NPh_Refs( double Va, double Vb, uint32_t N, double * pRef );
+void SVPWM_NPh_MinMax( const double * pRef, uint32_t N, double Ts,
+                       double * pCmp );
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __SVPWM_6PH_H */
+
+/* *****END OF FILE****/
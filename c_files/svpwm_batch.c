@@ -0,0 +1,235 @@
+/**
+  ******************************************************************************
+  * @file    svpwm_batch.c
+  * @brief   This file provides the array kernels of the svpwm and
+  *          Circle_Limitation math with run-time instruction set selection
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * license info:
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "svpwm_batch.h"
+
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define SVPWM_BATCH_X86
+/* no a*b+c contraction where FMA is available: variants stay bit-identical */
+#pragma GCC optimize ( "fp-contract=off", "tree-vectorize", "vect-cost-model=dynamic" )
+#endif
+
+#if defined( __GNUC__ ) || defined( _MSC_VER )
+#define BATCH_RESTRICT __restrict
+#else
+#define BATCH_RESTRICT
+#endif
+
+typedef void ( *SVPWM_MinMax_Fn )( const double *, const double *, uint32_t,
+                                   double *, double *, double * );
+typedef void ( *SVPWM_Dual_Fn )( const double *, const double *, const double *,
+                                 const double *, uint32_t, double *, double *,
+                                 double *, double *, double *, double * );
+typedef void ( *CircLim_Fn )( const CircleLimitation_Handle_t *, int16_t *,
+                              int16_t *, uint32_t );
+
+/* kernels, one set per instruction set */
+#define BATCH_NAME( f ) f##_generic
+#define BATCH_TARGET
+#include "svpwm_batch_impl.h"
+
+#if defined( SVPWM_BATCH_X86 )
+#define BATCH_NAME( f ) f##_avx2
+#define BATCH_TARGET __attribute__(( target( "avx2" ) ))
+#include "svpwm_batch_impl.h"
+
+#define BATCH_NAME( f ) f##_avx512
+#define BATCH_TARGET __attribute__(( target( "avx512f,avx512bw,avx512vl" ) ))
+#include "svpwm_batch_impl.h"
+#endif
+
+static const char * const SVPWM_Isa_Names[SVPWM_ISA_NUM] =
+{
+  "generic", "avx2", "avx512"
+};
+
+static const SVPWM_MinMax_Fn SVPWM_MinMax_Kernels[SVPWM_ISA_NUM] =
+{
+#if defined( SVPWM_BATCH_X86 )
+  MinMax_generic, MinMax_avx2, MinMax_avx512
+#else
+  MinMax_generic, MinMax_generic, MinMax_generic
+#endif
+};
+
+static const SVPWM_Dual_Fn SVPWM_MinMax6_Kernels[SVPWM_ISA_NUM] =
+{
+#if defined( SVPWM_BATCH_X86 )
+  MinMax6_generic, MinMax6_avx2, MinMax6_avx512
+#else
+  MinMax6_generic, MinMax6_generic, MinMax6_generic
+#endif
+};
+
+static const SVPWM_MinMax_Fn SVPWM_Level3_Kernels[SVPWM_ISA_NUM] =
+{
+#if defined( SVPWM_BATCH_X86 )
+  Level3_generic, Level3_avx2, Level3_avx512
+#else
+  Level3_generic, Level3_generic, Level3_generic
+#endif
+};
+
+static const CircLim_Fn CircLim_Kernels[SVPWM_ISA_NUM] =
+{
+#if defined( SVPWM_BATCH_X86 )
+  CircLim_generic, CircLim_avx2, CircLim_avx512
+#else
+  CircLim_generic, CircLim_generic, CircLim_generic
+#endif
+};
+
+/* selected variant, SVPWM_ISA_NUM until the first call */
+static volatile int SVPWM_Isa_Sel = SVPWM_ISA_NUM;
+
+/* best variant the CPU runs */
+static SVPWM_Isa_t SVPWM_Batch_Best( void )
+{
+#if defined( SVPWM_BATCH_X86 )
+  __builtin_cpu_init();
+  if ( __builtin_cpu_supports( "avx512f" ) && __builtin_cpu_supports( "avx512bw" ) &&
+       __builtin_cpu_supports( "avx512vl" ) )
+  {
+    return ( SVPWM_ISA_AVX512 );
+  }
+  if ( __builtin_cpu_supports( "avx2" ) )
+  {
+    return ( SVPWM_ISA_AVX2 );
+  }
+#endif
+  return ( SVPWM_ISA_GENERIC );
+}
+
+/* selected variant, resolved from SVPWM_ISA and the CPU on the first call;
+   concurrent first calls resolve to the same value */
+static SVPWM_Isa_t SVPWM_Batch_Resolve( void )
+{
+  if ( SVPWM_Isa_Sel == SVPWM_ISA_NUM )
+  {
+    SVPWM_Batch_Select( getenv( "SVPWM_ISA" ) );
+  }
+  return ( ( SVPWM_Isa_t )SVPWM_Isa_Sel );
+}
+
+/**
+  * @brief  Force a kernel variant
+  * @param  pName "generic", "avx2", "avx512", or NULL/"" for the best one
+  * @retval variant in use, never above what the CPU supports
+  */
+SVPWM_Isa_t SVPWM_Batch_Select( const char * pName )
+{
+  SVPWM_Isa_t best = SVPWM_Batch_Best();
+  SVPWM_Isa_t isa  = best;
+  int         i;
+
+  if ( pName != NULL )
+  {
+    for ( i = 0; i < SVPWM_ISA_NUM; i++ )
+    {
+      if ( strcmp( pName, SVPWM_Isa_Names[i] ) == 0 )
+      {
+        isa = ( ( SVPWM_Isa_t )i < best ) ? ( SVPWM_Isa_t )i : best;
+      }
+    }
+  }
+  SVPWM_Isa_Sel = isa;
+  return ( isa );
+}
+
+/**
+  * @brief  Kernel variant in use
+  */
+SVPWM_Isa_t SVPWM_Batch_Isa( void )
+{
+  return ( SVPWM_Batch_Resolve() );
+}
+
+/**
+  * @brief  Name of a kernel variant, as accepted by SVPWM_Batch_Select()
+  */
+const char * SVPWM_Batch_Isa_Name( SVPWM_Isa_t Isa )
+{
+  return ( ( Isa < SVPWM_ISA_NUM ) ? SVPWM_Isa_Names[Isa] : "?" );
+}
+
+/**
+  * @brief  Duties of many samples by min/max injection, structure of
+  *         arrays, same values as SVPWM_Calc_Timing_MinMax() Cmp/Ts
+  * @param  pVa Valpha, normalized, n
+  * @param  pVb Vbeta, normalized, n
+  * @param  n number of samples
+  * @param  pDu duty of U (not clipped), n
+  * @param  pDv duty of V, n
+  * @param  pDw duty of W, n
+  */
+void SVPWM_MinMax_Batch( const double * pVa, const double * pVb,
+                         uint32_t n, double * pDu, double * pDv,
+                         double * pDw )
+{
+  SVPWM_MinMax_Kernels[SVPWM_Batch_Resolve()]( pVa, pVb, n, pDu, pDv, pDw );
+}
+
+/**
+  * @brief  Dual three-phase min/max duties of many samples, both sets in
+  *         one pass, same values as SVPWM_6Ph_Calc_Timing() with
+  *         SVPWM_ENGINE_MINMAX Cmp/Ts to rounding
+  * @param  pVa, pVb (alpha, beta) plane, normalized, n
+  * @param  pVx, pVy (x, y) plane, normalized, n
+  * @param  n number of samples
+  * @param  pD duties (not clipped), 6*n: rows a1, b1, c1, a2, b2, c2
+  */
+void SVPWM_6Ph_Batch( const double * pVa, const double * pVb,
+                      const double * pVx, const double * pVy, uint32_t n,
+                      double * pD )
+{
+  SVPWM_MinMax6_Kernels[SVPWM_Batch_Resolve()]( pVa, pVb, pVx, pVy, n,
+                                                 pD, pD + n, pD + 2u * n,
+                                                 pD + 3u * n, pD + 4u * n,
+                                                 pD + 5u * n );
+}
+
+/**
+  * @brief  Three-level average leg levels of many samples, Sigma = 0.5,
+  *         same values as SVPWM_3L_Calc_Timing() Base + Cmp/Ts to rounding
+  * @param  pVa Valpha, normalized, n
+  * @param  pVb Vbeta, normalized, n
+  * @param  n number of samples
+  * @param  pLu level of U, 0..2 (unit Vbus/2), n
+  * @param  pLv level of V, n
+  * @param  pLw level of W, n
+  */
+void SVPWM_3L_Batch( const double * pVa, const double * pVb, uint32_t n,
+                     double * pLu, double * pLv, double * pLw )
+{
+  SVPWM_Level3_Kernels[SVPWM_Batch_Resolve()]( pVa, pVb, n, pLu, pLv, pLw );
+}
+
+/**
+  * @brief  Circle_Limitation() of many samples, in place, same values
+  * @param  pHandle circle limitation table
+  * @param  pQ Vq, n
+  * @param  pD Vd, n
+  * @param  n number of samples
+  */
+void Circle_Limitation_Batch( const CircleLimitation_Handle_t * pHandle,
+                              int16_t * pQ, int16_t * pD, uint32_t n )
+{
+  CircLim_Kernels[SVPWM_Batch_Resolve()]( pHandle, pQ, pD, n );
+}
+
+/***************  END OF FILE****/
@@ -0,0 +1,68 @@
+/**
+  ******************************************************************************
+  * @file    svpwm_batch.h
+  * @brief   This file contains all definitions and functions prototypes for the
+  *          array kernels of the svpwm and Circle_Limitation math, compiled
+  *          per instruction set and selected at run time
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  * svpwm_batch_impl.h holds the kernels once; svpwm_batch.c includes it
+  * for every instruction set the compiler can target (GCC/clang on x86:
+  * generic = sse2 on x86-64, avx2, avx512f) and picks the best one the CPU
+  * supports on the first call. The environment variable SVPWM_ISA
+  * (generic, avx2, avx512) or SVPWM_Batch_Select() forces a variant, e.g.
+  * for benchmarking; a variant the CPU lacks falls back to the best one
+  * available. Other compilers get the generic kernels only.
+  *
+  * All variants give bit-identical results: no fused multiply-add, the
+  * same operation order, integer kernels exact.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SVPWM_BATCH_H
+#define __SVPWM_BATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "circle_limitation.h"
+
+typedef enum
+{
+  SVPWM_ISA_GENERIC = 0,
+  SVPWM_ISA_AVX2    = 1,
+  SVPWM_ISA_AVX512  = 2,
+  SVPWM_ISA_NUM
+} SVPWM_Isa_t;
+
+/* Exported functions ------------------------------------------------------- */
+
+void        SVPWM_MinMax_Batch( const double * pVa, const double * pVb,
+                                uint32_t n, double * pDu, double * pDv,
+                                double * pDw );
+void        SVPWM_6Ph_Batch( const double * pVa, const double * pVb,
+                             const double * pVx, const double * pVy,
+                             uint32_t n, double * pD );
+void        SVPWM_3L_Batch( const double * pVa, const double * pVb,
+                            uint32_t n, double * pLu, double * pLv,
+                            double * pLw );
+void        Circle_Limitation_Batch( const CircleLimitation_Handle_t * pHandle,
+                                     int16_t * pQ, int16_t * pD, uint32_t n );
+SVPWM_Isa_t SVPWM_Batch_Select( const char * pName );
+SVPWM_Isa_t SVPWM_Batch_Isa( void );
+const char * SVPWM_Batch_Isa_Name( SVPWM_Isa_t Isa );
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __SVPWM_BATCH_H */
+
+/* *****END OF FILE****/
@@ -0,0 +1,193 @@
+/**
+  ******************************************************************************
+  * @file    svpwm_batch_impl.h
+  * @brief   Array kernels of svpwm_batch.c, included once per instruction
+  *          set; no include guard on purpose
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  * Before each inclusion define
+  *   BATCH_NAME(f)  kernel name for this variant, e.g. f##_avx2
+  *   BATCH_TARGET   function attributes for this variant, may be empty
+  * and BATCH_RESTRICT (restrict or empty) once.
+  * Both are undefined again at the end of this file. The loops are kept
+  * free of branches and calls so that the compiler vectorizes them.
+  */
+
+/**
+  * @brief  Min/max zero-sequence duties, see SVPWM_Calc_Timing_MinMax()
+  */
+static BATCH_TARGET void BATCH_NAME( MinMax )( const double * BATCH_RESTRICT pVa,
+                                               const double * BATCH_RESTRICT pVb,
+                                               uint32_t n,
+                                               double * BATCH_RESTRICT pDu,
+                                               double * BATCH_RESTRICT pDv,
+                                               double * BATCH_RESTRICT pDw )
+{
+  uint32_t i;
+
+  for ( i = 0; i < n; i++ )
+  {
+    double u  = ( 2.0/3.0 ) * pVa[i];
+    double v  = -( 1.0/3.0 ) * pVa[i] + ( 1.0/sqrt(3) ) * pVb[i];
+    double w  = -( 1.0/3.0 ) * pVa[i] - ( 1.0/sqrt(3) ) * pVb[i];
+    double hi = ( u > v ) ? u : v;
+    double lo = ( u > v ) ? v : u;
+    double zs;
+
+    hi = ( w > hi ) ? w : hi;
+    lo = ( w < lo ) ? w : lo;
+    zs = 0.5 * ( hi + lo );
+
+    pDu[i] = 0.5 + ( u - zs );
+    pDv[i] = 0.5 + ( v - zs );
+    pDw[i] = 0.5 + ( w - zs );
+  }
+}
+
+/**
+  * @brief  Dual three-phase min/max duties of both sets in one pass, see
+  *         SVPWM_6Ph_Calc_Timing()
+  */
+static BATCH_TARGET void BATCH_NAME( MinMax6 )( const double * BATCH_RESTRICT pVa,
+                                                const double * BATCH_RESTRICT pVb,
+                                                const double * BATCH_RESTRICT pVx,
+                                                const double * BATCH_RESTRICT pVy,
+                                                uint32_t n,
+                                                double * BATCH_RESTRICT pA1,
+                                                double * BATCH_RESTRICT pB1,
+                                                double * BATCH_RESTRICT pC1,
+                                                double * BATCH_RESTRICT pA2,
+                                                double * BATCH_RESTRICT pB2,
+                                                double * BATCH_RESTRICT pC2 )
+{
+  uint32_t i;
+
+  for ( i = 0; i < n; i++ )
+  {
+    double a1 = pVa[i] + pVx[i];
+    double b1 = pVb[i] - pVy[i];
+    double a  = pVa[i] - pVx[i];
+    double b  = pVb[i] + pVy[i];
+    double a2 = ( sqrt(3) / 2.0 ) * a + 0.5 * b;
+    double b2 = ( sqrt(3) / 2.0 ) * b - 0.5 * a;
+    double u1 = ( 2.0/3.0 ) * a1;
+    double v1 = -( 1.0/3.0 ) * a1 + ( 1.0/sqrt(3) ) * b1;
+    double w1 = -( 1.0/3.0 ) * a1 - ( 1.0/sqrt(3) ) * b1;
+    double u2 = ( 2.0/3.0 ) * a2;
+    double v2 = -( 1.0/3.0 ) * a2 + ( 1.0/sqrt(3) ) * b2;
+    double w2 = -( 1.0/3.0 ) * a2 - ( 1.0/sqrt(3) ) * b2;
+    double hi1 = ( u1 > v1 ) ? u1 : v1;
+    double lo1 = ( u1 > v1 ) ? v1 : u1;
+    double hi2 = ( u2 > v2 ) ? u2 : v2;
+    double lo2 = ( u2 > v2 ) ? v2 : u2;
+    double zs1;
+    double zs2;
+
+    hi1 = ( w1 > hi1 ) ? w1 : hi1;
+    lo1 = ( w1 < lo1 ) ? w1 : lo1;
+    hi2 = ( w2 > hi2 ) ? w2 : hi2;
+    lo2 = ( w2 < lo2 ) ? w2 : lo2;
+    zs1 = 0.5 * ( hi1 + lo1 );
+    zs2 = 0.5 * ( hi2 + lo2 );
+
+    pA1[i] = 0.5 + ( u1 - zs1 );
+    pB1[i] = 0.5 + ( v1 - zs1 );
+    pC1[i] = 0.5 + ( w1 - zs1 );
+    pA2[i] = 0.5 + ( u2 - zs2 );
+    pB2[i] = 0.5 + ( v2 - zs2 );
+    pC2[i] = 0.5 + ( w2 - zs2 );
+  }
+}
+
+/**
+  * @brief  Three-level average leg levels, see SVPWM_3L_Calc_Timing()
+  */
+static BATCH_TARGET void BATCH_NAME( Level3 )( const double * BATCH_RESTRICT pVa,
+                                               const double * BATCH_RESTRICT pVb,
+                                               uint32_t n,
+                                               double * BATCH_RESTRICT pLu,
+                                               double * BATCH_RESTRICT pLv,
+                                               double * BATCH_RESTRICT pLw )
+{
+  uint32_t i;
+
+  for ( i = 0; i < n; i++ )
+  {
+    double u  = ( 4.0/3.0 ) * pVa[i];
+    double v  = -( 2.0/3.0 ) * pVa[i] + ( 2.0/sqrt(3) ) * pVb[i];
+    double w  = -( 2.0/3.0 ) * pVa[i] - ( 2.0/sqrt(3) ) * pVb[i];
+    double hi = ( u > v ) ? u : v;
+    double lo = ( u > v ) ? v : u;
+    double rh;
+    double zs;
+    double nu, nv, nw;
+    double fmax, fmin, delta;
+
+    hi = ( w > hi ) ? w : hi;
+    lo = ( w < lo ) ? w : lo;
+    rh = 0.5 * ( hi - lo );
+    rh = ( rh > 1.0 ) ? rh : 1.0;
+    zs = 0.5 * ( hi + lo );
+    u  = 1.0 + ( u - zs ) / rh;
+    v  = 1.0 + ( v - zs ) / rh;
+    w  = 1.0 + ( w - zs ) / rh;
+
+    /* lower levels 0 or 1, redundant vector split half and half */
+    nu = ( u >= 1.0 ) ? 1.0 : 0.0;
+    nv = ( v >= 1.0 ) ? 1.0 : 0.0;
+    nw = ( w >= 1.0 ) ? 1.0 : 0.0;
+    fmax = ( u - nu > v - nv ) ? u - nu : v - nv;
+    fmin = ( u - nu > v - nv ) ? v - nv : u - nu;
+    fmax = ( w - nw > fmax ) ? w - nw : fmax;
+    fmin = ( w - nw < fmin ) ? w - nw : fmin;
+    delta = 0.5 * ( 1.0 - fmax + fmin ) - fmin;
+
+    pLu[i] = nu + ( ( u - nu ) + delta );
+    pLv[i] = nv + ( ( v - nv ) + delta );
+    pLw[i] = nw + ( ( w - nw ) + delta );
+  }
+}
+
+/**
+  * @brief  Circle_Limitation() of many samples, in place
+  */
+static BATCH_TARGET void BATCH_NAME( CircLim )( const CircleLimitation_Handle_t * pHandle,
+                                                int16_t * BATCH_RESTRICT pQ,
+                                                int16_t * BATCH_RESTRICT pD,
+                                                uint32_t n )
+{
+  const uint32_t limit = ( uint32_t )( pHandle->MaxModule ) * pHandle->MaxModule;
+  const uint32_t start = pHandle->Start_index;
+  int32_t  table[sizeof( pHandle->Circle_limit_table ) / sizeof( uint16_t )];
+  uint32_t i;
+
+  /* 32-bit local copy: gathers, and no aliasing with the outputs */
+  for ( i = 0; i < sizeof( table ) / sizeof( table[0] ); i++ )
+  {
+    table[i] = pHandle->Circle_limit_table[i];
+  }
+
+  for ( i = 0; i < n; i++ )
+  {
+    int32_t  q   = pQ[i];
+    int32_t  d   = pD[i];
+    uint32_t sq  = ( uint32_t )( q * q ) + ( uint32_t )( d * d );
+    int32_t  over = ( sq > limit );
+    int32_t  idx = over ? ( int32_t )( sq / 16777216u - start ) : 0;
+    int32_t  k   = table[idx];
+
+    k = over ? k : 32768;   // 32768: unchanged
+
+    pQ[i] = ( int16_t )( ( q * k ) / 32768 );
+    pD[i] = ( int16_t )( ( d * k ) / 32768 );
+  }
+}
+
+#undef BATCH_NAME
+#undef BATCH_TARGET
+
+/* *****END OF FILE****/
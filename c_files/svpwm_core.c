@@ -0,0 +1,542 @@
+/**
+  ******************************************************************************
+  * @file    svpwm_core.c
+  * @brief   This file provides the space vector PWM timing: angle, sector,
+  *          dwell times and the sector to half-bridge mapping
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * license info:
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <stddef.h>
+#include "svpwm_core.h"
+
+#define PI 3.14159265358979323846
+
+/* sector boundaries, unit vectors at k*60 deg, k = 0..6 */
+static const double SVPWM_Bound[7][2] =
+{
+  {  1.0,  0.0                    },
+  {  0.5,  0.86602540378443864676 },
+  { -0.5,  0.86602540378443864676 },
+  { -1.0,  0.0                    },
+  { -0.5, -0.86602540378443864676 },
+  {  0.5, -0.86602540378443864676 },
+  {  1.0,  0.0                    }
+};
+
+/* inverse active vector bases: (del1, del2) = SVPWM_Basis[n-1] (Va, Vb),
+   row 1 = (2/sqrt3) [  sin(n pi/3),     -cos(n pi/3)     ]
+   row 2 = (2/sqrt3) [ -sin((n-1) pi/3),  cos((n-1) pi/3) ] */
+#define R3 0.57735026918962576451   /* 1/sqrt(3) */
+static const double SVPWM_Basis[6][2][2] =
+{
+  { {       1.0,       -R3 },   /* sector 1 */
+    {       0.0,      2*R3 } },
+  { {       1.0,        R3 },   /* sector 2 */
+    {      -1.0,        R3 } },
+  { {       0.0,      2*R3 },   /* sector 3 */
+    {      -1.0,       -R3 } },
+  { {      -1.0,        R3 },   /* sector 4 */
+    {       0.0,     -2*R3 } },
+  { {      -1.0,       -R3 },   /* sector 5 */
+    {       1.0,       -R3 } },
+  { {       0.0,     -2*R3 },   /* sector 6 */
+    {       1.0,        R3 } }
+};
+#undef R3
+
+/* half-bridge U, V, W compare value per sector, index into
+   { Ta, Tb, Tc, Td } */
+static const uint8_t SVPWM_Perm[6][3] =
+{
+  { 0, 2, 3 },   /* sector 1 */
+  { 1, 0, 3 },   /* sector 2 */
+  { 3, 0, 2 },   /* sector 3 */
+  { 3, 1, 0 },   /* sector 4 */
+  { 2, 3, 0 },   /* sector 5 */
+  { 0, 3, 1 }    /* sector 6 */
+};
+
+/* sector from the phase order, index bit 2: U >= V, bit 1: V >= W,
+   bit 0: W >= U; 0 cannot happen, 7 is the zero vector */
+static const int16_t SVPWM_Order_Sector[8] = { 1, 4, 2, 3, 6, 5, 1, 1 };
+
+/**
+  * @brief  Sector number [1..6] from the vector angle, without branches:
+  *         [0,60] 1, (60,120] 2, (120,180] 3, [-180,-120) 4, [-120,-60) 5,
+  *         [-60,0) 6, anything else (NaN) 1; atan2 gives -180 for Vb = -0
+  *         or a negative Vb far below |Va|, on the sector 3/4 boundary
+  * @param  angle atan2(Vb, Va), radians
+  * @retval sector
+  */
+int16_t SVPWM_Sector_Full( double angle )
+{
+  double  deg = angle * 180.0/PI;  // degrees
+  int     valid = ( deg >= -180.0 ) & ( deg <= 180.0 );
+  int     n;
+
+  n = 4 + ( deg >= -120.0 ) + ( deg >= -60.0 ) + ( deg > 60.0 ) + ( deg > 120.0 )
+        - 5 * ( deg >= 0.0 );
+  return ( ( int16_t )( 1 + valid * ( n - 1 ) ) );
+}
+
+/* (Va, Vb) between the boundaries of sector n: two cross products */
+static int SVPWM_In_Sector( double Va, double Vb, int16_t n )
+{
+  return ( ( SVPWM_Bound[n - 1][0] * Vb - SVPWM_Bound[n - 1][1] * Va >= 0.0 ) &&
+           ( SVPWM_Bound[n][0] * Vb - SVPWM_Bound[n][1] * Va <= 0.0 ) );
+}
+
+/**
+  * @brief  Dwell times T1, T2, Tz and the switch times Ta..Td in a sector,
+  *         no compare values (SVPWM_Map_Phases())
+  * @param  Va Valpha, normalized
+  * @param  Vb Vbeta, normalized
+  * @param  angle stored as Angle only
+  * @param  sector 1..6, SVPWM_Sector_Full()
+  * @param  Ts pwm period (s)
+  * @param  pTiming result
+  */
+void SVPWM_Dwell_Times( double Va, double Vb, double angle, int16_t sector,
+                        double Ts, SVPWM_Timing_t * pTiming )
+{
+  const double (*B)[2] = SVPWM_Basis[sector - 1];
+  double  del1;
+  double  del2;
+  double  del3;
+
+  // compute switching times here, Mi*(cos(angle), sin(angle)) = (Va, Vb)
+  del1 = B[0][0]*Va + B[0][1]*Vb;
+  del2 = B[1][0]*Va + B[1][1]*Vb;
+  del3 = 1.0 - fabs(del1)- fabs(del2);
+
+  pTiming->Angle  = angle;
+  pTiming->Sector = sector;
+  pTiming->Ts     = Ts;
+  pTiming->Inv[0] = 0;
+  pTiming->Inv[1] = 0;
+  pTiming->Inv[2] = 0;
+  pTiming->T1 = del1*Ts;
+  pTiming->T2 = del2*Ts;
+  pTiming->Tz = del3*Ts;
+
+  pTiming->Td = (pTiming->Tz)/2.0;
+  pTiming->Ta = pTiming->T1 + pTiming->T2 + pTiming->Td;
+  pTiming->Tb = pTiming->T1 + pTiming->Td;
+  pTiming->Tc = pTiming->T2 + pTiming->Td;
+}
+
+/**
+  * @brief  Sector to half-bridge mapping: the compare values of U, V, W
+  *         from Ta..Td of SVPWM_Dwell_Times()
+  * @param  pTiming Sector and Ta..Td in, Cmp out
+  */
+void SVPWM_Map_Phases( SVPWM_Timing_t * pTiming )
+{
+  const uint8_t * P = SVPWM_Perm[pTiming->Sector - 1];
+  double  t[4];
+
+  // gate switch times to appropriate half-bridge:
+  t[0] = pTiming->Ta;
+  t[1] = pTiming->Tb;
+  t[2] = pTiming->Tc;
+  t[3] = pTiming->Td;
+  pTiming->Cmp[0] = t[P[0]];   // sequence U
+  pTiming->Cmp[1] = t[P[1]];   //          V
+  pTiming->Cmp[2] = t[P[2]];   //          W
+}
+
+/* dwell times and sector to half-bridge mapping */
+static void SVPWM_Dwell( double Va, double Vb, double angle, int16_t sector,
+                         double Ts, SVPWM_Timing_t * pTiming )
+{
+  SVPWM_Dwell_Times( Va, Vb, angle, sector, Ts, pTiming );
+  SVPWM_Map_Phases( pTiming );
+}
+
+
+/**
+  * @brief  Dwell times and compare values for one PWM period
+  *         ref: Part 1: "https://www.youtube.com/watch?v=vJuaTbwjfMo&t=0s"
+  *              Part 2: "https://www.youtube.com/watch?v=oq868piQ9Q4"
+  * @param  Va Valpha, normalized
+  * @param  Vb Vbeta, normalized
+  * @param  Ts pwm period (s)
+  * @param  pTiming result
+  */
+void SVPWM_Calc_Timing( double Va, double Vb, double Ts,
+                        SVPWM_Timing_t * pTiming )
+{
+  double  angle;    // radians
+
+  // compute angle
+  angle = atan2(Vb, Va);
+
+  SVPWM_Dwell(Va, Vb, angle, SVPWM_Sector_Full(angle), Ts, pTiming);
+}
+
+/**
+  * @brief  SVPWM_Calc_Timing() with the sector tracked from the previous
+  *         sample: only the boundaries of the previous sector and its two
+  *         neighbours are tested, the full search (atan2) runs only on a
+  *         jump or when there is no previous sector. On a boundary either
+  *         sector gives the same compare values.
+  * @param  Va Valpha, normalized
+  * @param  Vb Vbeta, normalized
+  * @param  Ts pwm period (s)
+  * @param  pSector previous sector 1..6 or 0 for none, updated
+  * @param  pTiming result, Angle = 0
+  */
+void SVPWM_Calc_Timing_Tracked( double Va, double Vb, double Ts,
+                                int16_t * pSector, SVPWM_Timing_t * pTiming )
+{
+  int16_t n = *pSector;
+
+  if ( n >= 1 && n <= 6 )
+  {
+    if ( !SVPWM_In_Sector( Va, Vb, n ) )
+    {
+      if ( SVPWM_In_Sector( Va, Vb, ( int16_t )( n % 6 + 1 ) ) )
+      {
+        n = ( int16_t )( n % 6 + 1 );
+      }
+      else if ( SVPWM_In_Sector( Va, Vb, ( int16_t )( ( n + 4 ) % 6 + 1 ) ) )
+      {
+        n = ( int16_t )( ( n + 4 ) % 6 + 1 );
+      }
+      else
+      {
+        n = SVPWM_Sector_Full( atan2(Vb, Va) );
+      }
+    }
+  }
+  else
+  {
+    n = SVPWM_Sector_Full( atan2(Vb, Va) );
+  }
+  *pSector = n;
+
+  SVPWM_Dwell(Va, Vb, 0.0, n, Ts, pTiming);
+}
+
+/* zero-sequence shifted phase references, duty - 1/2 of U, V, W */
+static void SVPWM_MinMax_Refs( double Va, double Vb, double * pRef )
+{
+  double  u = ( 2.0/3.0 )*Va;                     // inverse Clarke, 1.0 = Vbus
+  double  v = -( 1.0/3.0 )*Va + ( 1.0/sqrt(3) )*Vb;
+  double  w = -( 1.0/3.0 )*Va - ( 1.0/sqrt(3) )*Vb;
+  double  hi = ( u > v ) ? u : v;
+  double  lo = ( u > v ) ? v : u;
+  double  zs;
+
+  hi = ( w > hi ) ? w : hi;
+  lo = ( w < lo ) ? w : lo;
+  zs = 0.5*( hi + lo );
+
+  pRef[0] = u - zs;
+  pRef[1] = v - zs;
+  pRef[2] = w - zs;
+}
+
+/**
+  * @brief  SVPWM_Calc_Timing() by min/max zero-sequence injection, see
+  *         svpwm_core.h; no angle, no sector search
+  * @param  Va Valpha, normalized
+  * @param  Vb Vbeta, normalized
+  * @param  Ts pwm period (s)
+  * @param  pTiming result, Angle = 0
+  */
+void SVPWM_Calc_Timing_MinMax( double Va, double Vb, double Ts,
+                               SVPWM_Timing_t * pTiming )
+{
+  double  r[3];
+  double  mid;
+  int     odd;
+
+  SVPWM_MinMax_Refs( Va, Vb, r );
+
+  pTiming->Cmp[0] = ( 0.5 + r[0] )*Ts;
+  pTiming->Cmp[1] = ( 0.5 + r[1] )*Ts;
+  pTiming->Cmp[2] = ( 0.5 + r[2] )*Ts;
+
+  pTiming->Sector = SVPWM_Order_Sector[ ( ( r[0] >= r[1] ) << 2 ) |
+                                        ( ( r[1] >= r[2] ) << 1 ) |
+                                          ( r[2] >= r[0] ) ];
+  pTiming->Angle  = 0.0;
+  pTiming->Ts     = Ts;
+  pTiming->Inv[0] = 0;
+  pTiming->Inv[1] = 0;
+  pTiming->Inv[2] = 0;
+
+  // Ta on the highest phase, Td on the lowest, the middle one carries Tc
+  // in odd sectors and Tb in even ones
+  pTiming->Ta = fmax( fmax( pTiming->Cmp[0], pTiming->Cmp[1] ), pTiming->Cmp[2] );
+  pTiming->Td = fmin( fmin( pTiming->Cmp[0], pTiming->Cmp[1] ), pTiming->Cmp[2] );
+  mid = pTiming->Cmp[0] + pTiming->Cmp[1] + pTiming->Cmp[2] - pTiming->Ta - pTiming->Td;
+  odd = pTiming->Sector & 1;
+  pTiming->Tc = odd ? mid : pTiming->Ta - mid + pTiming->Td;
+  pTiming->Tb = odd ? pTiming->Ta - mid + pTiming->Td : mid;
+  pTiming->T1 = pTiming->Tb - pTiming->Td;
+  pTiming->T2 = pTiming->Tc - pTiming->Td;
+  pTiming->Tz = 2.0*pTiming->Td;
+}
+
+/**
+  * @brief  Compare values from the selected timing engine
+  * @param  Engine see SVPWM_Engine_t
+  * @param  Va Valpha, normalized
+  * @param  Vb Vbeta, normalized
+  * @param  Ts pwm period (s)
+  * @param  pSector tracked sector state, used by SVPWM_ENGINE_TRACKED only
+  * @param  pTiming result
+  */
+void SVPWM_Calc_Timing_Engine( SVPWM_Engine_t Engine, double Va, double Vb,
+                               double Ts, int16_t * pSector,
+                               SVPWM_Timing_t * pTiming )
+{
+  if ( Engine == SVPWM_ENGINE_MINMAX )
+  {
+    SVPWM_Calc_Timing_MinMax( Va, Vb, Ts, pTiming );
+  }
+  else if ( Engine == SVPWM_ENGINE_TRACKED )
+  {
+    SVPWM_Calc_Timing_Tracked( Va, Vb, Ts, pSector, pTiming );
+  }
+  else
+  {
+    SVPWM_Calc_Timing( Va, Vb, Ts, pTiming );
+  }
+}
+
+/**
+  * @brief  Normalized dwell times of many samples, structure of arrays
+  * @param  pVa Valpha, normalized, n
+  * @param  pVb Vbeta, normalized, n
+  * @param  pSector sectors 1..6, n
+  * @param  n number of samples
+  * @param  pDel1 first active vector time / Ts, n
+  * @param  pDel2 second active vector time / Ts, n
+  */
+void SVPWM_Dwell_Batch( const double * pVa, const double * pVb,
+                        const int16_t * pSector, uint32_t n,
+                        double * pDel1, double * pDel2 )
+{
+  uint32_t i;
+
+  for ( i = 0; i < n; i++ )
+  {
+    const double (*B)[2] = SVPWM_Basis[pSector[i] - 1];
+
+    pDel1[i] = B[0][0] * pVa[i] + B[0][1] * pVb[i];
+    pDel2[i] = B[1][0] * pVa[i] + B[1][1] * pVb[i];
+  }
+}
+
+/**
+  * @brief  Inverter half-bridge outputs for a carrier value
+  * @param  pTiming compare values
+  * @param  ramp carrier, 0..Ts
+  * @param  Vbus DC link voltage
+  * @param  pUVW U, V, W: Vbus or 0 (gnd)
+  */
+void SVPWM_Phase_Levels( const SVPWM_Timing_t * pTiming, double ramp,
+                         double Vbus, double * pUVW )
+{
+  int i;
+
+  for ( i = 0; i < 3; i++ )
+  {
+    if ( pTiming->Inv[i] )
+    {
+      pUVW[i] = ( ramp > pTiming->Ts - pTiming->Cmp[i] ) ? Vbus : 0.0;
+    }
+    else
+    {
+      pUVW[i] = ( pTiming->Cmp[i] > ramp ) ? Vbus : 0.0;
+    }
+  }
+}
+
+/**
+  * @brief  Period averaged duty of a half-bridge, the compare value is
+  *         clipped by the carrier range when overmodulated
+  * @param  Cmp compare time (s)
+  * @param  Ts pwm period (s)
+  * @retval duty 0..1
+  */
+double SVPWM_Duty( double Cmp, double Ts )
+{
+  double duty = Cmp / Ts;
+
+  return ( ( duty < 0.0 ) ? 0.0 : ( ( duty > 1.0 ) ? 1.0 : duty ) );
+}
+
+/**
+  * @brief  Turn conventional compare values into a reduced common-mode
+  *         modulation, see svpwm_core.h
+  * @param  pTiming from SVPWM_Calc_Timing(), modified
+  * @param  Mode modulation
+  */
+void SVPWM_Apply_Modulation( SVPWM_Timing_t * pTiming,
+                             SVPWM_Modulation_t Mode )
+{
+  const double Ts = pTiming->Ts;
+  double d[3];
+  double mean;
+  int    imax = 0;
+  int    imin = 0;
+  int    imid;
+  int    i;
+
+  if ( Mode == SVPWM_MOD_SVPWM )
+  {
+    return;
+  }
+
+  for ( i = 0; i < 3; i++ )
+  {
+    d[i] = pTiming->Cmp[i] / Ts;
+    if ( d[i] > d[imax] )
+    {
+      imax = i;
+    }
+    if ( d[i] < d[imin] )
+    {
+      imin = i;
+    }
+  }
+  imid = ( imax == imin ) ? ( imax + 1 ) % 3 : 3 - imax - imin;
+
+  if ( Mode == SVPWM_MOD_NSPWM )
+  {
+    /* clamp the phase farthest from the mean to its rail */
+    mean = ( d[0] + d[1] + d[2] ) / 3.0;
+    if ( d[imax] - mean >= mean - d[imin] )
+    {
+      mean = 1.0 - d[imax];
+    }
+    else
+    {
+      mean = -d[imin];
+    }
+    for ( i = 0; i < 3; i++ )
+    {
+      pTiming->Cmp[i] = ( d[i] + mean ) * Ts;
+    }
+  }
+
+  pTiming->Inv[imid] = 1;
+}
+
+/**
+  * @brief  Switching instants of one period, sorted
+  * @param  pTiming compare values
+  * @param  pEdges result, up to 6 times in (0, Ts)
+  * @retval number of edges
+  */
+int SVPWM_Edges( const SVPWM_Timing_t * pTiming, double * pEdges )
+{
+  const double Ts = pTiming->Ts;
+  int    n = 0;
+  int    i;
+  int    j;
+  double w;
+
+  for ( i = 0; i < 3; i++ )
+  {
+    w = SVPWM_Duty( pTiming->Cmp[i], Ts ) * Ts;
+    if ( w <= 0.0 || w >= Ts )
+    {
+      continue;   /* clamped, no edge */
+    }
+    if ( pTiming->Inv[i] )
+    {
+      pEdges[n++] = 0.5 * ( Ts - w );
+      pEdges[n++] = 0.5 * ( Ts + w );
+    }
+    else
+    {
+      pEdges[n++] = 0.5 * w;
+      pEdges[n++] = Ts - 0.5 * w;
+    }
+  }
+
+  /* insertion sort, n <= 6 */
+  for ( i = 1; i < n; i++ )
+  {
+    w = pEdges[i];
+    for ( j = i; j > 0 && pEdges[j - 1] > w; j-- )
+    {
+      pEdges[j] = pEdges[j - 1];
+    }
+    pEdges[j] = w;
+  }
+  return ( n );
+}
+
+/**
+  * @brief  Half-bridge transitions in one period
+  * @param  pTiming compare values
+  * @param  pPhase per phase counts U, V, W, may be NULL
+  * @retval total, each step of (U+V+W)/3 is Vbus/3
+  */
+int SVPWM_Switchings( const SVPWM_Timing_t * pTiming, int * pPhase )
+{
+  int total = 0;
+  int i;
+  int n;
+
+  for ( i = 0; i < 3; i++ )
+  {
+    double d = SVPWM_Duty( pTiming->Cmp[i], pTiming->Ts );
+
+    n = ( d > 0.0 && d < 1.0 ) ? 2 : 0;
+    if ( pPhase != NULL )
+    {
+      pPhase[i] = n;
+    }
+    total += n;
+  }
+  return ( total );
+}
+
+/**
+  * @brief  Period average of the common-mode voltage (U+V+W)/3, same
+  *         reference as the phase levels (0 = gnd)
+  */
+double SVPWM_Cmv_Average( const SVPWM_Timing_t * pTiming, double Vbus )
+{
+  const double Ts = pTiming->Ts;
+
+  return ( Vbus * ( SVPWM_Duty( pTiming->Cmp[0], Ts ) +
+                    SVPWM_Duty( pTiming->Cmp[1], Ts ) +
+                    SVPWM_Duty( pTiming->Cmp[2], Ts ) ) / 3.0 );
+}
+
+/**
+  * @brief  Period average of the (alpha, beta) voltage the compare values
+  *         produce on a bus Vbus, amplitude invariant Clarke transform of
+  *         the phase averages; differs from the request when overmodulated
+  *         or when the bus moved away from the one the timing assumed
+  * @param  pVab Valpha, Vbeta (V)
+  */
+void SVPWM_Vab_Average( const SVPWM_Timing_t * pTiming, double Vbus,
+                        double * pVab )
+{
+  const double Ts = pTiming->Ts;
+  double       u  = SVPWM_Duty( pTiming->Cmp[0], Ts );
+  double       v  = SVPWM_Duty( pTiming->Cmp[1], Ts );
+  double       w  = SVPWM_Duty( pTiming->Cmp[2], Ts );
+
+  pVab[0] = Vbus * ( 2.0 * u - v - w ) / 3.0;
+  pVab[1] = Vbus * ( v - w ) / sqrt( 3.0 );
+}
+
+/***************  END OF FILE****/
@@ -0,0 +1,126 @@
+/**
+  ******************************************************************************
+  * @file    svpwm_core.h
+  * @brief   This file contains all definitions and functions prototypes for the
+  *          space vector PWM timing shared by the svpwm S-function and the
+  *          standalone simulation
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  * Inputs are (Valpha, Vbeta) normalized to the modulation index, i.e. 1.0
+  * is 2/3*Vbus (the svpwm S-function divides its 14-bit inputs by 2^14).
+  * The linear range is |V| <= sqrt(3)/2.
+  *
+  * Center-aligned PWM: the carrier ramps 0 -> Ts -> 0 over one period and
+  * a half-bridge is high while its compare value is above the carrier, so
+  * phase x is high on [0, Cmp/2] and [Ts - Cmp/2, Ts]. A phase with Inv
+  * set compares against the inverted carrier Ts - ramp instead and is high
+  * on [(Ts - Cmp)/2, (Ts + Cmp)/2], same duty, pulse in the period middle.
+  *
+  * Reduced common-mode modulations (SVPWM_Apply_Modulation) replace the
+  * zero vectors, where (U+V+W)/3 swings to 0 and Vbus:
+  *   AZSPWM  middle phase on the inverted carrier, the zero vector time
+  *           goes to two opposite active vectors; duties unchanged
+  *   NSPWM   the phase farthest from the mean is clamped to its rail, the
+  *           middle phase inverted: three adjacent active vectors only.
+  *           Zero vector free for |V| >= 1/sqrt(3) (normalized), below
+  *           that the pulses overlap; the average is right for any |V|
+  *
+  * Timing engines (SVPWM_Calc_Timing_Engine):
+  *   FULL     sector from the vector angle, dwell times per sector
+  *   TRACKED  the same, sector tracked from the previous sample: two
+  *            cross products per sample, atan2 only on a jump; Angle is
+  *            not computed (0)
+  *   MINMAX   zero-sequence injection: the phase references of the inverse
+  *            Clarke transform are shifted by -(max + min)/2, no angle and
+  *            no sector search; same compare values to rounding, also when
+  *            overmodulated. Sector, T1, T2 and Tz are recovered from the
+  *            phase order, Angle is not computed (0)
+  *
+  * Bus ripple: the inputs are normalized to a nominal Vbus. Driven from a
+  * measured bus Vbus_k the dwell times scale by Vnom/Vbus_k; scaling
+  * (Valpha, Vbeta) by that gain before the timing is the same in the linear
+  * range and overmodulation still clips against Ts. SVPWM_Vab_Average()
+  * gives the (alpha, beta) voltage the compare values actually produce.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SVPWM_CORE_H
+#define __SVPWM_CORE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+typedef enum
+{
+  SVPWM_MOD_SVPWM  = 0,   /**< centered zero vectors, default      */
+  SVPWM_MOD_AZSPWM = 1,   /**< active zero state pwm               */
+  SVPWM_MOD_NSPWM  = 2    /**< near state pwm                      */
+} SVPWM_Modulation_t;
+
+typedef enum
+{
+  SVPWM_ENGINE_FULL    = 0,   /**< sector searched every sample, default */
+  SVPWM_ENGINE_TRACKED = 1,   /**< sector tracked from the previous one  */
+  SVPWM_ENGINE_MINMAX  = 2    /**< min/max zero-sequence injection       */
+} SVPWM_Engine_t;
+
+typedef struct
+{
+  double  Angle;    /**< voltage vector angle, radians                */
+  int16_t Sector;   /**< 1..6                                         */
+  double  T1;       /**< first active vector time                     */
+  double  T2;       /**< second active vector time                    */
+  double  Tz;       /**< zero vector time, < 0 when overmodulated     */
+  double  Ta;       /**< T1 + T2 + T0/2                               */
+  double  Tb;       /**< T1 + T0/2                                    */
+  double  Tc;       /**< T2 + T0/2                                    */
+  double  Td;       /**< T0/2                                         */
+  double  Cmp[3];   /**< compare times of half-bridges U, V, W (s)    */
+  uint8_t Inv[3];   /**< 1: phase on the inverted carrier             */
+  double  Ts;       /**< pwm period the compare times are for (s)     */
+} SVPWM_Timing_t;
+
+/* Exported functions ------------------------------------------------------- */
+
+void   SVPWM_Calc_Timing( double Va, double Vb, double Ts,
+                          SVPWM_Timing_t * pTiming );
+void   SVPWM_Calc_Timing_Tracked( double Va, double Vb, double Ts,
+                                  int16_t * pSector, SVPWM_Timing_t * pTiming );
+void   SVPWM_Calc_Timing_MinMax( double Va, double Vb, double Ts,
+                                 SVPWM_Timing_t * pTiming );
+void   SVPWM_Calc_Timing_Engine( SVPWM_Engine_t Engine, double Va, double Vb,
+                                 double Ts, int16_t * pSector,
+                                 SVPWM_Timing_t * pTiming );
+int16_t SVPWM_Sector_Full( double angle );
+void   SVPWM_Dwell_Times( double Va, double Vb, double angle, int16_t sector,
+                          double Ts, SVPWM_Timing_t * pTiming );
+void   SVPWM_Map_Phases( SVPWM_Timing_t * pTiming );
+void   SVPWM_Dwell_Batch( const double * pVa, const double * pVb,
+                          const int16_t * pSector, uint32_t n,
+                          double * pDel1, double * pDel2 );
+void   SVPWM_Phase_Levels( const SVPWM_Timing_t * pTiming, double ramp,
+                           double Vbus, double * pUVW );
+double SVPWM_Duty( double Cmp, double Ts );
+void   SVPWM_Apply_Modulation( SVPWM_Timing_t * pTiming,
+                               SVPWM_Modulation_t Mode );
+int    SVPWM_Edges( const SVPWM_Timing_t * pTiming, double * pEdges );
+int    SVPWM_Switchings( const SVPWM_Timing_t * pTiming, int * pPhase );
+double SVPWM_Cmv_Average( const SVPWM_Timing_t * pTiming, double Vbus );
+void   SVPWM_Vab_Average( const SVPWM_Timing_t * pTiming, double Vbus,
+                          double * pVab );
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __SVPWM_CORE_H */
+
+/* *****END OF FILE****/
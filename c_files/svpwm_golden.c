@@ -0,0 +1,715 @@
+/**
+  ******************************************************************************
+  * @file    svpwm_golden.c
+  * @brief   This file provides the svpwm golden vectors and the regression
+  *          check of the timing engines against them, see svpwm_golden.h
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * license info:
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "svpwm_core.h"
+#include "svpwm_real.h"
+#include "svpwm_batch.h"
+#include "svpwm_golden.h"
+
+#define PI      3.14159265358979323846
+#define SQRT3_2 0.86602540378443864676   /* sqrt(3)/2, linear limit */
+#define DEG     0.01745329251994329577   /* pi/180                  */
+
+#define GOLDEN_MAG_STEPS 84u   /* 0 .. 83/64                      */
+#define GOLDEN_MAG_EXTRA 5u
+#define GOLDEN_HEADER    32u
+#define GOLDEN_ULP_FLOOR 1e-3  /* MaxUlp of outputs above 1e-3*Ts */
+
+/* checked outputs */
+#define OUT_T1     0x01u
+#define OUT_T2     0x02u
+#define OUT_TZ     0x04u
+#define OUT_CMP    0x08u
+#define OUT_SECTOR 0x10u
+#define OUT_ALL    0x1Fu
+
+typedef struct
+{
+  uint64_t Ulp;   /**< passes within Ulp units in the last place  */
+  double   Abs;   /**< or within Abs*Ts                           */
+} SVPWM_Golden_Tol_t;
+
+typedef struct
+{
+  const char *       Name;
+  uint32_t           Outputs;    /**< OUT_xxx checked                  */
+  uint32_t           Boundary;   /**< OUT_xxx skipped on boundaries    */
+  SVPWM_Golden_Tol_t Tol[4];     /**< T1, T2, Tz, Cmp                  */
+} SVPWM_Golden_Variant_t;
+
+/* Tolerances are about ten times the errors measured against the frozen
+   baseline timing (1.7e-15 double, 1.9e-7 float32) when it was
+   introduced; no variant is bit exact to the cos/sin formula since the
+   basis matrices of SVPWM_Dwell(). */
+static const SVPWM_Golden_Variant_t SVPWM_Golden_Variants[] =
+{
+  { "full",       OUT_ALL, 0u,
+    { { 0u, 2e-14 },  { 0u, 2e-14 },  { 0u, 2e-14 },  { 0u, 2e-14 } } },
+  { "tracked",    OUT_ALL, OUT_T1 | OUT_T2 | OUT_SECTOR,
+    { { 0u, 2e-14 },  { 0u, 2e-14 },  { 0u, 2e-14 },  { 0u, 2e-14 } } },
+  { "minmax",     OUT_ALL, OUT_T1 | OUT_T2 | OUT_SECTOR,
+    { { 0u, 2e-14 },  { 0u, 2e-14 },  { 0u, 2e-14 },  { 0u, 2e-14 } } },
+  { "dwell",      OUT_T1 | OUT_T2, 0u,
+    { { 0u, 2e-14 },  { 0u, 2e-14 },  { 0u, 0.0 },    { 0u, 0.0 } } },
+  { "f64",        OUT_ALL, 0u,
+    { { 0u, 2e-14 },  { 0u, 2e-14 },  { 0u, 2e-14 },  { 0u, 2e-14 } } },
+  { "f32",        OUT_TZ | OUT_CMP | OUT_SECTOR, OUT_SECTOR,
+    { { 0u, 0.0 },    { 0u, 0.0 },    { 0u, 2e-6 },   { 0u, 2e-6 } } },
+  { "batch",      OUT_CMP, 0u,
+    { { 0u, 0.0 },    { 0u, 0.0 },    { 0u, 0.0 },    { 0u, 1e-14 } } },
+};
+
+#define VAR_FULL    0
+#define VAR_TRACKED 1
+#define VAR_MINMAX  2
+#define VAR_DWELL   3
+#define VAR_F64     4
+#define VAR_F32     5
+#define VAR_BATCH   6
+
+static const char * const SVPWM_Golden_Batch_Names[SVPWM_ISA_NUM] =
+{
+  "batch generic", "batch avx2", "batch avx512"
+};
+
+static const char * const SVPWM_Golden_Outputs[] =
+{
+  "T1", "T2", "Tz", "CmpU", "CmpV", "CmpW", "Sector"
+};
+
+/* sign-magnitude bits to a monotonic integer, for ulp distances */
+static int64_t SVPWM_Golden_Ordered( double x )
+{
+  int64_t i;
+
+  memcpy( &i, &x, sizeof( i ) );
+  return ( ( i < 0 ) ? INT64_MIN - i : i );
+}
+
+static uint64_t SVPWM_Golden_Ulp( double a, double b )
+{
+  int64_t ia = SVPWM_Golden_Ordered( a );
+  int64_t ib = SVPWM_Golden_Ordered( b );
+
+  return ( ( ia > ib ) ? ( uint64_t )ia - ( uint64_t )ib
+                       : ( uint64_t )ib - ( uint64_t )ia );
+}
+
+static void SVPWM_Golden_Put( SVPWM_Golden_t * pVec, uint32_t Max,
+                              uint32_t * pN, double Va, double Vb,
+                              uint8_t Flags )
+{
+  if ( pVec != NULL && *pN < Max )
+  {
+    memset( &pVec[*pN], 0, sizeof( SVPWM_Golden_t ) );
+    pVec[*pN].Va    = Va;
+    pVec[*pN].Vb    = Vb;
+    pVec[*pN].Flags = Flags;
+  }
+  ( *pN )++;
+}
+
+/**
+  * @brief  Input vectors, outputs cleared
+  * @param  pVec room for Max vectors, or NULL to count them
+  * @retval number of vectors, also when above Max
+  */
+uint32_t SVPWM_Golden_Inputs( SVPWM_Golden_t * pVec, uint32_t Max )
+{
+  /* boundary directions, exact to the double nearest sqrt(3)/2 */
+  static const double Dir[6][2] =
+  {
+    {  1.0, 0.0 }, {  0.5,  SQRT3_2 }, { -0.5,  SQRT3_2 },
+    { -1.0, 0.0 }, { -0.5, -SQRT3_2 }, {  0.5, -SQRT3_2 }
+  };
+  double   mag[GOLDEN_MAG_STEPS + GOLDEN_MAG_EXTRA];
+  uint32_t nMag = 0u;
+  uint32_t n    = 0u;
+  uint32_t m;
+  uint32_t d;
+
+  for ( m = 0u; m < GOLDEN_MAG_STEPS; m++ )
+  {
+    mag[nMag++] = ( double )m / 64.0;
+  }
+  mag[nMag++] = 1e-12;
+  mag[nMag++] = 1.0 / sqrt( 3.0 );
+  mag[nMag++] = nextafter( SQRT3_2, 0.0 );
+  mag[nMag++] = SQRT3_2;
+  mag[nMag++] = nextafter( SQRT3_2, 2.0 );
+
+  for ( m = 0u; m < nMag; m++ )
+  {
+    uint8_t zero = ( mag[m] == 0.0 ) ? SVPWM_GOLDEN_BOUNDARY : 0u;
+
+    for ( d = 0u; d < 360u; d++ )
+    {
+      double a = ( double )d * DEG;
+
+      if ( d % 60u == 0u )
+      {
+        continue;   /* below, exact */
+      }
+      SVPWM_Golden_Put( pVec, Max, &n, mag[m] * cos( a ), mag[m] * sin( a ),
+                        zero );
+    }
+    for ( d = 0u; d < 6u; d++ )
+    {
+      double va = mag[m] * Dir[d][0];
+      double vb = mag[m] * Dir[d][1];
+      uint8_t f = SVPWM_GOLDEN_BOUNDARY;
+
+      SVPWM_Golden_Put( pVec, Max, &n, va, vb, f );
+      if ( zero )
+      {
+        continue;
+      }
+      SVPWM_Golden_Put( pVec, Max, &n, nextafter( va, -2.0 ), vb, f );
+      SVPWM_Golden_Put( pVec, Max, &n, nextafter( va,  2.0 ), vb, f );
+      SVPWM_Golden_Put( pVec, Max, &n, va, nextafter( vb, -2.0 ), f );
+      SVPWM_Golden_Put( pVec, Max, &n, va, nextafter( vb,  2.0 ), f );
+    }
+  }
+  return ( n );
+}
+
+/* Frozen copy of the timing of the original svpwm mdlOutputs: angle,
+   sector by degrees, del1/del2 from cos/sin and the sector switch.
+   Keep it as it is, it is what every engine is measured against. The
+   one deliberate change since: -180 deg fell through to sector 1 there,
+   sector 4 now; *pPi is set for those vectors. */
+static void SVPWM_Golden_Baseline( double Va, double Vb, double Ts,
+                                   SVPWM_Golden_t * pOut, int * pPi )
+{
+  double  angle;    // radians
+  double  deg;      // degrees
+  int16_t sector;
+  double  ta;       // computed switch time T1 + T2 + T0/2
+  double  tb;       // computed switch time T1 + T0/2
+  double  tc;       // computed switch time T2 + T0/2
+  double  td;       // computed switch time T0/2
+  double  T1;
+  double  T2;
+  double  Tz;
+  double  del1;
+  double  del2;
+  double  del3;
+  double  Mi;
+  double  n;
+
+  angle = atan2(Vb, Va);
+  deg = angle * 180.0/PI;
+  Mi = sqrt(Vb*Vb + Va*Va);
+
+  // compute sector number [1..6]
+  if (deg>= 0 && deg <= 60) {
+     sector = 1; }
+  else if (deg > 60 && deg <= 120) {
+     sector = 2; }
+  else if (deg > 120 && deg <= 180) {
+     sector = 3; }
+  else if (deg < -120 && deg > -180) {
+     sector = 4; }
+  else if (deg < -60 && deg >= -120) {
+     sector = 5; }
+  else if (deg < 0  && deg >= -60) {
+     sector = 6; }
+  else {
+      sector = 1;
+  }
+  *pPi = ( deg == -180.0 );
+  if ( *pPi )
+  {
+    sector = 4;
+  }
+  n = sector;
+
+  del1 = (2.0/sqrt(3))*(Mi)*(cos(angle)*sin(n*PI/3.0) - sin(angle)*cos(n*PI/3.0));
+  del2 = (2.0/sqrt(3))*(Mi)*(sin(angle)*cos((n-1.0)*PI/3.0) - cos(angle)*sin((n-1.0)*PI/3.0));
+  del3 = 1.0 - fabs(del1)- fabs(del2);
+
+  T1 = del1*(Ts);
+  T2 = del2*(Ts);
+  Tz = del3*(Ts);
+
+  td = (Tz)/2.0;
+  ta = T1 + T2 + td;
+  tb = T1 + td;
+  tc = T2 + td;
+
+  pOut->T1     = T1;
+  pOut->T2     = T2;
+  pOut->Tz     = Tz;
+  pOut->Sector = ( int8_t )sector;
+  switch(sector) {
+  case 1  :
+    pOut->Cmp[0] = ta;   // sequence U
+    pOut->Cmp[1] = tc;   //          V
+    pOut->Cmp[2] = td;   //          W
+    break;
+  case 2  :
+    pOut->Cmp[0] = tb;
+    pOut->Cmp[1] = ta;
+    pOut->Cmp[2] = td;
+    break;
+  case 3  :
+    pOut->Cmp[0] = td;
+    pOut->Cmp[1] = ta;
+    pOut->Cmp[2] = tc;
+    break;
+  case 4  :
+    pOut->Cmp[0] = td;
+    pOut->Cmp[1] = tb;
+    pOut->Cmp[2] = ta;
+    break;
+  case 5  :
+    pOut->Cmp[0] = tc;
+    pOut->Cmp[1] = td;
+    pOut->Cmp[2] = ta;
+    break;
+  case 6  :
+    pOut->Cmp[0] = ta;
+    pOut->Cmp[1] = td;
+    pOut->Cmp[2] = tb;
+    break;
+  default :
+    pOut->Cmp[0] = ta;
+    pOut->Cmp[1] = tc;
+    pOut->Cmp[2] = td;
+  }
+}
+
+/**
+  * @brief  Golden outputs of the inputs: the frozen baseline timing of the
+  *         original svpwm mdlOutputs, not the svpwm_core.h code under test
+  * @param  Ts pwm period (s)
+  */
+void SVPWM_Golden_Reference( SVPWM_Golden_t * pVec, uint32_t n, double Ts )
+{
+  uint32_t i;
+  int      pi;
+
+  for ( i = 0u; i < n; i++ )
+  {
+    SVPWM_Golden_Baseline( pVec[i].Va, pVec[i].Vb, Ts, &pVec[i], &pi );
+    pVec[i].Flags = ( uint8_t )( ( pVec[i].Flags & ~( SVPWM_GOLDEN_OVERMOD | SVPWM_GOLDEN_PI ) )
+                               | ( ( pVec[i].Tz < 0.0 ) ? SVPWM_GOLDEN_OVERMOD : 0u )
+                               | ( pi ? SVPWM_GOLDEN_PI : 0u ) );
+  }
+}
+
+static void SVPWM_Golden_Put_U32( uint8_t * p, uint32_t x )
+{
+  p[0] = ( uint8_t )x;
+  p[1] = ( uint8_t )( x >> 8 );
+  p[2] = ( uint8_t )( x >> 16 );
+  p[3] = ( uint8_t )( x >> 24 );
+}
+
+static uint32_t SVPWM_Golden_Get_U32( const uint8_t * p )
+{
+  return ( ( uint32_t )p[0] | ( ( uint32_t )p[1] << 8 )
+         | ( ( uint32_t )p[2] << 16 ) | ( ( uint32_t )p[3] << 24 ) );
+}
+
+static void SVPWM_Golden_Put_F64( uint8_t * p, double x )
+{
+  uint64_t u;
+
+  memcpy( &u, &x, sizeof( u ) );
+  SVPWM_Golden_Put_U32( p, ( uint32_t )u );
+  SVPWM_Golden_Put_U32( p + 4, ( uint32_t )( u >> 32 ) );
+}
+
+static double SVPWM_Golden_Get_F64( const uint8_t * p )
+{
+  uint64_t u = ( uint64_t )SVPWM_Golden_Get_U32( p )
+             | ( ( uint64_t )SVPWM_Golden_Get_U32( p + 4 ) << 32 );
+  double   x;
+
+  memcpy( &x, &u, sizeof( x ) );
+  return ( x );
+}
+
+/**
+  * @brief  Store vectors in the binary format of svpwm_golden.h
+  * @retval 0 on success, -1 if the file cannot be written
+  */
+int SVPWM_Golden_Write( const char * pPath, const SVPWM_Golden_t * pVec,
+                        uint32_t n, double Ts )
+{
+  uint8_t  buf[SVPWM_GOLDEN_RECORD];
+  FILE *   f = fopen( pPath, "wb" );
+  uint32_t i;
+  int      rc = 0;
+
+  if ( f == NULL )
+  {
+    return ( -1 );
+  }
+  memset( buf, 0, sizeof( buf ) );
+  memcpy( buf, "SVPWMGV1", 8 );
+  SVPWM_Golden_Put_U32( &buf[8], SVPWM_GOLDEN_VERSION );
+  SVPWM_Golden_Put_U32( &buf[12], n );
+  SVPWM_Golden_Put_F64( &buf[16], Ts );
+  SVPWM_Golden_Put_U32( &buf[24], SVPWM_GOLDEN_RECORD );
+  if ( fwrite( buf, GOLDEN_HEADER, 1, f ) != 1 )
+  {
+    rc = -1;
+  }
+  for ( i = 0u; i < n && rc == 0; i++ )
+  {
+    const SVPWM_Golden_t * v = &pVec[i];
+
+    SVPWM_Golden_Put_F64( &buf[0],  v->Va );
+    SVPWM_Golden_Put_F64( &buf[8],  v->Vb );
+    SVPWM_Golden_Put_F64( &buf[16], v->T1 );
+    SVPWM_Golden_Put_F64( &buf[24], v->T2 );
+    if ( fwrite( buf, 32, 1, f ) != 1 )
+    {
+      rc = -1;
+    }
+    SVPWM_Golden_Put_F64( &buf[0],  v->Tz );
+    SVPWM_Golden_Put_F64( &buf[8],  v->Cmp[0] );
+    SVPWM_Golden_Put_F64( &buf[16], v->Cmp[1] );
+    SVPWM_Golden_Put_F64( &buf[24], v->Cmp[2] );
+    buf[32] = ( uint8_t )v->Sector;
+    buf[33] = v->Flags;
+    if ( fwrite( buf, SVPWM_GOLDEN_RECORD - 32u, 1, f ) != 1 )
+    {
+      rc = -1;
+    }
+  }
+  if ( fclose( f ) != 0 )
+  {
+    rc = -1;
+  }
+  return ( rc );
+}
+
+/**
+  * @brief  Load vectors stored by SVPWM_Golden_Write()
+  * @param  ppVec allocated with malloc, freed by the caller
+  * @retval 0 on success, -1 if the file is missing, short or of another
+  *         format or version
+  */
+int SVPWM_Golden_Read( const char * pPath, SVPWM_Golden_t ** ppVec,
+                       uint32_t * pN, double * pTs )
+{
+  uint8_t          buf[SVPWM_GOLDEN_RECORD];
+  FILE *           f = fopen( pPath, "rb" );
+  SVPWM_Golden_t * pVec;
+  uint32_t         n;
+  uint32_t         i;
+
+  *ppVec = NULL;
+  if ( f == NULL )
+  {
+    return ( -1 );
+  }
+  if ( fread( buf, GOLDEN_HEADER, 1, f ) != 1 ||
+       memcmp( buf, "SVPWMGV1", 8 ) != 0 ||
+       SVPWM_Golden_Get_U32( &buf[8] ) != SVPWM_GOLDEN_VERSION ||
+       SVPWM_Golden_Get_U32( &buf[24] ) != SVPWM_GOLDEN_RECORD )
+  {
+    fclose( f );
+    return ( -1 );
+  }
+  n    = SVPWM_Golden_Get_U32( &buf[12] );
+  *pTs = SVPWM_Golden_Get_F64( &buf[16] );
+  pVec = ( SVPWM_Golden_t * )malloc( ( size_t )( n ? n : 1u ) * sizeof( SVPWM_Golden_t ) );
+  if ( pVec == NULL )
+  {
+    fclose( f );
+    return ( -1 );
+  }
+  for ( i = 0u; i < n; i++ )
+  {
+    SVPWM_Golden_t * v = &pVec[i];
+
+    if ( fread( buf, SVPWM_GOLDEN_RECORD, 1, f ) != 1 )
+    {
+      free( pVec );
+      fclose( f );
+      return ( -1 );
+    }
+    v->Va     = SVPWM_Golden_Get_F64( &buf[0] );
+    v->Vb     = SVPWM_Golden_Get_F64( &buf[8] );
+    v->T1     = SVPWM_Golden_Get_F64( &buf[16] );
+    v->T2     = SVPWM_Golden_Get_F64( &buf[24] );
+    v->Tz     = SVPWM_Golden_Get_F64( &buf[32] );
+    v->Cmp[0] = SVPWM_Golden_Get_F64( &buf[40] );
+    v->Cmp[1] = SVPWM_Golden_Get_F64( &buf[48] );
+    v->Cmp[2] = SVPWM_Golden_Get_F64( &buf[56] );
+    v->Sector = ( int8_t )buf[64];
+    v->Flags  = buf[65];
+  }
+  fclose( f );
+  *ppVec = pVec;
+  *pN    = n;
+  return ( 0 );
+}
+
+/* one output against its golden value, result updated */
+static void SVPWM_Golden_Compare( const SVPWM_Golden_Tol_t * pTol, uint32_t Out,
+                                  uint32_t Index, double Got, double Exp,
+                                  double Ts, SVPWM_Golden_Result_t * pRes,
+                                  int * pFail )
+{
+  double   err = fabs( Got - Exp ) / Ts;
+  uint64_t ulp = SVPWM_Golden_Ulp( Got, Exp );
+
+  pRes->MaxAbs = ( err > pRes->MaxAbs ) ? err : pRes->MaxAbs;
+  if ( fabs( Exp ) >= GOLDEN_ULP_FLOOR * Ts )
+  {
+    /* near 0 the ulp distance says nothing, Abs covers it */
+    pRes->MaxUlp = ( ulp > pRes->MaxUlp ) ? ulp : pRes->MaxUlp;
+  }
+  if ( err <= pTol->Abs || ulp <= pTol->Ulp || *pFail )
+  {
+    return;
+  }
+  *pFail = 1;
+  if ( pRes->Failed == 0u )
+  {
+    pRes->First    = Index;
+    pRes->Output   = SVPWM_Golden_Outputs[Out];
+    pRes->Got      = Got;
+    pRes->Expected = Exp;
+  }
+}
+
+/* outputs of vector Index from a variant against the golden ones */
+static void SVPWM_Golden_Vector( const SVPWM_Golden_Variant_t * pVar,
+                                 const SVPWM_Golden_t * pGold,
+                                 const SVPWM_Golden_t * pGot, uint32_t Index,
+                                 double Ts, SVPWM_Golden_Result_t * pRes )
+{
+  uint32_t out  = pVar->Outputs;
+  int      fail = 0;
+  int      k;
+
+  if ( pGold->Flags & SVPWM_GOLDEN_BOUNDARY )
+  {
+    out &= ~pVar->Boundary;
+  }
+  if ( ( out & OUT_SECTOR ) && pGot->Sector != pGold->Sector )
+  {
+    fail = 1;
+    if ( pRes->Failed == 0u )
+    {
+      pRes->First    = Index;
+      pRes->Output   = SVPWM_Golden_Outputs[6];
+      pRes->Got      = pGot->Sector;
+      pRes->Expected = pGold->Sector;
+    }
+  }
+  if ( out & OUT_T1 )
+  {
+    SVPWM_Golden_Compare( &pVar->Tol[0], 0u, Index, pGot->T1, pGold->T1, Ts,
+                          pRes, &fail );
+  }
+  if ( out & OUT_T2 )
+  {
+    SVPWM_Golden_Compare( &pVar->Tol[1], 1u, Index, pGot->T2, pGold->T2, Ts,
+                          pRes, &fail );
+  }
+  if ( out & OUT_TZ )
+  {
+    SVPWM_Golden_Compare( &pVar->Tol[2], 2u, Index, pGot->Tz, pGold->Tz, Ts,
+                          pRes, &fail );
+  }
+  if ( out & OUT_CMP )
+  {
+    for ( k = 0; k < 3; k++ )
+    {
+      SVPWM_Golden_Compare( &pVar->Tol[3], 3u + ( uint32_t )k, Index,
+                            pGot->Cmp[k], pGold->Cmp[k], Ts, pRes, &fail );
+    }
+  }
+  pRes->Vectors++;
+  pRes->Failed += ( uint32_t )fail;
+}
+
+static void SVPWM_Golden_From_Timing( const SVPWM_Timing_t * pTiming,
+                                      SVPWM_Golden_t * pGot )
+{
+  pGot->T1     = pTiming->T1;
+  pGot->T2     = pTiming->T2;
+  pGot->Tz     = pTiming->Tz;
+  pGot->Cmp[0] = pTiming->Cmp[0];
+  pGot->Cmp[1] = pTiming->Cmp[1];
+  pGot->Cmp[2] = pTiming->Cmp[2];
+  pGot->Sector = ( int8_t )pTiming->Sector;
+}
+
+/* scalar engines, one vector at a time */
+static void SVPWM_Golden_Scalar( int Var, const SVPWM_Golden_t * pVec,
+                                 uint32_t n, double Ts,
+                                 SVPWM_Golden_Result_t * pRes )
+{
+  const SVPWM_Golden_Variant_t * pVar = &SVPWM_Golden_Variants[Var];
+  SVPWM_Golden_t     got;
+  SVPWM_Timing_t     t;
+  SVPWM_Timing_F32_t t32;
+  SVPWM_Timing_F64_t t64;
+  int16_t            sector = 0;
+  uint32_t           i;
+
+  memset( pRes, 0, sizeof( SVPWM_Golden_Result_t ) );
+  pRes->Name = pVar->Name;
+  for ( i = 0u; i < n; i++ )
+  {
+    const SVPWM_Golden_t * v = &pVec[i];
+
+    switch ( Var )
+    {
+      case VAR_TRACKED:
+        /* in file order: sweeps of the angle, sector carried over */
+        SVPWM_Calc_Timing_Tracked( v->Va, v->Vb, Ts, &sector, &t );
+        break;
+      case VAR_MINMAX:
+        SVPWM_Calc_Timing_MinMax( v->Va, v->Vb, Ts, &t );
+        break;
+      case VAR_F64:
+        SVPWM_Calc_Timing_F64( v->Va, v->Vb, Ts, &t64 );
+        t.T1 = t64.T1;  t.T2 = t64.T2;  t.Tz = t64.Tz;
+        t.Cmp[0] = t64.Cmp[0];  t.Cmp[1] = t64.Cmp[1];  t.Cmp[2] = t64.Cmp[2];
+        t.Sector = t64.Sector;
+        break;
+      case VAR_F32:
+        SVPWM_Calc_Timing_F32( ( float )v->Va, ( float )v->Vb, ( float )Ts,
+                               &t32 );
+        SVPWM_Timing_From_F32( &t32, &t );
+        break;
+      default:
+        SVPWM_Calc_Timing( v->Va, v->Vb, Ts, &t );
+        break;
+    }
+    SVPWM_Golden_From_Timing( &t, &got );
+    SVPWM_Golden_Vector( pVar, v, &got, i, Ts, pRes );
+  }
+}
+
+/* array kernels: dwell times on the golden sectors, min/max duties */
+static int SVPWM_Golden_Arrays( int Var, const SVPWM_Golden_t * pVec,
+                                uint32_t n, double Ts,
+                                SVPWM_Golden_Result_t * pRes )
+{
+  const SVPWM_Golden_Variant_t * pVar = &SVPWM_Golden_Variants[Var];
+  double *  buf = ( double * )malloc( ( size_t )( n ? n : 1u ) * 5u * sizeof( double ) );
+  int16_t * sec = ( int16_t * )malloc( ( size_t )( n ? n : 1u ) * sizeof( int16_t ) );
+  double *  va  = buf;
+  double *  vb  = buf + n;
+  double *  o   = buf + 2u * n;
+  SVPWM_Golden_t got;
+  uint32_t       i;
+
+  if ( buf == NULL || sec == NULL )
+  {
+    free( buf );
+    free( sec );
+    return ( -1 );
+  }
+  memset( pRes, 0, sizeof( SVPWM_Golden_Result_t ) );
+  pRes->Name = ( Var == VAR_BATCH ) ? SVPWM_Golden_Batch_Names[SVPWM_Batch_Isa()]
+                                    : pVar->Name;
+  for ( i = 0u; i < n; i++ )
+  {
+    va[i]  = pVec[i].Va;
+    vb[i]  = pVec[i].Vb;
+    sec[i] = pVec[i].Sector;
+  }
+  if ( Var == VAR_BATCH )
+  {
+    SVPWM_MinMax_Batch( va, vb, n, o, o + n, o + 2u * n );
+  }
+  else
+  {
+    SVPWM_Dwell_Batch( va, vb, sec, n, o, o + n );
+  }
+  for ( i = 0u; i < n; i++ )
+  {
+    got = pVec[i];
+    if ( Var == VAR_BATCH )
+    {
+      got.Cmp[0] = o[i] * Ts;
+      got.Cmp[1] = o[n + i] * Ts;
+      got.Cmp[2] = o[2u * n + i] * Ts;
+    }
+    else
+    {
+      got.T1 = o[i] * Ts;
+      got.T2 = o[n + i] * Ts;
+    }
+    SVPWM_Golden_Vector( pVar, &pVec[i], &got, i, Ts, pRes );
+  }
+  free( buf );
+  free( sec );
+  return ( 0 );
+}
+
+/**
+  * @brief  Check every engine variant against golden vectors: the FULL,
+  *         TRACKED and MINMAX engines, the F64 and F32 instances, the
+  *         dwell time kernel and the min/max batch kernel in every
+  *         instruction set the CPU supports
+  * @param  pRes one result per variant checked
+  * @param  MaxRes room in pRes
+  * @retval number of results, the check passed if all have Failed == 0
+  */
+uint32_t SVPWM_Golden_Check( const SVPWM_Golden_t * pVec, uint32_t n,
+                             double Ts, SVPWM_Golden_Result_t * pRes,
+                             uint32_t MaxRes )
+{
+  SVPWM_Isa_t isa0 = SVPWM_Batch_Isa();
+  uint32_t    nRes = 0u;
+  int         var;
+  int         isa;
+
+  for ( var = VAR_FULL; var <= VAR_F32 && nRes < MaxRes; var++ )
+  {
+    if ( var == VAR_DWELL )
+    {
+      if ( SVPWM_Golden_Arrays( var, pVec, n, Ts, &pRes[nRes] ) == 0 )
+      {
+        nRes++;
+      }
+    }
+    else
+    {
+      SVPWM_Golden_Scalar( var, pVec, n, Ts, &pRes[nRes++] );
+    }
+  }
+  for ( isa = 0; isa < SVPWM_ISA_NUM && nRes < MaxRes; isa++ )
+  {
+    if ( ( int )SVPWM_Batch_Select( SVPWM_Batch_Isa_Name( ( SVPWM_Isa_t )isa ) ) != isa )
+    {
+      break;   /* not supported by this CPU */
+    }
+    if ( SVPWM_Golden_Arrays( VAR_BATCH, pVec, n, Ts, &pRes[nRes] ) == 0 )
+    {
+      nRes++;
+    }
+  }
+  SVPWM_Batch_Select( SVPWM_Batch_Isa_Name( isa0 ) );
+  return ( nRes );
+}
+
+/***************  END OF FILE****/
@@ -0,0 +1,102 @@
+/**
+  ******************************************************************************
+  * @file    svpwm_golden.h
+  * @brief   This file contains all definitions and functions prototypes for the
+  *          svpwm golden vectors: generation, binary file format and the check
+  *          of every timing engine variant against them
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  * Inputs: a polar grid of (Valpha, Vbeta), magnitudes 0 .. 1.3 in steps
+  * of 1/64 plus 1e-12, 1/sqrt(3), and the linear limit sqrt(3)/2 and its
+  * two neighbours, at every degree; on each sector boundary, 0, 60, ..
+  * 300 degrees, the point itself (exact cos/sin) and its four one-ulp
+  * neighbours in Valpha and Vbeta. These and the zero vector, where any
+  * sector is right, are flagged SVPWM_GOLDEN_BOUNDARY. The reference
+  * outputs, over Ts = 1, come from a frozen copy of the original svpwm
+  * mdlOutputs timing (atan2, sector by degrees, cos/sin dwell times) in
+  * svpwm_golden.c, not from the engines under test, so no stored file is
+  * needed. Tz < 0 is flagged SVPWM_GOLDEN_OVERMOD; vectors at exactly
+  * -180 deg, sector 1 in the original and 4 since the sector search fix,
+  * SVPWM_GOLDEN_PI.
+  *
+  * File, to keep a set across a change of the reference or of libm: a
+  * 32 byte header, magic "SVPWMGV1", uint32 version, uint32
+  * number of vectors, float64 Ts, uint32 record size, uint32 0; then one
+  * 66 byte record per vector: float64 Valpha, Vbeta, T1, T2, Tz, Cmp U,
+  * V, W, int8 sector, uint8 flags. All little endian, independent of the
+  * host.
+  *
+  * SVPWM_Golden_Check() runs each variant over all vectors and compares
+  * output by output: a value passes when it is within Ulp units in the
+  * last place of the golden one or within Abs*Ts of it. Variants whose
+  * sector may legitimately differ on a boundary (both neighbours give the
+  * same compare values) skip sector, T1 and T2 there.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SVPWM_GOLDEN_H
+#define __SVPWM_GOLDEN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+#define SVPWM_GOLDEN_VERSION  2u
+#define SVPWM_GOLDEN_RECORD   66u
+
+#define SVPWM_GOLDEN_BOUNDARY 0x01u   /**< on or next to a sector boundary */
+#define SVPWM_GOLDEN_OVERMOD  0x02u   /**< Tz < 0                          */
+#define SVPWM_GOLDEN_PI       0x04u   /**< -180 deg, sector 4, 1 before    */
+
+typedef struct
+{
+  double  Va;
+  double  Vb;
+  double  T1;
+  double  T2;
+  double  Tz;
+  double  Cmp[3];
+  int8_t  Sector;
+  uint8_t Flags;
+} SVPWM_Golden_t;
+
+typedef struct
+{
+  const char * Name;        /**< engine variant                          */
+  uint32_t     Vectors;     /**< vectors compared                        */
+  uint32_t     Failed;      /**< vectors with an output out of tolerance */
+  uint32_t     First;       /**< index of the first failed vector        */
+  const char * Output;      /**< its first output out of tolerance       */
+  double       Got;
+  double       Expected;
+  double       MaxAbs;      /**< largest error of any output / Ts        */
+  uint64_t     MaxUlp;      /**< largest error in ulps, outputs >= 1e-3*Ts */
+} SVPWM_Golden_Result_t;
+
+/* Exported functions ------------------------------------------------------- */
+
+uint32_t SVPWM_Golden_Inputs( SVPWM_Golden_t * pVec, uint32_t Max );
+void     SVPWM_Golden_Reference( SVPWM_Golden_t * pVec, uint32_t n,
+                                 double Ts );
+int      SVPWM_Golden_Write( const char * pPath, const SVPWM_Golden_t * pVec,
+                             uint32_t n, double Ts );
+int      SVPWM_Golden_Read( const char * pPath, SVPWM_Golden_t ** ppVec,
+                            uint32_t * pN, double * pTs );
+uint32_t SVPWM_Golden_Check( const SVPWM_Golden_t * pVec, uint32_t n,
+                             double Ts, SVPWM_Golden_Result_t * pRes,
+                             uint32_t MaxRes );
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __SVPWM_GOLDEN_H */
+
+/* *****END OF FILE****/
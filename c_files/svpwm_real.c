@@ -0,0 +1,66 @@
+/**
+  ******************************************************************************
+  * @file    svpwm_real.c
+  * @brief   This file provides the single and double precision instances of
+  *          the reverse Park + svpwm chain
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * license info:
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include "svpwm_real.h"
+
+#define REAL            float
+#define REAL_NAME( f )  f##_F32
+#define REAL_TIMING     SVPWM_Timing_F32_t
+#define REAL_C( x )     ( ( float )( x ) )
+#define REAL_SIN        sinf
+#define REAL_COS        cosf
+#define REAL_ATAN2      atan2f
+#define REAL_FABS       fabsf
+#include "svpwm_real_impl.h"
+
+#define REAL            double
+#define REAL_NAME( f )  f##_F64
+#define REAL_TIMING     SVPWM_Timing_F64_t
+#define REAL_C( x )     ( x )
+#define REAL_SIN        sin
+#define REAL_COS        cos
+#define REAL_ATAN2      atan2
+#define REAL_FABS       fabs
+#include "svpwm_real_impl.h"
+
+/**
+  * @brief  Widen a float timing to SVPWM_Timing_t, no inverted carrier
+  * @param  pIn from SVPWM_Calc_Timing_F32()
+  * @param  pOut result, ready for SVPWM_Apply_Modulation()
+  */
+void SVPWM_Timing_From_F32( const SVPWM_Timing_F32_t * pIn,
+                            SVPWM_Timing_t * pOut )
+{
+  int i;
+
+  pOut->Angle  = pIn->Angle;
+  pOut->Sector = pIn->Sector;
+  pOut->T1     = pIn->T1;
+  pOut->T2     = pIn->T2;
+  pOut->Tz     = pIn->Tz;
+  pOut->Ta     = pIn->Ta;
+  pOut->Tb     = pIn->Tb;
+  pOut->Tc     = pIn->Tc;
+  pOut->Td     = pIn->Td;
+  pOut->Ts     = pIn->Ts;
+  for ( i = 0; i < 3; i++ )
+  {
+    pOut->Cmp[i] = pIn->Cmp[i];
+    pOut->Inv[i] = 0;
+  }
+}
+
+/***************  END OF FILE****/
@@ -0,0 +1,83 @@
+/**
+  ******************************************************************************
+  * @file    svpwm_real.h
+  * @brief   This file contains all definitions and functions prototypes for the
+  *          reverse Park + svpwm chain instantiated in single (F32) and double
+  *          (F64) precision
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  * svpwm_real_impl.h is written once on a REAL type and included by
+  * svpwm_real.c for float and for double. The F32 engine uses sinf, cosf
+  * and atan2f and float arithmetic throughout, i.e. the rounding of a
+  * float32 firmware; the F64 engine gives the svpwm_core.h / mc_math.h
+  * results to rounding. Same conventions and normalization as
+  * svpwm_core.h (1.0 = 2/3 Vbus) and mc_math.h (reverse Park).
+  *
+  * The batch form runs the whole chain q, d, theta -> duties of U, V, W
+  * by min/max injection; in float the vector loops hold twice the lanes.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SVPWM_REAL_H
+#define __SVPWM_REAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "svpwm_core.h"
+
+#define SVPWM_REAL_TIMING( REAL ) \
+  struct                          \
+  {                               \
+    REAL    Angle;                \
+    int16_t Sector;               \
+    REAL    T1;                   \
+    REAL    T2;                   \
+    REAL    Tz;                   \
+    REAL    Ta;                   \
+    REAL    Tb;                   \
+    REAL    Tc;                   \
+    REAL    Td;                   \
+    REAL    Cmp[3];               \
+    REAL    Ts;                   \
+  }
+
+/* fields as SVPWM_Timing_t, without the modulation variants (Inv) */
+typedef SVPWM_REAL_TIMING( float )  SVPWM_Timing_F32_t;
+typedef SVPWM_REAL_TIMING( double ) SVPWM_Timing_F64_t;
+
+/* Exported functions ------------------------------------------------------- */
+
+void SVPWM_Calc_Timing_F32( float Va, float Vb, float Ts,
+                            SVPWM_Timing_F32_t * pTiming );
+void SVPWM_Calc_Timing_F64( double Va, double Vb, double Ts,
+                            SVPWM_Timing_F64_t * pTiming );
+void MCM_Rev_Park_F32( float q, float d, float theta,
+                       float * pAlpha, float * pBeta );
+void MCM_Rev_Park_F64( double q, double d, double theta,
+                       double * pAlpha, double * pBeta );
+void SVPWM_Rev_Park_Batch_F32( const float * pQ, const float * pD,
+                               const float * pTheta, float InvVnorm,
+                               uint32_t n, float * pDu, float * pDv,
+                               float * pDw );
+void SVPWM_Rev_Park_Batch_F64( const double * pQ, const double * pD,
+                               const double * pTheta, double InvVnorm,
+                               uint32_t n, double * pDu, double * pDv,
+                               double * pDw );
+void SVPWM_Timing_From_F32( const SVPWM_Timing_F32_t * pIn,
+                            SVPWM_Timing_t * pOut );
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __SVPWM_REAL_H */
+
+/* *****END OF FILE****/
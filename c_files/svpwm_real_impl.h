@@ -0,0 +1,157 @@
+/**
+  ******************************************************************************
+  * @file    svpwm_real_impl.h
+  * @brief   Reverse Park + svpwm chain of svpwm_real.c, included once per
+  *          floating point type; no include guard on purpose
+  ******************************************************************************
+  * @attention
+  *
+  * license
+  ******************************************************************************
+  *
+  * Before each inclusion define
+  *   REAL           float or double
+  *   REAL_NAME(f)   function name for this type, e.g. f##_F32
+  *   REAL_TIMING    timing struct of this type, e.g. SVPWM_Timing_F32_t
+  *   REAL_C(x)      constant of this type, e.g. x##f
+  *   REAL_SIN, REAL_COS, REAL_ATAN2, REAL_FABS   libm functions of REAL
+  * All are undefined again at the end of this file.
+  */
+
+/* inverse active vector bases and half-bridge order, see svpwm_core.c */
+#define R3    REAL_C( 0.57735026918962576451 )
+#define R3X2  REAL_C( 2.0*0.57735026918962576451 )
+static const REAL REAL_NAME( Basis )[6][2][2] =
+{
+  { {  REAL_C( 1.0 ), -R3   }, {  REAL_C( 0.0 ),  R3X2 } },   /* sector 1 */
+  { {  REAL_C( 1.0 ),  R3   }, { -REAL_C( 1.0 ),  R3   } },   /* sector 2 */
+  { {  REAL_C( 0.0 ),  R3X2 }, { -REAL_C( 1.0 ), -R3   } },   /* sector 3 */
+  { { -REAL_C( 1.0 ),  R3   }, {  REAL_C( 0.0 ), -R3X2 } },   /* sector 4 */
+  { { -REAL_C( 1.0 ), -R3   }, {  REAL_C( 1.0 ), -R3   } },   /* sector 5 */
+  { {  REAL_C( 0.0 ), -R3X2 }, {  REAL_C( 1.0 ),  R3   } }    /* sector 6 */
+};
+#undef R3
+#undef R3X2
+
+static const uint8_t REAL_NAME( Perm )[6][3] =
+{
+  { 0, 2, 3 }, { 1, 0, 3 }, { 3, 0, 2 }, { 3, 1, 0 }, { 2, 3, 0 }, { 0, 3, 1 }
+};
+
+/**
+  * @brief  SVPWM_Calc_Timing() in REAL precision
+  * @param  Va Valpha, normalized
+  * @param  Vb Vbeta, normalized
+  * @param  Ts pwm period (s)
+  * @param  pTiming result
+  */
+void REAL_NAME( SVPWM_Calc_Timing )( REAL Va, REAL Vb, REAL Ts,
+                                     REAL_TIMING * pTiming )
+{
+  REAL    angle = REAL_ATAN2( Vb, Va );
+  REAL    deg   = angle * REAL_C( 180.0 )/REAL_C( 3.14159265358979323846 );
+  int     valid = ( deg >= REAL_C( -180.0 ) ) & ( deg <= REAL_C( 180.0 ) );
+  int     n;
+  const REAL ( *B )[2];
+  const uint8_t * P;
+  REAL    t[4];
+  REAL    del1;
+  REAL    del2;
+  REAL    del3;
+
+  // sector as SVPWM_Sector_Full()
+  n = 4 + ( deg >= REAL_C( -120.0 ) ) + ( deg >= REAL_C( -60.0 ) ) +
+      ( deg > REAL_C( 60.0 ) ) + ( deg > REAL_C( 120.0 ) ) - 5 * ( deg >= REAL_C( 0.0 ) );
+  n = 1 + valid * ( n - 1 );
+  B = REAL_NAME( Basis )[n - 1];
+  P = REAL_NAME( Perm )[n - 1];
+
+  del1 = B[0][0]*Va + B[0][1]*Vb;
+  del2 = B[1][0]*Va + B[1][1]*Vb;
+  del3 = REAL_C( 1.0 ) - REAL_FABS( del1 ) - REAL_FABS( del2 );
+
+  pTiming->Angle  = angle;
+  pTiming->Sector = ( int16_t )n;
+  pTiming->Ts     = Ts;
+  pTiming->T1 = del1*Ts;
+  pTiming->T2 = del2*Ts;
+  pTiming->Tz = del3*Ts;
+  pTiming->Td = pTiming->Tz/REAL_C( 2.0 );
+  pTiming->Ta = pTiming->T1 + pTiming->T2 + pTiming->Td;
+  pTiming->Tb = pTiming->T1 + pTiming->Td;
+  pTiming->Tc = pTiming->T2 + pTiming->Td;
+
+  t[0] = pTiming->Ta;
+  t[1] = pTiming->Tb;
+  t[2] = pTiming->Tc;
+  t[3] = pTiming->Td;
+  pTiming->Cmp[0] = t[P[0]];
+  pTiming->Cmp[1] = t[P[1]];
+  pTiming->Cmp[2] = t[P[2]];
+}
+
+/**
+  * @brief  MCM_Rev_Park_Transform() in REAL precision
+  * @param  q, d voltage in the rotor frame
+  * @param  theta electrical angle (rad)
+  * @param  pAlpha, pBeta result
+  */
+void REAL_NAME( MCM_Rev_Park )( REAL q, REAL d, REAL theta,
+                                REAL * pAlpha, REAL * pBeta )
+{
+  REAL hCos = REAL_COS( theta );
+  REAL hSin = REAL_SIN( theta );
+
+  *pAlpha =  q * hCos + d * hSin;
+  *pBeta  = -q * hSin + d * hCos;
+}
+
+/**
+  * @brief  Reverse Park and min/max svpwm duties of many samples,
+  *         structure of arrays, outputs may not alias inputs
+  * @param  pQ, pD voltage in the rotor frame, n
+  * @param  pTheta electrical angle (rad), n
+  * @param  InvVnorm 1/(2/3*Vbus), volts to normalized svpwm input
+  * @param  n number of samples
+  * @param  pDu, pDv, pDw duties of U, V, W (Cmp/Ts, not clipped), n
+  */
+void REAL_NAME( SVPWM_Rev_Park_Batch )( const REAL * pQ, const REAL * pD,
+                                        const REAL * pTheta, REAL InvVnorm,
+                                        uint32_t n, REAL * pDu, REAL * pDv,
+                                        REAL * pDw )
+{
+  uint32_t i;
+
+  for ( i = 0; i < n; i++ )
+  {
+    REAL hCos = REAL_COS( pTheta[i] );
+    REAL hSin = REAL_SIN( pTheta[i] );
+    REAL va   = (  pQ[i] * hCos + pD[i] * hSin ) * InvVnorm;
+    REAL vb   = ( -pQ[i] * hSin + pD[i] * hCos ) * InvVnorm;
+    REAL u    = REAL_C( 0.66666666666666666667 ) * va;
+    REAL v    = REAL_C( -0.33333333333333333333 ) * va + REAL_C( 0.57735026918962576451 ) * vb;
+    REAL w    = REAL_C( -0.33333333333333333333 ) * va - REAL_C( 0.57735026918962576451 ) * vb;
+    REAL hi   = ( u > v ) ? u : v;
+    REAL lo   = ( u > v ) ? v : u;
+    REAL zs;
+
+    hi = ( w > hi ) ? w : hi;
+    lo = ( w < lo ) ? w : lo;
+    zs = REAL_C( 0.5 ) * ( hi + lo );
+
+    pDu[i] = REAL_C( 0.5 ) + ( u - zs );
+    pDv[i] = REAL_C( 0.5 ) + ( v - zs );
+    pDw[i] = REAL_C( 0.5 ) + ( w - zs );
+  }
+}
+
+#undef REAL
+#undef REAL_NAME
+#undef REAL_TIMING
+#undef REAL_C
+#undef REAL_SIN
+#undef REAL_COS
+#undef REAL_ATAN2
+#undef REAL_FABS
+
+/* *****END OF FILE****/
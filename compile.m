@@ -1,9 +1,9 @@
+% stage profiling of svpwm and MCM_Rev_Park: add -DSFUN_PROFILE to their mex lines
 % mex, note include directory is in Matlab c:\ProgramData\MATLAB\SupportPackages\R2022a... path
-mex .\c_files\MCM_Rev_Park.c .\c_files\circle_limitation.c -IC:\ProgramData\MATLAB\SupportPackages\R2022a\3P.instrset\mingw_w64.instrset\x86_64-w64-mingw32\include
-mex .\c_files\MCM_Park.c -IC:\ProgramData\MATLAB\SupportPackages\R2022a\3P.instrset\mingw_w64.instrset\x86_64-w64-mingw32\include
-mex .\c_files\MCM_Rev_Park.c -IC:\ProgramData\MATLAB\SupportPackages\R2022a\3P.instrset\mingw_w64.instrset\x86_64-w64-mingw32\include
-mex .\c_files\MCM_Inv_Clarke.c -IC:\ProgramData\MATLAB\SupportPackages\R2022a\3P.instrset\mingw_w64.instrset\x86_64-w64-mingw32\include
-mex .\c_files\MCM_Clarke.c -IC:\ProgramData\MATLAB\SupportPackages\R2022a\3P.instrset\mingw_w64.instrset\x86_64-w64-mingw32\include
-mex .\c_files\LuenbergerObs.c -IC:\ProgramData\MATLAB\SupportPackages\R2022a\3P.instrset\mingw_w64.instrset\x86_64-w64-mingw32\include
-mex .\c_files\svpwm.c -IC:\ProgramData\MATLAB\SupportPackages\R2022a\3P.instrset\mingw_w64.instrset\x86_64-w64-mingw32\include
-mex .\c_files\bldc_mtr.c -IC:\ProgramData\MATLAB\SupportPackages\R2022a\3P.instrset\mingw_w64.instrset\x86_64-w64-mingw32\include
\ No newline at end of file
+mex .\c_files\MCM_Rev_Park.c .\c_files\circle_limitation.c .\c_files\mc_math.c .\c_files\sfun_prof.c .\c_files\pwm_stats.c -IC:\ProgramData\MATLAB\SupportPackages\R2022a\3P.instrset\mingw_w64.instrset\x86_64-w64-mingw32\include
+mex .\c_files\MCM_Park.c .\c_files\mc_math.c -IC:\ProgramData\MATLAB\SupportPackages\R2022a\3P.instrset\mingw_w64.instrset\x86_64-w64-mingw32\include
+mex .\c_files\MCM_Inv_Clarke.c .\c_files\mc_math.c -IC:\ProgramData\MATLAB\SupportPackages\R2022a\3P.instrset\mingw_w64.instrset\x86_64-w64-mingw32\include
+mex .\c_files\MCM_Clarke.c .\c_files\mc_math.c -IC:\ProgramData\MATLAB\SupportPackages\R2022a\3P.instrset\mingw_w64.instrset\x86_64-w64-mingw32\include
+mex .\c_files\LuenbergerObs.c .\c_files\luenberger_obs.c .\c_files\mc_math.c -IC:\ProgramData\MATLAB\SupportPackages\R2022a\3P.instrset\mingw_w64.instrset\x86_64-w64-mingw32\include
+mex .\c_files\svpwm.c .\c_files\svpwm_core.c .\c_files\svpwm_real.c .\c_files\pwm_spectrum.c .\c_files\shunt_sampling.c .\c_files\pwm_timer.c .\c_files\svpwm_3l.c .\c_files\svpwm_6ph.c .\c_files\sfun_prof.c .\c_files\pwm_stats.c -IC:\ProgramData\MATLAB\SupportPackages\R2022a\3P.instrset\mingw_w64.instrset\x86_64-w64-mingw32\include
+mex .\c_files\bldc_mtr.c .\c_files\pmsm_model.c .\c_files\mc_math.c -IC:\ProgramData\MATLAB\SupportPackages\R2022a\3P.instrset\mingw_w64.instrset\x86_64-w64-mingw32\include
\ No newline at end of file
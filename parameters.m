@@ -5,4 +5,5 @@
 Ts= 50E-6;  % pwm period
 Fhz= 30.0;  % 
 Vbus = 5.0; % vols
-tau = 1/(2*pi*1000.0); % pwm filter
\ No newline at end of file
+tau = 1/(2*pi*1000.0); % pwm filter
+svpwm_opt = []; % svpwm Options, [] or [pwm_mode Ts_min Ts_max spread seed F1 NH cycles modulation sector float32 vbus shunt Trise Tsample timer Fclk ARR levels Knp phases], see c_files/svpwm.c
\ No newline at end of file